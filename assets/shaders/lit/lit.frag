@@ -6,16 +6,20 @@ layout (location = 0) in StageLayout {
     vec3 normal;
     vec2 uv;
 } stageLayout;
+layout (location = 3) flat in uint albedoIndex;
 
-//===LOCAL===//
-layout (binding = 1) uniform sampler2D u_albedo;
+//===GLOBAL===//
+// one slot per db texture, keep in sync with GFX_BINDLESS_MAX_TEXTURES.
+#define BINDLESS_MAX_TEXTURES 64
+layout (set = 1, binding = 0) uniform sampler2D u_textures[BINDLESS_MAX_TEXTURES];
 
 //===OUT===//
 layout (location = 0) out vec4 outFragColor;
 
 void main(){
     vec2 uv = stageLayout.uv;
-    vec4 outCol = vec4(texture(u_albedo, uv).rgb, 1.0f);
+    // every instance of an indirect command shares its material, the index is dynamically uniform per draw.
+    vec4 outCol = vec4(texture(u_textures[albedoIndex], uv).rgb, 1.0f);
 
     outFragColor = outCol;
 }
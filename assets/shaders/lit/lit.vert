@@ -14,10 +14,11 @@ layout (location = 0) in vec3 v_position;
 layout (location = 1) in vec3 v_normal;
 layout (location = 2) in vec2 v_uv;
 layout (location = 3) in vec3 v_color;
+//==========================================================
 
-layout (push_constant) uniform PushConstants {
-    mat4 model;
-} constants;
+//===INSTANCE===============================================
+layout (location = 4) in mat4 i_model;
+layout (location = 8) in uint i_albedoIndex;
 //==========================================================
 
 //===STAGE OUT==============================================
@@ -26,12 +27,14 @@ layout (location = 0) out StageLayout {
     vec3 normal;
     vec2 uv;
 } stageLayout;
+layout (location = 3) flat out uint albedoIndex;
 //==========================================================
 
 void main() {
-    gl_Position = ((scene.projection * scene.view) * (constants.model)) * vec4(v_position, 1.0);
+    gl_Position = ((scene.projection * scene.view) * (i_model)) * vec4(v_position, 1.0);
 
     stageLayout.color = v_color;
     stageLayout.uv = v_uv;
     stageLayout.normal = v_normal;
+    albedoIndex = i_albedoIndex;
 }
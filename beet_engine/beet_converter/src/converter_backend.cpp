@@ -3,6 +3,7 @@
 
 #include <beet_shared/assert.h>
 #include <beet_shared/log.h>
+#include <beet_shared/platform_defines.h>
 
 #include <string>
 
@@ -19,7 +20,12 @@ bool converter_init(const char *rawAssetDir, const char *targetAssetDir) {
     g_converterLocations.vulkanSDKDir = getenv("VULKAN_SDK");
 
     g_converterLocations.compressonatorCLI = std::format("{}{}", g_converterLocations.compressonatorSDKDir, "\\bin\\CLI\\compressonatorcli.exe");
+#if PLATFORM_WINDOWS
     g_converterLocations.glslValidatorCLI = std::format("{}{}", g_converterLocations.vulkanSDKDir, "\\Bin\\glslangValidator.exe");
+#else
+    // the linux sdk keeps its tools in a lower case bin without the .exe
+    g_converterLocations.glslValidatorCLI = std::format("{}{}", g_converterLocations.vulkanSDKDir, "/bin/glslangValidator");
+#endif
 
     if (g_converterLocations.rawAssetDir.empty() ||
         g_converterLocations.targetAssetDir.empty() ||
@@ -22,7 +22,11 @@ bool convert_shader_spv(const char *localAssetDir) {
 
     if (converter_cache_check_needs_convert(outPath.c_str(), inPath.c_str())) {
         log_info(MSG_CONVERTER, "shader: %s \n", outPath.c_str());
-        system(cmd.c_str());
+        // a shader that doesn't compile leaves no spv behind, fail here rather than when the pipeline is created.
+        if (system(cmd.c_str()) != 0) {
+            log_error(MSG_CONVERTER, "shader: glslangValidator failed on %s\n", inPath.c_str());
+            return false;
+        }
     }
     return true;
 }
@@ -3,11 +3,36 @@
 
 #include <cstdint>
 
+//===PUBLIC_STRUCTS=====================================================================================================
+constexpr uint32_t TIME_FRAME_HISTORY_SIZE = 512;
+constexpr uint32_t TIME_FRAME_HISTOGRAM_BUCKET_COUNT = 34;
+constexpr float TIME_FRAME_HISTOGRAM_BUCKET_MS = 1.0f; // the last bucket collects every frame past the second last one
+
+// statistics over the last TIME_FRAME_HISTORY_SIZE frames, all values in milliseconds.
+struct FrameTimeStats {
+    float minMs = {0.0f};
+    float avgMs = {0.0f};
+    float maxMs = {0.0f};
+    float p95Ms = {0.0f};
+    float p99Ms = {0.0f};
+    uint32_t sampleCount = {0};
+};
+//======================================================================================================================
+
 //===API================================================================================================================
 void time_tick();
 double time_delta();
 double time_current();
 uint32_t time_frame_count();
+
+FrameTimeStats time_frame_stats();
+// ring of frame times in ms, historyHead is the oldest sample once the ring has wrapped.
+const float *time_frame_history(uint32_t &outHistoryHead, uint32_t &outSampleCount);
+const uint32_t *time_frame_histogram();
+
+// fed by the platform time_tick, frames are recorded in milliseconds.
+void time_stats_add_frame(float frameMs);
+void time_stats_reset();
 //======================================================================================================================
 
 //===INIT_&_SHUTDOWN====================================================================================================
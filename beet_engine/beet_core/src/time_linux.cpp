@@ -3,6 +3,7 @@
 #if PLATFORM_LINUX
 
 #include <beet_core/time.h>
+#include <ctime>
 
 //===INTERNAL_STRUCTS===================================================================================================
 static struct Time {
@@ -17,6 +18,15 @@ static struct Time {
 } s_time = {};
 //======================================================================================================================
 
+//===INTERNAL_FUNCTIONS=================================================================================================
+// CLOCK_MONOTONIC_RAW is not slewed by NTP, so frame deltas are not stretched or squashed while the clock is adjusted.
+static double time_now_seconds() {
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / s_time.frequency;
+}
+//======================================================================================================================
+
 //===API================================================================================================================
 double time_delta() {
     return s_time.deltaTime;
@@ -31,17 +41,36 @@ uint32_t time_frame_count() {
 }
 
 void time_tick() {
+    s_time.frameCount += 1;
+    s_time.lastTime = s_time.currentTime;
+    s_time.currentTime = time_now_seconds();
+    s_time.deltaTime = (s_time.currentTime - s_time.lastTime) * (s_time.timeScale / 1000.0);
+
+    // the first tick spans everything between time_create and the main loop, i.e. asset loading.
+    if (s_time.frameCount > 1) {
+        time_stats_add_frame((float) ((s_time.currentTime - s_time.lastTime) * 1000.0));
+    }
 }
 //======================================================================================================================
 
 //===INIT_&_SHUTDOWN====================================================================================================
 void time_create() {
+    s_time.frequency = 1000000000.0;
+    const double now = time_now_seconds();
 
+    s_time.timeOnStartUp = now;
+    s_time.lastTime = now;
+    s_time.currentTime = now;
+    s_time.timeScaleDelta = 1.0;
+    s_time.timeScale = 1000.0;
+    s_time.frameCount = 0;
+    time_stats_reset();
 }
 
 void time_cleanup() {
     s_time = {0};
+    time_stats_reset();
 }
 //======================================================================================================================
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,76 @@
+#include <beet_core/time.h>
+
+#include <algorithm>
+
+//===INTERNAL_STRUCTS===================================================================================================
+static struct TimeStats {
+    float history[TIME_FRAME_HISTORY_SIZE] = {};
+    uint32_t historyHead = {0};
+    uint32_t sampleCount = {0};
+    double historySum = {0.0};
+    uint32_t histogram[TIME_FRAME_HISTOGRAM_BUCKET_COUNT] = {};
+} s_timeStats = {};
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static uint32_t time_stats_bucket(const float frameMs) {
+    const uint32_t bucket = (uint32_t) (frameMs / TIME_FRAME_HISTOGRAM_BUCKET_MS);
+    return bucket < TIME_FRAME_HISTOGRAM_BUCKET_COUNT ? bucket : TIME_FRAME_HISTOGRAM_BUCKET_COUNT - 1;
+}
+
+// nearest rank percentile, sortedHistory must be in ascending order.
+static float time_stats_percentile(const float *sortedHistory, const uint32_t count, const float percentile) {
+    const uint32_t rank = (uint32_t) ((percentile / 100.0f) * (float) count + 0.999f);
+    const uint32_t index = rank == 0 ? 0 : rank - 1;
+    return sortedHistory[index < count ? index : count - 1];
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void time_stats_add_frame(const float frameMs) {
+    if (s_timeStats.sampleCount == TIME_FRAME_HISTORY_SIZE) {
+        const float evicted = s_timeStats.history[s_timeStats.historyHead];
+        s_timeStats.historySum -= evicted;
+        s_timeStats.histogram[time_stats_bucket(evicted)]--;
+    } else {
+        s_timeStats.sampleCount++;
+    }
+    s_timeStats.history[s_timeStats.historyHead] = frameMs;
+    s_timeStats.historyHead = (s_timeStats.historyHead + 1) % TIME_FRAME_HISTORY_SIZE;
+    s_timeStats.historySum += frameMs;
+    s_timeStats.histogram[time_stats_bucket(frameMs)]++;
+}
+
+void time_stats_reset() {
+    s_timeStats = {};
+}
+
+FrameTimeStats time_frame_stats() {
+    FrameTimeStats stats = {};
+    const uint32_t count = s_timeStats.sampleCount;
+    if (count == 0) {
+        return stats;
+    }
+    float sorted[TIME_FRAME_HISTORY_SIZE];
+    std::copy(s_timeStats.history, s_timeStats.history + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    stats.sampleCount = count;
+    stats.minMs = sorted[0];
+    stats.maxMs = sorted[count - 1];
+    stats.avgMs = (float) (s_timeStats.historySum / (double) count);
+    stats.p95Ms = time_stats_percentile(sorted, count, 95.0f);
+    stats.p99Ms = time_stats_percentile(sorted, count, 99.0f);
+    return stats;
+}
+
+const float *time_frame_history(uint32_t &outHistoryHead, uint32_t &outSampleCount) {
+    outHistoryHead = s_timeStats.sampleCount == TIME_FRAME_HISTORY_SIZE ? s_timeStats.historyHead : 0;
+    outSampleCount = s_timeStats.sampleCount;
+    return s_timeStats.history;
+}
+
+const uint32_t *time_frame_histogram() {
+    return s_timeStats.histogram;
+}
+//======================================================================================================================
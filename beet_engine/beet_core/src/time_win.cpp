@@ -40,6 +40,11 @@ void time_tick() {
     s_time.lastTime = s_time.currentTime;
     s_time.currentTime = (double) timeNow.QuadPart / s_time.frequency;
     s_time.deltaTime = (s_time.currentTime - s_time.lastTime) * (s_time.timeScale / 1000.0);
+
+    // the first tick spans everything between time_create and the main loop, i.e. asset loading.
+    if (s_time.frameCount > 1) {
+        time_stats_add_frame((float) ((s_time.currentTime - s_time.lastTime) * 1000.0));
+    }
 }
 //======================================================================================================================
 
@@ -58,10 +63,12 @@ void time_create() {
     s_time.timeScale = 1000.0;
     s_time.frequency = (double) frequency.QuadPart;
     s_time.frameCount = 0;
+    time_stats_reset();
 }
 
 void time_cleanup() {
     s_time = {0};
+    time_stats_reset();
 }
 //======================================================================================================================
 
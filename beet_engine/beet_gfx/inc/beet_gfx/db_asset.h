@@ -6,6 +6,10 @@
 #include <beet_shared/beet_types.h>
 #include <beet_math/transform.h>
 
+// Pool slots are stable handles, removed slots are reused by the next add.
+// db_get_*_count() returns the iteration range, use db_valid_*() to skip removed slots inside it.
+// Remove entities before the materials and meshes they index, and materials before their textures,
+// db_remove_* asserts while a live slot still references the one being removed.
 void db_cleanup_pools();
 void db_dump_pool_alloc_table();
 
@@ -13,6 +17,7 @@ void db_dump_pool_alloc_table();
 #define MAX_DB_CAMERAS 1
 
 uint32_t db_add_camera(const Camera &camera);
+void db_remove_camera(uint32_t index);
 Camera *db_get_camera(uint32_t index);
 //======================================================================================================================
 
@@ -20,7 +25,9 @@ Camera *db_get_camera(uint32_t index);
 #define MAX_DB_CAMERA_ENTITIES 1
 
 uint32_t db_get_camera_entity_count();
+bool db_valid_camera_entity(uint32_t index);
 uint32_t db_add_camera_entity(const CameraEntity &camera);
+void db_remove_camera_entity(uint32_t index);
 CameraEntity *db_get_camera_entity(uint32_t index);
 //======================================================================================================================
 
@@ -28,6 +35,7 @@ CameraEntity *db_get_camera_entity(uint32_t index);
 #define MAX_DB_TRANSFORMS 256
 
 uint32_t db_add_transform(const Transform &transform);
+void db_remove_transform(uint32_t index);
 Transform *db_get_transform(uint32_t index);
 //======================================================================================================================
 
@@ -35,6 +43,7 @@ Transform *db_get_transform(uint32_t index);
 #define MAX_DB_VK_DESCRIPTOR_SETS 64
 
 uint32_t db_add_descriptor_set(const VkDescriptorSet &descriptorSet);
+void db_remove_descriptor_set(uint32_t index);
 VkDescriptorSet *db_get_descriptor_set(uint32_t index);
 //======================================================================================================================
 
@@ -42,7 +51,9 @@ VkDescriptorSet *db_get_descriptor_set(uint32_t index);
 #define MAX_DB_GFX_TEXTURES 64
 
 uint32_t db_get_texture_count();
+bool db_valid_texture(uint32_t index);
 uint32_t db_add_texture(const GfxTexture &gfxTexture);
+void db_remove_texture(uint32_t index);
 GfxTexture *db_get_texture(uint32_t index);
 //======================================================================================================================
 
@@ -50,19 +61,27 @@ GfxTexture *db_get_texture(uint32_t index);
 #define MAX_DB_GFX_MESHES 256
 
 uint32_t db_get_mesh_count();
+bool db_valid_mesh(uint32_t index);
 uint32_t db_add_mesh(const GfxMesh &gfxMesh);
+void db_remove_mesh(uint32_t index);
 GfxMesh *db_get_mesh(uint32_t index);
 //======================================================================================================================
 
 //===LIT_MATERIAL=======================================================================================================
 #define MAX_DB_LIT_MATERIALS 256
+uint32_t db_get_lit_material_count();
+bool db_valid_lit_material(uint32_t index);
 uint32_t db_add_lit_material(const LitMaterial &litMaterial);
+void db_remove_lit_material(uint32_t index);
 LitMaterial *db_get_lit_material(uint32_t index);
 //======================================================================================================================
 
 //===LIT_SKY============================================================================================================
 #define MAX_DB_SKY_MATERIALS 1
+uint32_t db_get_sky_material_count();
+bool db_valid_sky_material(uint32_t index);
 uint32_t db_add_sky_material(const SkyMaterial &skyMaterial);
+void db_remove_sky_material(uint32_t index);
 SkyMaterial *db_get_sky_material(uint32_t index);
 //======================================================================================================================
 
@@ -70,15 +89,19 @@ SkyMaterial *db_get_sky_material(uint32_t index);
 #define MAX_DB_LIT_ENTITIES 256
 
 uint32_t db_get_lit_entity_count();
+bool db_valid_lit_entity(uint32_t index);
 uint32_t db_add_lit_entity(const LitEntity &litEntity);
+void db_remove_lit_entity(uint32_t index);
 LitEntity *db_get_lit_entity(uint32_t index);
 //======================================================================================================================
 
-//===LIT_ENTITIES=======================================================================================================
+//===SKY_ENTITIES=======================================================================================================
 #define MAX_DB_SKY_ENTITIES 64
 
 uint32_t db_get_sky_entity_count();
+bool db_valid_sky_entity(uint32_t index);
 uint32_t db_add_sky_entity(const SkyEntity &skyEntity);
+void db_remove_sky_entity(uint32_t index);
 SkyEntity *db_get_sky_entity(uint32_t index);
 //======================================================================================================================
 
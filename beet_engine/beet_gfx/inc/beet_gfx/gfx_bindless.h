@@ -0,0 +1,32 @@
+#ifndef BEETROOT_GFX_BINDLESS_H
+#define BEETROOT_GFX_BINDLESS_H
+
+#include <beet_gfx/db_asset.h>
+#include <vulkan/vulkan_core.h>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// one slot per db texture, slot index == db texture index. Keep in sync with BINDLESS_MAX_TEXTURES in the shaders.
+constexpr uint32_t GFX_BINDLESS_MAX_TEXTURES = MAX_DB_GFX_TEXTURES;
+//======================================================================================================================
+
+//===API================================================================================================================
+// Every 2D texture in the db is published into a single partially bound, update after bind sampler array. Pipelines
+// add gfx_bindless_layout() as a set, bind gfx_bindless_set() once and pass the db texture index per draw.
+
+// rewrites the slots whose texture view changed since the last call, picks up newly added textures, streaming view
+// swaps and residency rebuilds. Called once per frame before recording.
+void gfx_bindless_update();
+// forces the slot to be rewritten on the next update. Needed when an image is destroyed before its replacement is
+// created, the replacement can come back with the same image and view handles.
+void gfx_bindless_invalidate(uint32_t textureIndex);
+
+VkDescriptorSetLayout gfx_bindless_layout();
+VkDescriptorSet gfx_bindless_set();
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_bindless();
+void gfx_cleanup_bindless();
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_BINDLESS_H
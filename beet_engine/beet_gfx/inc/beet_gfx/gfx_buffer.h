@@ -1,16 +1,18 @@
 #ifndef BEETROOT_GFX_BUFFER_H
 #define BEETROOT_GFX_BUFFER_H
 
+#include <beet_gfx/gfx_memory.h>
+
 #include <vulkan/vulkan_core.h>
 
 //===PUBLIC_STRUCTS=====================================================================================================
 struct GfxBuffer {
     VkBuffer buffer = VK_NULL_HANDLE;
-    VkDeviceMemory memory = VK_NULL_HANDLE;
+    GfxAllocation allocation = {};
     VkDescriptorBufferInfo descriptor = {};
     VkDeviceSize size = 0;
     VkDeviceSize alignment = 0;
-    void *mappedData = nullptr;
+    void *mappedData = nullptr; // persistently mapped by the allocator when the memory is host visible
 
     VkBufferUsageFlags usageFlags = {};
     VkMemoryPropertyFlags memoryPropertyFlags = {};
@@ -20,18 +22,24 @@ struct GfxBuffer {
 //===API================================================================================================================
 void gfx_buffer_copy_immediate(GfxBuffer &src, GfxBuffer &dst, VkQueue queue, VkBufferCopy *copyRegion);
 
+// strategy picks the allocator block kind, GfxMemoryStrategy::Linear keeps buffers that are created and released
+// together, like per frame slot copies, out of the free list blocks.
 VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags,
                            const VkMemoryPropertyFlags &memoryPropertyFlags,
                            GfxBuffer &outBuffer,
                            const VkDeviceSize size,
-                           void *inData);
+                           void *inData,
+                           GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList);
 
 VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags,
                            const VkMemoryPropertyFlags &memoryPropertyFlags,
                            const VkDeviceSize &size,
                            VkBuffer &outBuffer,
-                           VkDeviceMemory &memory,
+                           GfxAllocation &outAllocation,
                            void *inData);
+
+void gfx_buffer_cleanup(GfxBuffer &buffer);
+void gfx_buffer_cleanup(VkBuffer &buffer, GfxAllocation &allocation);
 //======================================================================================================================
 
 #endif //BEETROOT_GFX_BUFFER_H
@@ -0,0 +1,37 @@
+#ifndef BEETROOT_GFX_FRUSTUM_CULL_H
+#define BEETROOT_GFX_FRUSTUM_CULL_H
+
+#include <cstdint>
+
+#include <beet_math/vec3.h>
+#include <beet_math/vec4.h>
+#include <beet_math/mat4.h>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// world space axis aligned boxes as structure of arrays, box i is (center[i] - extent[i], center[i] + extent[i]).
+// Arrays don't need padding, the tail that doesn't fill a simd batch is tested one box at a time. Loads are unaligned but
+// arrays from mem_alloc_array with MEM_SIMD_ALIGNMENT never split a batch across cache lines.
+struct GfxCullBoundsSoA {
+    float *centerX;
+    float *centerY;
+    float *centerZ;
+    float *extentX;
+    float *extentY;
+    float *extentZ;
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// gribb hartmann planes of a view projection matrix in the order left, right, bottom, top, near, far. Planes are
+// normalised and point into the frustum.
+void gfx_frustum_planes(const mat4f &viewProj, vec4f outPlanes[6]);
+
+// encloses a mesh space box transformed by an affine model matrix in a world space box.
+void gfx_frustum_transform_aabb(const mat4f &model, const vec3f &boundsMin, const vec3f &boundsMax, vec3f &outCenter, vec3f &outExtent);
+
+// tests boxes [0, count) against the planes, 8 at a time with AVX2 when compiled in, 4 at a time with SSE otherwise.
+// Writes the indices of boxes touching the frustum to outVisible in ascending order and returns how many there are.
+uint32_t gfx_frustum_cull_aabbs(const vec4f planes[6], const GfxCullBoundsSoA &bounds, uint32_t count, uint32_t *outVisible);
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_FRUSTUM_CULL_H
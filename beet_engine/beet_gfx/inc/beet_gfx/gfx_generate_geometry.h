@@ -1,16 +1,14 @@
 #ifndef BEETROOT_GFX_GENERATE_GEOMETRY_H
 #define BEETROOT_GFX_GENERATE_GEOMETRY_H
 
-//TODO: replace C++ API a C compatible one, preferably something that takes in an allocator so it can use an arena allocator.
-
 #include <cstdint>
 #include <beet_gfx/gfx_types.h>
+#include <beet_shared/memory.h>
 
 //===API================================================================================================================
-
-std::vector<LinePoint3D> gfx_generate_geometry_cone(const vec3f &baseCenter, float radius, float height, uint32_t color, uint32_t segments);
-std::vector<LinePoint3D> gfx_generate_geometry_thick_polyline(const std::vector<vec2f> &points, float lineWidth, uint32_t color, bool closedLoop = false);
-
+// returned points are owned by the provided arena, i.e. gfx_frame_arena() for geometry rebuilt every frame.
+LinePoint3D *gfx_generate_geometry_cone(MemArena &arena, const vec3f &baseCenter, float radius, float height, uint32_t color, uint32_t segments, uint32_t &outPointCount);
+LinePoint3D *gfx_generate_geometry_thick_polyline(MemArena &arena, const vec2f *points, uint32_t pointCount, float lineWidth, uint32_t color, bool closedLoop, uint32_t &outPointCount);
 //======================================================================================================================
 
 #endif //BEETROOT_GFX_GENERATE_GEOMETRY_H
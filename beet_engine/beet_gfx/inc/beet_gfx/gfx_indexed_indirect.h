@@ -1,17 +1,61 @@
 #ifndef BEETROOT_GFX_INDEXED_INDIRECT_H
 #define BEETROOT_GFX_INDEXED_INDIRECT_H
 
+#include <cstdint>
+
 #include <vulkan/vulkan_core.h>
 
-void gfx_build_indexed_indirect_commands();
-void gfx_build_indexed_indirect_instance_data();
-void gfx_build_indexed_indirect_descriptor_set_layout();
-void gfx_build_indexed_indirect_pipelines();
+//===PUBLIC_STRUCTS=====================================================================================================
+// per instance vertex input of the lit pipeline, GfxInstanceData is streamed from this binding.
+constexpr uint32_t BEET_INSTANCE_BUFFER_BIND_ID = 1;
+
+struct GfxIndirectStats {
+    uint32_t litEntityCount; // valid lit entities tested on the cpu
+    uint32_t cpuCulledInstanceCount; // boxes fully outside the frustum, never uploaded
+    uint32_t instanceCount; // lit instances handed to the gpu culling pass
+    uint32_t visibleInstanceCount; // survivors of the frame BEET_BUFFER_COUNT frames back, read back from the gpu
+    uint32_t commandCount; // one per (mesh, material) batch
+    uint32_t drawCallCount; // indirect draw calls recorded, one per mesh
+    uint32_t redundantBindsAvoided; // pipeline, descriptor set and geometry binds a per entity loop would have recorded
+    uint32_t validatedFrameCount;
+    uint32_t validationMismatchCount; // commands whose gpu survivor count fell outside the cpu reference
+    bool directInstancing; // batches were drawn with vkCmdDrawIndexed and the gpu culling pass was skipped
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// Lit entities are radix sorted by a pipeline | mesh | material | depth key every frame and grouped into (mesh, material)
+// batches, each batch becomes one instanced VkDrawIndexedIndirectCommand. Meshes own their vertex and index buffers, so
+// the commands of one mesh are kept contiguous and drawn with a single indirect call. The cpu first drops entities whose
+// world space box is outside the camera frustum, then a compute pass tests the remaining instances' bounding spheres and
+// compacts the survivors. Devices without drawIndirectFirstInstance draw the same batches with one vkCmdDrawIndexed each.
+
+// rebuilds the culling inputs from the db, called once per frame before recording.
+void gfx_indexed_indirect_build();
+
+// records the culling dispatches, must come before any render pass that draws lit entities.
+void gfx_indexed_indirect_cull(VkCommandBuffer &cmdBuffer);
+
+// binds the instance buffer and per mesh geometry then issues the indirect draws, the caller binds pipeline and sets.
+void gfx_indexed_indirect_draw(VkCommandBuffer &cmdBuffer);
+
+// draws each batch with an instanced vkCmdDrawIndexed and skips the gpu culling pass. Always on when the device lacks
+// drawIndirectFirstInstance, disabling it then has no effect.
+void gfx_indexed_indirect_set_direct_instancing(bool enabled);
+
+// the simd box test in gfx_indexed_indirect_build, on by default. Off hands every lit entity to the gpu pass.
+void gfx_indexed_indirect_set_cpu_culling(bool enabled);
+
+// runs a scalar cpu reference next to every culling pass and compares survivor counts once each frame completes,
+// mismatches are logged and counted in GfxIndirectStats.
+void gfx_indexed_indirect_set_culling_validation(bool enabled);
 
-void gfx_indexed_indirect_render(VkCommandBuffer &cmdBuffer);
+GfxIndirectStats gfx_indexed_indirect_stats();
+//======================================================================================================================
 
-void gfx_cleanup_indexed_indirect_pipelines();
-void gfx_cleanup_indexed_indirect_descriptor_set_layout();
-void gfx_cleanup_indexed_indirect_commands();
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_indexed_indirect();
+void gfx_cleanup_indexed_indirect();
+//======================================================================================================================
 
 #endif //BEETROOT_GFX_INDEXED_INDIRECT_H
@@ -2,19 +2,35 @@
 #define BEETROOT_GFX_INTERFACE_H
 
 #include <cstdint>
+#include <beet_math/vec2.h>
+
+struct MemArena;
 
 //===API================================================================================================================
 void gfx_update(const double &deltaTime);
 
+// transient allocations that only need to live until the start of the next gfx_update
+MemArena *gfx_frame_arena();
+
+// number of frames gfx_update has completed, the frame being recorded reports this value.
+uint32_t gfx_current_frame();
 uint32_t gfx_buffer_index();
 uint32_t gfx_swap_chain_index();
 uint32_t gfx_last_swap_chain_index();
 vec2i gfx_screen_size();
 uint32_t get_multisample_count();
+
+bool gfx_is_headless();
+const char *gfx_device_name();
+// draw commands recorded in the last gfx_update, an indirect draw counts each of its commands.
+uint32_t gfx_draw_call_count();
+void gfx_add_draw_calls(uint32_t drawCount);
 //======================================================================================================================
 
 //===INIT_&_SHUTDOWN====================================================================================================
 void gfx_create(void *windowHandle);
+// renders into offscreen color targets instead of a swap chain, no surface or window is required.
+void gfx_create_headless(vec2i targetSize);
 void gfx_cleanup();
 //======================================================================================================================
 
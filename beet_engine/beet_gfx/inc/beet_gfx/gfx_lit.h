@@ -8,7 +8,7 @@ void gfx_create_lit();
 void gfx_cleanup_lit();
 bool gfx_rebuild_lit_pipeline();
 
+// lit entities are drawn from the batches built by gfx_indexed_indirect_build, model matrix and
+// LitMaterial::albedoIndex come in as per instance vertex data.
 void gfx_lit_draw(VkCommandBuffer &cmdBuffer);
-
-void gfx_lit_update_material_descriptor(VkDescriptorSet &outDescriptorSet, const GfxTexture &albedoTexture);
 #endif //BEETROOT_GFX_LIT_H
@@ -0,0 +1,80 @@
+#ifndef BEETROOT_GFX_MEMORY_H
+#define BEETROOT_GFX_MEMORY_H
+
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+constexpr VkDeviceSize GFX_MEMORY_BLOCK_SIZE = 64 * 1024 * 1024;
+constexpr uint32_t GFX_MEMORY_MAX_BLOCKS = 256;
+
+enum class GfxMemoryStrategy : uint8_t {
+    FreeList, // long lived resources, freed ranges are coalesced and reused
+    Linear, // transient resources, bump allocated and the block rewinds once everything in it has been freed
+};
+
+// buffers and linear images may not share a bufferImageGranularity page with optimal images.
+enum class GfxMemoryResource : uint8_t {
+    Linear,
+    Optimal,
+};
+
+struct GfxAllocation {
+    VkDeviceMemory memory = {VK_NULL_HANDLE};
+    VkDeviceSize offset = {0};
+    VkDeviceSize size = {0};
+    uint8_t *mapped = {nullptr}; // points at offset, only set for host visible memory
+    uint32_t blockIndex = {UINT32_MAX};
+};
+
+struct GfxMemoryStats {
+    uint32_t blockCount = {0}; // live vkAllocateMemory calls made by the allocator
+    uint32_t dedicatedBlockCount = {0};
+    uint32_t allocationCount = {0};
+    VkDeviceSize reservedBytes = {0};
+    VkDeviceSize usedBytes = {0};
+    VkDeviceSize heapReservedBytes[VK_MAX_MEMORY_HEAPS] = {};
+    VkDeviceSize heapUsedBytes[VK_MAX_MEMORY_HEAPS] = {};
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// Sub-allocates from GFX_MEMORY_BLOCK_SIZE blocks per memory type, requests larger than half a block get a block of
+// their own. Host visible blocks stay mapped for their whole lifetime.
+GfxAllocation gfx_memory_alloc(const VkMemoryRequirements &requirements,
+                               VkMemoryPropertyFlags properties,
+                               GfxMemoryResource resource,
+                               GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList,
+                               VkMemoryAllocateFlags allocateFlags = 0);
+void gfx_memory_free(GfxAllocation &allocation);
+// same as gfx_memory_alloc but returns an allocation with blockIndex UINT32_MAX instead of asserting when neither empty
+// blocks nor evictions make enough room, for callers that can retry on a later frame.
+GfxAllocation gfx_memory_try_alloc(const VkMemoryRequirements &requirements,
+                                   VkMemoryPropertyFlags properties,
+                                   GfxMemoryResource resource,
+                                   GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList,
+                                   VkMemoryAllocateFlags allocateFlags = 0);
+
+// allocate and bind in one go.
+GfxAllocation gfx_memory_alloc_buffer(VkBuffer buffer,
+                                      VkMemoryPropertyFlags properties,
+                                      GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList,
+                                      VkMemoryAllocateFlags allocateFlags = 0);
+GfxAllocation gfx_memory_alloc_image(VkImage image,
+                                     VkMemoryPropertyFlags properties,
+                                     GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList);
+// only binds on success, the image is left unbound otherwise.
+GfxAllocation gfx_memory_try_alloc_image(VkImage image,
+                                         VkMemoryPropertyFlags properties,
+                                         GfxMemoryStrategy strategy = GfxMemoryStrategy::FreeList);
+
+GfxMemoryStats gfx_memory_stats();
+void gfx_memory_dump_stats();
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_memory();
+void gfx_cleanup_memory();
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_MEMORY_H
@@ -5,9 +5,13 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <beet_gfx/gfx_upload.h>
+#include <beet_gfx/gfx_memory.h>
+
 #include <beet_math/vec2.h>
 #include <beet_math/vec3.h>
 #include <beet_math/vec4.h>
+#include <beet_math/mat4.h>
 
 #include <vector>
 
@@ -21,11 +25,13 @@ struct GfxVertex {
     vec3f color;
 };
 
+// std430 compatible, the culling pass writes these straight into the instance buffer.
 struct GfxInstanceData {
-    vec3f pos;
-    vec3f rot;
-    float scale;
-    uint32_t texIndex;
+    mat4f model;
+    uint32_t albedoIndex; // slot in the bindless texture array
+    uint32_t unused_0;
+    uint32_t unused_1;
+    uint32_t unused_2;
 };
 
 struct RawMesh {
@@ -39,11 +45,17 @@ struct RawMesh {
 struct GfxMesh {
     uint32_t vertCount;
     VkBuffer vertBuffer;
-    VkDeviceMemory vertMemory;
+    GfxAllocation vertAllocation;
 
     uint32_t indexCount;
     VkBuffer indexBuffer;
-    VkDeviceMemory indexMemory;
+    GfxAllocation indexAllocation;
+
+    // mesh space bounds, the sphere is centred on the box.
+    vec3f boundsMin;
+    vec3f boundsMax;
+    vec3f boundsCenter;
+    float boundsRadius;
 };
 //======================================================================================================================
 
@@ -53,6 +65,8 @@ void gfx_mesh_create_octahedron_immediate(GfxMesh &outMesh);
 #if IN_DEV_RUNTIME_GLTF_LOADING
 std::vector<GfxMesh> gfx_mesh_load_gltf();
 #endif //IN_DEV_RUNTIME_GLTF_LOADING
+// rawMesh can be released as soon as this returns, the mesh must not be drawn until the handle completes.
+GfxUploadHandle gfx_mesh_create(const RawMesh &rawMesh, GfxMesh &outMesh);
 void gfx_mesh_create_immediate(const RawMesh &rawMesh, GfxMesh &outMesh);
 void gfx_mesh_cleanup(GfxMesh &mesh);
 //======================================================================================================================
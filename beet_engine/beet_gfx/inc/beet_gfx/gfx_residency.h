@@ -0,0 +1,50 @@
+#ifndef BEETROOT_GFX_RESIDENCY_H
+#define BEETROOT_GFX_RESIDENCY_H
+
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// fractions of the device local budget, the gap between them keeps a texture from being evicted and restored on
+// alternating frames.
+constexpr float GFX_RESIDENCY_EVICT_THRESHOLD = 0.9f;
+constexpr float GFX_RESIDENCY_RESTORE_THRESHOLD = 0.75f;
+// each eviction reloads mips from disk and waits on the upload, restores reload without waiting. Keep the per frame
+// hitch bounded.
+constexpr uint32_t GFX_RESIDENCY_MAX_EVICTIONS_PER_FRAME = 4;
+constexpr uint32_t GFX_RESIDENCY_MAX_RESTORES_PER_FRAME = 1;
+
+struct GfxResidencyStats {
+    VkDeviceSize budgetBytes = {0}; // device local memory the process can use without the driver paging
+    VkDeviceSize usageBytes = {0}; // device local memory in use, free space inside allocator blocks doesn't count
+    VkDeviceSize textureBytes = {0};
+    uint32_t evictedTextureCount = {0};
+    uint32_t evictionCount = {0}; // running totals since gfx_create_residency
+    uint32_t restoreCount = {0};
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// marks a db texture as sampled by the frame being recorded.
+void gfx_residency_touch(uint32_t textureIndex);
+
+// called once per frame before recording. Over GFX_RESIDENCY_EVICT_THRESHOLD the top mip of the least recently used
+// textures is evicted, under GFX_RESIDENCY_RESTORE_THRESHOLD evicted textures sampled last frame get their full mip
+// chain back.
+void gfx_residency_update();
+
+// evicts a mip from the least recently used texture that still has one to give, returns false when nothing is left.
+// gfx_memory calls this when the driver refuses an allocation.
+bool gfx_residency_evict_lru();
+
+// 0 uses the budget reported by the device, anything else pretends the device only has that much memory.
+void gfx_residency_set_budget_override(VkDeviceSize budgetBytes);
+GfxResidencyStats gfx_residency_stats();
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_residency();
+void gfx_cleanup_residency();
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_RESIDENCY_H
@@ -3,10 +3,41 @@
 
 #include <vulkan/vulkan_core.h>
 #include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_upload.h>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// mips at or below this size in both dimensions are uploaded up front when a streaming texture is created.
+constexpr uint32_t GFX_TEXTURE_STREAM_TAIL_SIZE = 128;
+constexpr VkDeviceSize GFX_TEXTURE_STREAM_DEFAULT_FRAME_BUDGET = 8 * 1024 * 1024;
+//======================================================================================================================
 
 //===API================================================================================================================
+// the texture must not be sampled until the returned handle completes.
+GfxUploadHandle gfx_texture_create_dds(const char *path, GfxTexture &inOutTexture);
 void gfx_texture_create_immediate_dds(const char *path, GfxTexture &inOutTexture);
+
+// uploads only the mip tail so the texture is sampleable straight away, the remaining mips are streamed in by
+// gfx_texture_streaming_update once the texture has been added to the db. Until then the view's base mip is clamped
+// to the highest resident mip and materials sampling the texture are rebound as each step's upload completes.
+void gfx_texture_create_streaming_dds(const char *path, GfxTexture &inOutTexture);
+void gfx_texture_streaming_update();
+void gfx_texture_streaming_set_frame_budget(VkDeviceSize budgetBytes);
+uint32_t gfx_texture_streaming_pending_count();
+
+// rebuilds the texture from its dds without the source mips above newTopMip, the memory they held is released. Only
+// valid between frames, materials sampling the texture are rebound.
+void gfx_texture_evict_mips(uint32_t textureIndex, uint32_t newTopMip);
+// recreates the full mip chain without waiting on the upload. The evicted image stays in the db slot until the new
+// one's tail is resident, then the evicted mips stream back in like a freshly loaded streaming texture. Returns false
+// and leaves the texture evicted when there is no device memory for the full chain.
+bool gfx_texture_restore_mips(uint32_t textureIndex);
+bool gfx_texture_restore_pending(uint32_t textureIndex);
+
 void gfx_texture_cleanup(GfxTexture &gfxTexture);
 //======================================================================================================================
 
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_cleanup_texture_streaming();
+//======================================================================================================================
+
 #endif //BEETROOT_GFX_TEXTURE_H
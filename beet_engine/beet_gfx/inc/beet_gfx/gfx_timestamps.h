@@ -0,0 +1,50 @@
+#ifndef BEETROOT_GFX_TIMESTAMPS_H
+#define BEETROOT_GFX_TIMESTAMPS_H
+
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+enum GFX_GPU_PASS : uint32_t {
+    GFX_GPU_PASS_FRAME = 0,
+    GFX_GPU_PASS_RESOLVE_DEPTH = 1,
+    GFX_GPU_PASS_SKY = 2,
+    GFX_GPU_PASS_LIT = 3,
+    GFX_GPU_PASS_TRIANGLE_STRIP = 4,
+    GFX_GPU_PASS_LINE = 5,
+    GFX_GPU_PASS_IMGUI = 6,
+    GFX_GPU_PASS_RESOLVE_COLOR = 7,
+    GFX_GPU_PASS_CULL = 8,
+    GFX_GPU_PASS_COUNT,
+};
+
+constexpr uint32_t GFX_GPU_TIMING_HISTORY_SIZE = 64;
+
+struct GfxGpuPassTiming {
+    float lastMs = {0.0f};
+    float averageMs = {0.0f}; // rolling average over the last GFX_GPU_TIMING_HISTORY_SIZE samples
+    float maxMs = {0.0f};
+    uint32_t sampleCount = {0};
+    float history[GFX_GPU_TIMING_HISTORY_SIZE] = {};
+    uint32_t historyHead = {0}; // index of the next history slot to be written
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// Each frame in flight owns a query pool, results are read back without waiting the next time that pool comes around.
+// Samples that are not yet available are skipped rather than stalling on the gpu.
+void gfx_timestamps_begin_frame(VkCommandBuffer &cmdBuffer);
+void gfx_timestamps_write_begin(VkCommandBuffer &cmdBuffer, GFX_GPU_PASS pass);
+void gfx_timestamps_write_end(VkCommandBuffer &cmdBuffer, GFX_GPU_PASS pass);
+
+bool gfx_timestamps_supported();
+const GfxGpuPassTiming &gfx_timestamps_get_pass_timing(GFX_GPU_PASS pass);
+const char *gfx_timestamps_pass_name(GFX_GPU_PASS pass);
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_timestamps();
+void gfx_cleanup_timestamps();
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_TIMESTAMPS_H
@@ -35,6 +35,7 @@ struct LinePoint3D {
 struct SwapChainBuffers {
     VkImage image;
     VkImageView view;
+    VkDeviceMemory deviceMemory; // only set for headless offscreen targets, swap chain images are owned by the swap chain
 };
 
 struct DepthImage {
@@ -88,6 +89,7 @@ struct VulkanBackend {
     VkPhysicalDevice physicalDevice = {VK_NULL_HANDLE};
     VkDevice device = {VK_NULL_HANDLE};
     VkQueue queue = {VK_NULL_HANDLE};
+    VkQueue queueTransfer = {VK_NULL_HANDLE}; // aliases queue on devices without a dedicated transfer family
 
     VkCommandPool graphicsCommandPool = {VK_NULL_HANDLE};
     VkCommandBuffer graphicsCommandBuffers[BEET_BUFFER_COUNT] = {VK_NULL_HANDLE};
@@ -103,6 +105,9 @@ struct VulkanBackend {
     uint32_t validationLayersCount = {};
 
     VkFence graphicsFenceWait[BEET_SWAP_CHAIN_IMAGE_MAX] = {VK_NULL_HANDLE};
+    // signalled once everything submitted for a gfx_buffer_index() slot has completed, per frame resources of the slot
+    // are only rewritten after gfx_update has waited on it.
+    VkFence frameFences[BEET_BUFFER_COUNT] = {VK_NULL_HANDLE};
     Semaphores semaphores[BEET_SWAP_CHAIN_IMAGE_MAX] = {VK_NULL_HANDLE};
     VulkanSwapChain swapChain = {};
 
@@ -112,18 +117,16 @@ struct VulkanBackend {
     VkPhysicalDeviceProperties deviceProperties = {};
     VkPhysicalDeviceFeatures deviceFeatures = {};
     VkPhysicalDeviceMemoryProperties deviceMemoryProperties = {};
-
-
-    uint32_t objectCount = 0;
+    bool memoryBudgetSupported = {false}; // VK_EXT_memory_budget
+    bool drawIndirectCountSupported = {false}; // vkCmdDrawIndexedIndirectCount, culled draws are compacted on the gpu
 
     //===INDIRECT===================
-    //REPLACE WITH POOL
-    std::vector<VkDrawIndexedIndirectCommand> indirectCommands;
-    // Contains the indirect drawing commands
-    GfxBuffer indirectCommandsBuffer;
+    // lit batches, rebuilt every frame by gfx_indexed_indirect_build into the gfx_buffer_index() slot.
+    GfxBuffer indirectCommandsBuffers[BEET_BUFFER_COUNT];
+    GfxBuffer indirectCountBuffers[BEET_BUFFER_COUNT]; // surviving commands per mesh, written by the culling pass
     uint32_t indirectDrawCount{0};
 
-    GfxBuffer instanceBuffer;
+    GfxBuffer instanceBuffers[BEET_BUFFER_COUNT];
     //==============================
 
     //===UNIFORM BUFFER=============
@@ -144,11 +147,18 @@ struct VulkanBackend {
 // this way we can have a single descriptor/image allocation to a large amount of textures
 struct GfxTexture {
     VkImage image;
-    VkDeviceMemory deviceMemory;
+    GfxAllocation allocation;
     VkImageView view;
     VkImageLayout layout;
     uint32_t imageSamplerType;
     VkDescriptorImageInfo descriptor;
+    VkImageViewType viewType;
+    uint32_t layerCount;
+    uint32_t mipCount;
+    uint32_t residentBaseMip; // highest detail mip covered by view, non zero while the texture is still streaming in
+    uint32_t imageBaseMip; // source mip held in image mip 0, non zero while the residency manager has the top mips evicted
+    uint32_t tailBaseMip; // source mip the streaming tail starts at, eviction never goes past it
+    char sourcePath[MAX_PATH]; // dds the mips are reloaded from
 #if BEET_DEBUG
     char debug_name[MAX_PATH];
     TextureFormat debug_textureFormat;
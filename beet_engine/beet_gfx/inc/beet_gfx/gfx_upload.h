@@ -0,0 +1,75 @@
+#ifndef BEETROOT_GFX_UPLOAD_H
+#define BEETROOT_GFX_UPLOAD_H
+
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// timeline value the batch holding the upload signals on completion, uploads recorded into the same batch share a handle.
+typedef uint64_t GfxUploadHandle;
+constexpr GfxUploadHandle GFX_UPLOAD_INVALID_HANDLE = 0;
+
+constexpr uint32_t GFX_UPLOAD_BATCHES_IN_FLIGHT = 4;
+constexpr uint32_t GFX_UPLOAD_MAX_BARRIERS_PER_BATCH = 128;
+constexpr VkDeviceSize GFX_UPLOAD_STAGING_RING_DEFAULT_SIZE = 64 * 1024 * 1024;
+// satisfies vkCmdCopyBufferToImage for every block compressed format we load (BC2-BC7 are 16 byte blocks).
+constexpr VkDeviceSize GFX_UPLOAD_STAGING_ALIGNMENT = 16;
+
+// a subresource range too large for one staging reservation is written by several gfx_upload_image calls, the first
+// one starts the range and the last one hands it over to the graphics queue.
+enum GFX_UPLOAD_IMAGE_FLAGS : uint8_t {
+    GFX_UPLOAD_IMAGE_BEGIN = 1u << 0u, // transitions the range from UNDEFINED, discarding what it held
+    GFX_UPLOAD_IMAGE_END = 1u << 1u,   // releases the range in SHADER_READ_ONLY_OPTIMAL to the graphics queue family
+    GFX_UPLOAD_IMAGE_WHOLE = GFX_UPLOAD_IMAGE_BEGIN | GFX_UPLOAD_IMAGE_END,
+};
+
+struct GfxUploadStaging {
+    uint8_t *mapped = {nullptr};
+    VkDeviceSize offset = {0}; // offset of the reservation in the staging ring
+    VkDeviceSize size = {0};
+    GfxUploadHandle handle = {GFX_UPLOAD_INVALID_HANDLE}; // batch the reservation was made for
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// Copies are recorded on the transfer queue and batched until gfx_upload_flush, which submits the batch and signals its
+// handle on a timeline semaphore. Completed batches hand ownership back to the graphics queue family in
+// gfx_upload_update, only then does gfx_upload_is_complete report true and is the resource safe to draw with.
+
+// Staging comes from a single persistently mapped ring, space is reclaimed as the batch that used it retires.
+
+// data is copied into staging straight away, the caller is free to release it once this returns. Uploads larger than
+// gfx_upload_max_staging_size are split into chunks, the returned handle covers the last one and so all of them.
+GfxUploadHandle gfx_upload_buffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *data, VkDeviceSize size);
+
+// reserves staging in the open batch for the caller to fill, pair it with the gfx_upload_image call that consumes it
+// before making any other gfx_upload call. size must not exceed gfx_upload_max_staging_size.
+GfxUploadStaging gfx_upload_reserve_staging(VkDeviceSize size);
+VkDeviceSize gfx_upload_max_staging_size();
+// region buffer offsets are relative to the staging reservation and are rebased in place. With GFX_UPLOAD_IMAGE_WHOLE
+// the subresource range is transitioned from UNDEFINED and ends up in SHADER_READ_ONLY_OPTIMAL on the graphics queue
+// family. Calls between a BEGIN and an END leave it in TRANSFER_DST_OPTIMAL, their regions must not overlap.
+GfxUploadHandle gfx_upload_image(VkImage dstImage,
+                                 const VkImageSubresourceRange &subresourceRange,
+                                 const GfxUploadStaging &staging,
+                                 VkBufferImageCopy *regions,
+                                 uint32_t regionCount,
+                                 uint8_t flags);
+
+void gfx_upload_flush();
+bool gfx_upload_is_complete(GfxUploadHandle handle);
+void gfx_upload_wait(GfxUploadHandle handle);
+
+// called once per frame before recording, retires completed batches without blocking on outstanding ones.
+void gfx_upload_update();
+
+// waits for every outstanding upload before reallocating the ring.
+void gfx_upload_set_staging_ring_size(VkDeviceSize size);
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_upload();
+void gfx_cleanup_upload();
+//======================================================================================================================
+
+#endif //BEETROOT_GFX_UPLOAD_H
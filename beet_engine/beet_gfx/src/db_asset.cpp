@@ -2,15 +2,11 @@
 #include <beet_shared/beet_types.h>
 #include <beet_shared/assert.h>
 #include <beet_shared/memory.h>
+#include <beet_shared/log.h>
 
 constexpr uint8_t MAX_ALLOCATION_TABLE_SIZE = UINT8_MAX;
 constexpr uint8_t MAX_ALLOCATION_NAME = 64;
 
-struct PoolInfo{
-    void* start;
-    uint32_t currentIndex;
-};
-
 struct AllocInfo{
     size_t itemSize;
     size_t itemCount;
@@ -19,7 +15,7 @@ struct AllocInfo{
 
 struct AllocEntry{
     AllocInfo allocInfo;
-    PoolInfo* poolInfo;
+    MemPool pool;
 };
 
 static AllocEntry s_allocationTable[MAX_ALLOCATION_TABLE_SIZE] = {};
@@ -27,269 +23,320 @@ static size_t s_allocationTableCount = {0};
 
 void db_cleanup_pools(){
     for (uint8_t i = 0; i < s_allocationTableCount; ++i) {
-        free(s_allocationTable[i].poolInfo);
+        if (s_allocationTable[i].pool.start != nullptr) {
+            mem_pool_cleanup(s_allocationTable[i].pool);
+        }
     }
 }
 
 void db_dump_pool_alloc_table(){
     size_t totalPoolsSize = {};
     size_t usedPoolsSize = {};
+    log_info(MSG_DB, "===DB_POOL_DUMP=========\n");
     for (uint8_t i = 0; i < s_allocationTableCount; ++i) {
         AllocEntry& entry = s_allocationTable[i];
-        printf("=================================\n");
-        printf("Name: %s\n", entry.allocInfo.poolName);
         size_t poolSize = entry.allocInfo.itemSize * entry.allocInfo.itemCount;
-        size_t usedSize = entry.allocInfo.itemSize * entry.poolInfo->currentIndex;
+        size_t usedSize = entry.allocInfo.itemSize * entry.pool.usedCount;
+        size_t peakSize = entry.allocInfo.itemSize * entry.pool.highWatermark;
         totalPoolsSize += poolSize;
         usedPoolsSize += usedSize;
-
-        printf("Pool size: %zu Bytes\n", poolSize);
-        printf("Used space: %zu Bytes\n", usedSize);
-        printf("=================================\n");
+        log_info(MSG_DB, "%s: size [%zu] Bytes, used [%zu] Bytes, peak [%zu] Bytes\n", entry.allocInfo.poolName, poolSize, usedSize, peakSize);
     }
-    printf("=================================\n");
-    printf("Total Pool size: %zu Bytes\n", totalPoolsSize);
-    printf("Used Pool size: %zu Bytes\n", usedPoolsSize);
-    printf("=================================\n");
+    log_info(MSG_DB, "Total Pool size: [%zu] Bytes\n", totalPoolsSize);
+    log_info(MSG_DB, "Used Pool size : [%zu] Bytes\n", usedPoolsSize);
+    log_info(MSG_DB, "========================\n");
 }
 
-PoolInfo* db_pool_alloc(const AllocInfo& info) {
-    const size_t poolAllocSize = info.itemCount * info.itemSize;
-    const size_t totalAllocation = poolAllocSize + sizeof(PoolInfo);
-    PoolInfo* poolInfo = (PoolInfo*)memset(malloc(totalAllocation), 0, totalAllocation);
-    ASSERT_MSG(poolInfo, "Err failed to allocate pool %s", info.poolName);
-
-    poolInfo->start = (char*) poolInfo + sizeof(PoolInfo);
-    poolInfo->currentIndex = 0;
-
+MemPool& db_pool_alloc(const AllocInfo& info) {
+    ASSERT_MSG(s_allocationTableCount < MAX_ALLOCATION_TABLE_SIZE, "Err: too many pools, failed to allocate %s", info.poolName);
     AllocEntry& entry = s_allocationTable[s_allocationTableCount];
     s_allocationTableCount++;
     entry.allocInfo = info;
-    entry.poolInfo = poolInfo;
+    mem_pool_create(entry.pool, info.itemSize, (uint32_t)info.itemCount, MSG_DB);
+    return entry.pool;
+}
 
-    return poolInfo;
+template<typename T>
+static uint32_t db_pool_add(MemPool& pool, const T& item) {
+    const uint32_t index = mem_pool_alloc_index(pool);
+    *(T*) mem_pool_get(pool, index) = item;
+    return index;
 }
 
-//===CAMERA=============================================================================================================
-static struct CameraPool{
-    Camera* start;
-    uint32_t count;
-}& s_dbCameras = *(CameraPool*) db_pool_alloc({sizeof(Camera), MAX_DB_CAMERAS, "Pool Camera"});
+template<typename T>
+static T* db_pool_get(const MemPool& pool, uint32_t index) {
+    ASSERT_MSG(mem_pool_is_alive(pool, index), "Err: pool slot [%u] is not in use", index);
+    return (T*) mem_pool_get(pool, index);
+}
 
+// removed slots are reused by the next add, so a slot may only be removed once nothing indexes it anymore.
+// these walk the dependent pools and only run when a slot is removed.
+static bool db_mesh_is_referenced(uint32_t meshIndex) {
+    for (uint32_t i = 0; i < db_get_lit_entity_count(); ++i) {
+        if (db_valid_lit_entity(i) && db_get_lit_entity(i)->meshIndex == meshIndex) {
+            return true;
+        }
+    }
+    for (uint32_t i = 0; i < db_get_sky_entity_count(); ++i) {
+        if (db_valid_sky_entity(i) && db_get_sky_entity(i)->meshIndex == meshIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool db_texture_is_referenced(uint32_t textureIndex) {
+    for (uint32_t i = 0; i < db_get_lit_material_count(); ++i) {
+        if (db_valid_lit_material(i) && db_get_lit_material(i)->albedoIndex == textureIndex) {
+            return true;
+        }
+    }
+    for (uint32_t i = 0; i < db_get_sky_material_count(); ++i) {
+        if (db_valid_sky_material(i) && db_get_sky_material(i)->octahedralMapIndex == textureIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool db_lit_material_is_referenced(uint32_t materialIndex) {
+    for (uint32_t i = 0; i < db_get_lit_entity_count(); ++i) {
+        if (db_valid_lit_entity(i) && db_get_lit_entity(i)->materialIndex == materialIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool db_sky_material_is_referenced(uint32_t materialIndex) {
+    for (uint32_t i = 0; i < db_get_sky_entity_count(); ++i) {
+        if (db_valid_sky_entity(i) && db_get_sky_entity(i)->materialIndex == materialIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//===CAMERA=============================================================================================================
+static MemPool& s_dbCameras = db_pool_alloc({sizeof(Camera), MAX_DB_CAMERAS, "Pool Camera"});
 
 uint32_t db_add_camera(const Camera &camera) {
-    ASSERT(s_dbCameras.count < MAX_DB_CAMERAS);
-    uint32_t currentCameraIndex = s_dbCameras.count;
-    s_dbCameras.start[currentCameraIndex] = camera;
-    s_dbCameras.count++;
-    return currentCameraIndex;
+    return db_pool_add(s_dbCameras, camera);
+}
+
+void db_remove_camera(uint32_t index) {
+    mem_pool_free_index(s_dbCameras, index);
 }
 
 Camera *db_get_camera(uint32_t index) {
-    ASSERT(index < MAX_DB_CAMERAS);
-    return &s_dbCameras.start[index];
+    return db_pool_get<Camera>(s_dbCameras, index);
 }
 //======================================================================================================================
 
 //===CAMERA_ENTITIES====================================================================================================
-static struct CameraEntityPool{
-    CameraEntity* start;
-    uint32_t count;
-}& s_dbCameraEntities = *(CameraEntityPool*) db_pool_alloc({sizeof(CameraEntity), MAX_DB_CAMERA_ENTITIES, "Pool Camera Entity"});
+static MemPool& s_dbCameraEntities = db_pool_alloc({sizeof(CameraEntity), MAX_DB_CAMERA_ENTITIES, "Pool Camera Entity"});
 
 uint32_t db_get_camera_entity_count() {
-    return s_dbCameraEntities.count;
+    return s_dbCameraEntities.highWatermark;
+}
+
+bool db_valid_camera_entity(uint32_t index) {
+    return mem_pool_is_alive(s_dbCameraEntities, index);
 }
 
 uint32_t db_add_camera_entity(const CameraEntity &camera) {
-    ASSERT(s_dbCameraEntities.count < MAX_DB_CAMERA_ENTITIES);
-    uint32_t currentCameraEntityIndex = s_dbCameraEntities.count;
-    s_dbCameraEntities.start[currentCameraEntityIndex] = camera;
-    s_dbCameraEntities.count++;
-    return currentCameraEntityIndex;
+    return db_pool_add(s_dbCameraEntities, camera);
+}
+
+void db_remove_camera_entity(uint32_t index) {
+    mem_pool_free_index(s_dbCameraEntities, index);
 }
 
 CameraEntity *db_get_camera_entity(uint32_t index) {
-    ASSERT(index < MAX_DB_CAMERA_ENTITIES);
-    return &s_dbCameraEntities.start[index];
+    return db_pool_get<CameraEntity>(s_dbCameraEntities, index);
 }
 //======================================================================================================================
 
 //===TRANSFORM==========================================================================================================
-static struct TransformPool{
-    Transform* start;
-    uint32_t count;
-}& s_dbTransforms = *(TransformPool*) db_pool_alloc({sizeof(Transform), MAX_DB_TRANSFORMS, "Pool Transforms"});
+static MemPool& s_dbTransforms = db_pool_alloc({sizeof(Transform), MAX_DB_TRANSFORMS, "Pool Transforms"});
 
 uint32_t db_add_transform(const Transform &transform) {
-    ASSERT(s_dbTransforms.count < MAX_DB_TRANSFORMS);
-    uint32_t currentTransformIndex = s_dbTransforms.count;
-    s_dbTransforms.start[currentTransformIndex] = transform;
-    s_dbTransforms.count++;
-    return currentTransformIndex;
+    return db_pool_add(s_dbTransforms, transform);
+}
+
+void db_remove_transform(uint32_t index) {
+    mem_pool_free_index(s_dbTransforms, index);
 }
 
 Transform *db_get_transform(uint32_t index) {
-    ASSERT(index < MAX_DB_TRANSFORMS);
-    return &s_dbTransforms.start[index];
+    return db_pool_get<Transform>(s_dbTransforms, index);
 }
 //======================================================================================================================
 
 //===DESCRIPTOR=========================================================================================================
-static struct VkDescriptorSetPool{
-    VkDescriptorSet* start;
-    uint32_t count;
-}& s_dbDescriptorSet = *(VkDescriptorSetPool*) db_pool_alloc({sizeof(VkDescriptorSet), MAX_DB_VK_DESCRIPTOR_SETS, "Pool Vk Descriptor sets"});
+static MemPool& s_dbDescriptorSets = db_pool_alloc({sizeof(VkDescriptorSet), MAX_DB_VK_DESCRIPTOR_SETS, "Pool Vk Descriptor sets"});
 
 uint32_t db_add_descriptor_set(const VkDescriptorSet &descriptorSet) {
-    ASSERT(s_dbDescriptorSet.count < MAX_DB_VK_DESCRIPTOR_SETS);
-    uint32_t currentDescriptorSetIndex = s_dbDescriptorSet.count;
-    s_dbDescriptorSet.start[currentDescriptorSetIndex] = descriptorSet;
-    s_dbDescriptorSet.count++;
-    return currentDescriptorSetIndex;
+    return db_pool_add(s_dbDescriptorSets, descriptorSet);
+}
+
+void db_remove_descriptor_set(uint32_t index) {
+    mem_pool_free_index(s_dbDescriptorSets, index);
 }
 
 VkDescriptorSet *db_get_descriptor_set(uint32_t index) {
-    ASSERT(index < MAX_DB_VK_DESCRIPTOR_SETS);
-    return &s_dbDescriptorSet.start[index];
+    return db_pool_get<VkDescriptorSet>(s_dbDescriptorSets, index);
 }
 //======================================================================================================================
 
 //===TEXTURE============================================================================================================
-static struct GfxTexturePool{
-    GfxTexture* start;
-    uint32_t count;
-}& s_dbTextures = *(GfxTexturePool*) db_pool_alloc({sizeof(GfxTexture), MAX_DB_GFX_TEXTURES, "Pool Gfx Texture"});
+static MemPool& s_dbTextures = db_pool_alloc({sizeof(GfxTexture), MAX_DB_GFX_TEXTURES, "Pool Gfx Texture"});
 
 uint32_t db_get_texture_count() {
-    return s_dbTextures.count;
+    return s_dbTextures.highWatermark;
+}
+
+bool db_valid_texture(uint32_t index) {
+    return mem_pool_is_alive(s_dbTextures, index);
 }
 
 uint32_t db_add_texture(const GfxTexture &gfxTexture) {
-    ASSERT(s_dbTextures.count < MAX_DB_GFX_TEXTURES);
-    uint32_t currentGfxTextureIndex = s_dbTextures.count;
-    s_dbTextures.start[currentGfxTextureIndex] = gfxTexture;
-    s_dbTextures.count++;
-    return currentGfxTextureIndex;
+    return db_pool_add(s_dbTextures, gfxTexture);
+}
+
+void db_remove_texture(uint32_t index) {
+    ASSERT_MSG(!db_texture_is_referenced(index), "Err: texture [%u] is still used by a material, remove the material first", index);
+    mem_pool_free_index(s_dbTextures, index);
 }
 
 GfxTexture *db_get_texture(uint32_t index) {
-    ASSERT(index < MAX_DB_GFX_TEXTURES);
-    return &s_dbTextures.start[index];
+    return db_pool_get<GfxTexture>(s_dbTextures, index);
 }
 //======================================================================================================================
 
 //===MESH===============================================================================================================
-static struct GfxMeshPool{
-    GfxMesh* start;
-    uint32_t count;
-}& s_dbMeshes = *(GfxMeshPool*) db_pool_alloc({sizeof(GfxMesh), MAX_DB_GFX_MESHES, "Pool Gfx Mesh"});
+static MemPool& s_dbMeshes = db_pool_alloc({sizeof(GfxMesh), MAX_DB_GFX_MESHES, "Pool Gfx Mesh"});
 
 uint32_t db_get_mesh_count() {
-    return s_dbMeshes.count;
+    return s_dbMeshes.highWatermark;
+}
+
+bool db_valid_mesh(uint32_t index) {
+    return mem_pool_is_alive(s_dbMeshes, index);
 }
 
 uint32_t db_add_mesh(const GfxMesh &gfxMesh) {
-    ASSERT(s_dbMeshes.count < MAX_DB_GFX_MESHES);
-    uint32_t currentGfxTextureIndex = s_dbMeshes.count;
-    s_dbMeshes.start[currentGfxTextureIndex] = gfxMesh;
-    s_dbMeshes.count++;
-    return currentGfxTextureIndex;
+    return db_pool_add(s_dbMeshes, gfxMesh);
+}
+
+void db_remove_mesh(uint32_t index) {
+    ASSERT_MSG(!db_mesh_is_referenced(index), "Err: mesh [%u] is still used by an entity, remove the entity first", index);
+    mem_pool_free_index(s_dbMeshes, index);
 }
 
 GfxMesh *db_get_mesh(uint32_t index) {
-    ASSERT(index < MAX_DB_GFX_MESHES);
-    return &s_dbMeshes.start[index];
+    return db_pool_get<GfxMesh>(s_dbMeshes, index);
 }
 //======================================================================================================================
 
 //===LIT_MATERIAL=======================================================================================================
-static struct LitMaterialPool{
-    LitMaterial* start;
-    uint32_t count;
-}& s_dbLitMaterials = *(LitMaterialPool*) db_pool_alloc({sizeof(LitMaterial), MAX_DB_LIT_MATERIALS, "Pool Lit Material"});
+static MemPool& s_dbLitMaterials = db_pool_alloc({sizeof(LitMaterial), MAX_DB_LIT_MATERIALS, "Pool Lit Material"});
+
+uint32_t db_get_lit_material_count() {
+    return s_dbLitMaterials.highWatermark;
+}
+
+bool db_valid_lit_material(uint32_t index) {
+    return mem_pool_is_alive(s_dbLitMaterials, index);
+}
 
 uint32_t db_add_lit_material(const LitMaterial &litMaterial) {
-    ASSERT(s_dbLitMaterials.count < MAX_DB_LIT_MATERIALS);
-    uint32_t currentLitMaterialsIndex = s_dbLitMaterials.count;
-    s_dbLitMaterials.start[currentLitMaterialsIndex] = litMaterial;
-    s_dbLitMaterials.count++;
-    return currentLitMaterialsIndex;
+    // lit.frag samples albedo from the bindless sampler2D array, which only ever receives 2D views.
+    ASSERT_MSG(db_valid_texture(litMaterial.albedoIndex), "Err: lit material albedo [%u] is not a loaded texture", litMaterial.albedoIndex);
+    ASSERT_MSG(db_get_texture(litMaterial.albedoIndex)->viewType == VK_IMAGE_VIEW_TYPE_2D,
+               "Err: lit material albedo [%u] must be a 2D texture, array and cube textures aren't in the bindless array", litMaterial.albedoIndex);
+    return db_pool_add(s_dbLitMaterials, litMaterial);
+}
+
+void db_remove_lit_material(uint32_t index) {
+    ASSERT_MSG(!db_lit_material_is_referenced(index), "Err: lit material [%u] is still used by an entity, remove the entity first", index);
+    mem_pool_free_index(s_dbLitMaterials, index);
 }
 
 LitMaterial *db_get_lit_material(uint32_t index) {
-    ASSERT(index < MAX_DB_LIT_MATERIALS);
-    return &s_dbLitMaterials.start[index];
+    return db_pool_get<LitMaterial>(s_dbLitMaterials, index);
 }
 //======================================================================================================================
 
 //===SKY_MATERIAL=======================================================================================================
-static struct SkyMaterialPool{
-    SkyMaterial* start;
-    uint32_t count;
-}& s_dbSkyMaterials = *(SkyMaterialPool*) db_pool_alloc({sizeof(SkyMaterial), MAX_DB_SKY_MATERIALS, "Pool Sky Material"});
+static MemPool& s_dbSkyMaterials = db_pool_alloc({sizeof(SkyMaterial), MAX_DB_SKY_MATERIALS, "Pool Sky Material"});
 
+uint32_t db_get_sky_material_count() {
+    return s_dbSkyMaterials.highWatermark;
+}
+
+bool db_valid_sky_material(uint32_t index) {
+    return mem_pool_is_alive(s_dbSkyMaterials, index);
+}
 
 uint32_t db_add_sky_material(const SkyMaterial &skyMaterial) {
-    ASSERT(s_dbSkyMaterials.count < MAX_DB_LIT_MATERIALS);
-    uint32_t currentLitMaterialsIndex = s_dbSkyMaterials.count;
-    s_dbSkyMaterials.start[currentLitMaterialsIndex] = skyMaterial;
-    s_dbSkyMaterials.count++;
-    return currentLitMaterialsIndex;
+    return db_pool_add(s_dbSkyMaterials, skyMaterial);
+}
+
+void db_remove_sky_material(uint32_t index) {
+    ASSERT_MSG(!db_sky_material_is_referenced(index), "Err: sky material [%u] is still used by an entity, remove the entity first", index);
+    mem_pool_free_index(s_dbSkyMaterials, index);
 }
 
 SkyMaterial *db_get_sky_material(uint32_t index) {
-    ASSERT(index < MAX_DB_LIT_MATERIALS);
-    return &s_dbSkyMaterials.start[index];
+    return db_pool_get<SkyMaterial>(s_dbSkyMaterials, index);
 }
 //======================================================================================================================
 
 //===LIT_ENTITIES=======================================================================================================
-static struct LitEntityPool{
-    LitEntity* start;
-    uint32_t count;
-} s_dbLitEntities = *(LitEntityPool*) db_pool_alloc({sizeof(LitEntity), MAX_DB_LIT_ENTITIES, "Pool Lit Entity"});
+static MemPool& s_dbLitEntities = db_pool_alloc({sizeof(LitEntity), MAX_DB_LIT_ENTITIES, "Pool Lit Entity"});
 
 uint32_t db_get_lit_entity_count() {
-    return s_dbLitEntities.count;
+    return s_dbLitEntities.highWatermark;
+}
+
+bool db_valid_lit_entity(uint32_t index) {
+    return mem_pool_is_alive(s_dbLitEntities, index);
 }
 
 uint32_t db_add_lit_entity(const LitEntity &litEntity) {
-    ASSERT(s_dbLitEntities.count < MAX_DB_LIT_ENTITIES);
-    uint32_t currentLitEntityIndex = s_dbLitEntities.count;
-    s_dbLitEntities.start[currentLitEntityIndex] = litEntity;
-    s_dbLitEntities.count++;
-    return currentLitEntityIndex;
+    return db_pool_add(s_dbLitEntities, litEntity);
+}
+
+void db_remove_lit_entity(uint32_t index) {
+    mem_pool_free_index(s_dbLitEntities, index);
 }
 
 LitEntity *db_get_lit_entity(uint32_t index) {
-    ASSERT(index < MAX_DB_LIT_ENTITIES);
-    return &s_dbLitEntities.start[index];
+    return db_pool_get<LitEntity>(s_dbLitEntities, index);
 }
 //======================================================================================================================
 
 //===SKY_ENTITIES=======================================================================================================
-static struct SkyEntityPool{
-    SkyEntity* start;
-    uint32_t count;
-}& s_dbSkyEntities = *(SkyEntityPool*) db_pool_alloc({sizeof(SkyEntity), MAX_DB_SKY_ENTITIES, "Pool Lit Entity"});
+static MemPool& s_dbSkyEntities = db_pool_alloc({sizeof(SkyEntity), MAX_DB_SKY_ENTITIES, "Pool Sky Entity"});
 
 uint32_t db_get_sky_entity_count() {
-    return s_dbSkyEntities.count;
+    return s_dbSkyEntities.highWatermark;
+}
+
+bool db_valid_sky_entity(uint32_t index) {
+    return mem_pool_is_alive(s_dbSkyEntities, index);
 }
 
 uint32_t db_add_sky_entity(const SkyEntity &skyEntity) {
-    ASSERT(s_dbSkyEntities.count < MAX_DB_LIT_ENTITIES);
-    uint32_t currentLitEntityIndex = s_dbSkyEntities.count;
-    s_dbSkyEntities.start[currentLitEntityIndex] = skyEntity;
-    s_dbSkyEntities.count++;
-    return currentLitEntityIndex;
+    return db_pool_add(s_dbSkyEntities, skyEntity);
+}
+
+void db_remove_sky_entity(uint32_t index) {
+    mem_pool_free_index(s_dbSkyEntities, index);
 }
 
 SkyEntity *db_get_sky_entity(uint32_t index) {
-    ASSERT(index < MAX_DB_LIT_ENTITIES);
-    return &s_dbSkyEntities.start[index];
+    return db_pool_get<SkyEntity>(s_dbSkyEntities, index);
 }
 //======================================================================================================================
-
-
@@ -4,6 +4,7 @@
 #include <beet_shared/log.h>
 #include <beet_shared/shared_utils.h>
 #include <beet_shared/memory.h>
+#include <beet_shared/profiler.h>
 #include <beet_shared/c_string.h>
 #include <beet_shared/beet_types.h>
 
@@ -24,6 +25,13 @@
 #include <beet_gfx/gfx_converter.h>
 #include <beet_gfx/gfx_line.h>
 #include <beet_gfx/gfx_triangle_strip.h>
+#include <beet_gfx/gfx_timestamps.h>
+#include <beet_gfx/gfx_texture.h>
+#include <beet_gfx/gfx_upload.h>
+#include <beet_gfx/gfx_memory.h>
+#include <beet_gfx/gfx_residency.h>
+#include <beet_gfx/gfx_bindless.h>
+#include <beet_gfx/gfx_indexed_indirect.h>
 
 #include <beet_math/quat.h>
 #include <beet_math/utilities.h>
@@ -48,8 +56,17 @@ static struct UserArguments {
 VulkanBackend g_vulkanBackend = {};
 TargetVulkanFormats g_vulkanTargetFormats = {};
 
+constexpr size_t BEET_GFX_FRAME_ARENA_RESERVE_SIZE = 256 * 1024 * 1024;
+
+constexpr uint32_t BEET_GFX_HEADLESS_TARGET_COUNT = BEET_BUFFER_COUNT;
+
 static struct {
     uint32_t currentFrame = {0};
+    MemArena frameArena = {};
+    bool headless = {false};
+    bool debugUtilsEnabled = {false};
+    uint32_t drawCallCount = {0};
+    uint32_t lastDrawCallCount = {0};
 } s_vulkanBackendInternal;
 
 //===INTERNAL_FUNCTIONS=================================================================================================
@@ -83,7 +100,7 @@ static void gfx_cleanup_instance() {
 static void gfx_create_instance() {
     vkEnumerateInstanceExtensionProperties(nullptr, &g_vulkanBackend.extensionsCount, nullptr);
     ASSERT(g_vulkanBackend.supportedExtensions == nullptr);
-    g_vulkanBackend.supportedExtensions = (VkExtensionProperties *) mem_zalloc(sizeof(VkExtensionProperties) * g_vulkanBackend.extensionsCount);
+    g_vulkanBackend.supportedExtensions = (VkExtensionProperties *) mem_zalloc(sizeof(VkExtensionProperties) * g_vulkanBackend.extensionsCount, MSG_GFX);
     if (g_vulkanBackend.extensionsCount > 0) {
         vkEnumerateInstanceExtensionProperties(nullptr, &g_vulkanBackend.extensionsCount, g_vulkanBackend.supportedExtensions);
     }
@@ -92,14 +109,29 @@ static void gfx_create_instance() {
         log_verbose(MSG_GFX, "Instance extension: %s \n", g_vulkanBackend.supportedExtensions[i].extensionName);
     }
 
+    // headless instances skip the surface extensions, debug utils is optional there as software ICDs on build agents may lack it.
+    const char *enabledInstanceExtensions[BEET_VK_INSTANCE_EXTENSION_COUNT] = {};
+    uint32_t enabledInstanceExtensionCount = 0;
     for (uint8_t i = 0; i < BEET_VK_INSTANCE_EXTENSION_COUNT; i++) {
-        const bool result = gfx_find_supported_extension(BEET_VK_INSTANCE_EXTENSIONS[i]);
-        ASSERT_MSG(result, "Err: failed find support for extension [%s]", BEET_VK_INSTANCE_EXTENSIONS[i]);
+        const char *extension = BEET_VK_INSTANCE_EXTENSIONS[i];
+        const bool isSurfaceExtension = c_str_equal(extension, VK_KHR_SURFACE_EXTENSION_NAME) || c_str_equal(extension, BEET_VK_SURFACE_EXTENSION);
+        const bool isDebugUtilsExtension = c_str_equal(extension, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        if (s_vulkanBackendInternal.headless && isSurfaceExtension) {
+            continue;
+        }
+        const bool result = gfx_find_supported_extension(extension);
+        if (s_vulkanBackendInternal.headless && isDebugUtilsExtension && !result) {
+            log_warning(MSG_GFX, "headless: [%s] is not supported, validation messages are disabled\n", extension);
+            continue;
+        }
+        ASSERT_MSG(result, "Err: failed find support for extension [%s]", extension);
+        s_vulkanBackendInternal.debugUtilsEnabled |= isDebugUtilsExtension;
+        enabledInstanceExtensions[enabledInstanceExtensionCount++] = extension;
     }
 
     vkEnumerateInstanceLayerProperties(&g_vulkanBackend.validationLayersCount, nullptr);
     ASSERT(g_vulkanBackend.supportedValidationLayers == nullptr);
-    g_vulkanBackend.supportedValidationLayers = (VkLayerProperties *) mem_zalloc(sizeof(VkLayerProperties) * g_vulkanBackend.validationLayersCount);
+    g_vulkanBackend.supportedValidationLayers = (VkLayerProperties *) mem_zalloc(sizeof(VkLayerProperties) * g_vulkanBackend.validationLayersCount, MSG_GFX);
     if (g_vulkanBackend.validationLayersCount > 0) {
         vkEnumerateInstanceLayerProperties(&g_vulkanBackend.validationLayersCount, g_vulkanBackend.supportedValidationLayers);
     }
@@ -108,9 +140,16 @@ static void gfx_create_instance() {
         log_verbose(MSG_GFX, "Layer: %s - Desc: %s \n", g_vulkanBackend.supportedValidationLayers[i].layerName, g_vulkanBackend.supportedValidationLayers[i].description);
     }
 
+    const char *enabledValidations[BEET_VK_VALIDATION_COUNT] = {};
+    uint32_t enabledValidationCount = 0;
     for (uint8_t i = 0; i < BEET_VK_VALIDATION_COUNT; i++) {
         const bool result = gfx_find_supported_validation(beetVulkanValidations[i]);
+        if (s_vulkanBackendInternal.headless && !result) {
+            log_warning(MSG_GFX, "headless: validation layer [%s] is not installed, continuing without it\n", beetVulkanValidations[i]);
+            continue;
+        }
         ASSERT_MSG(result, "Err: failed find support for validation layer [%s]", beetVulkanValidations[i]);
+        enabledValidations[enabledValidationCount++] = beetVulkanValidations[i];
     }
 
     VkApplicationInfo applicationInfo = {
@@ -126,10 +165,10 @@ static void gfx_create_instance() {
     VkInstanceCreateInfo instanceInfo = {
             .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
             .pApplicationInfo = &applicationInfo,
-            .enabledLayerCount = BEET_VK_VALIDATION_COUNT,
-            .ppEnabledLayerNames = beetVulkanValidations,
-            .enabledExtensionCount = BEET_VK_INSTANCE_EXTENSION_COUNT,
-            .ppEnabledExtensionNames = BEET_VK_INSTANCE_EXTENSIONS,
+            .enabledLayerCount = enabledValidationCount,
+            .ppEnabledLayerNames = enabledValidations,
+            .enabledExtensionCount = enabledInstanceExtensionCount,
+            .ppEnabledExtensionNames = enabledInstanceExtensions,
     };
 
     const auto result = vkCreateInstance(&instanceInfo, nullptr, &g_vulkanBackend.instance);
@@ -152,7 +191,7 @@ static void gfx_create_physical_device() {
     vkEnumeratePhysicalDevices(g_vulkanBackend.instance, &deviceCount, nullptr);
     ASSERT_MSG(deviceCount != 0, "Err: did not find any vulkan compatible physical devices");
 
-    VkPhysicalDevice *physicalDevices = (VkPhysicalDevice *) mem_zalloc(sizeof(VkPhysicalDevice) * deviceCount);
+    VkPhysicalDevice *physicalDevices = (VkPhysicalDevice *) mem_zalloc(sizeof(VkPhysicalDevice) * deviceCount, MSG_GFX);
     vkEnumeratePhysicalDevices(g_vulkanBackend.instance, &deviceCount, physicalDevices);
 
     // TODO:GFX: Add fallback support for `best` GPU based on intended workload, if no argument is provided we fallback to device [0]
@@ -211,14 +250,14 @@ static void gfx_cleanup_queues() {
 
     g_vulkanBackend.queue = VK_NULL_HANDLE;
 //    g_vulkanBackend.queuePresent = nullptr;
-//    g_vulkanBackend.queueTransfer = nullptr;
+    g_vulkanBackend.queueTransfer = VK_NULL_HANDLE;
 //    TODO: COMPUTE QUEUE
 }
 
 static void gfx_create_queues() {
     uint32_t devicePropertyCount = 0;
     vkEnumerateDeviceExtensionProperties(g_vulkanBackend.physicalDevice, nullptr, &devicePropertyCount, nullptr);
-    VkExtensionProperties *selectedPhysicalDeviceExtensions = (VkExtensionProperties *) mem_zalloc(sizeof(VkExtensionProperties) * devicePropertyCount);
+    VkExtensionProperties *selectedPhysicalDeviceExtensions = (VkExtensionProperties *) mem_zalloc(sizeof(VkExtensionProperties) * devicePropertyCount, MSG_GFX);
 
     if (devicePropertyCount > 0) {
         vkEnumerateDeviceExtensionProperties(g_vulkanBackend.physicalDevice, nullptr, &devicePropertyCount, selectedPhysicalDeviceExtensions);
@@ -232,7 +271,7 @@ static void gfx_create_queues() {
     vkGetPhysicalDeviceQueueFamilyProperties(g_vulkanBackend.physicalDevice, &queueFamilyCount, nullptr);
     ASSERT(queueFamilyCount != 0);
 
-    VkQueueFamilyProperties *queueFamilies = (VkQueueFamilyProperties *) mem_zalloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount);
+    VkQueueFamilyProperties *queueFamilies = (VkQueueFamilyProperties *) mem_zalloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount, MSG_GFX);
     vkGetPhysicalDeviceQueueFamilyProperties(g_vulkanBackend.physicalDevice, &queueFamilyCount, queueFamilies);
 
     struct QueueInfo {
@@ -253,12 +292,15 @@ static void gfx_create_queues() {
 
     for (uint32_t queueFamilyIndex = 0; queueFamilyIndex < queueFamilyCount; ++queueFamilyIndex) {
         VkBool32 supportsPresent = 0;
-        VkResult presentResult = vkGetPhysicalDeviceSurfaceSupportKHR(
-                g_vulkanBackend.physicalDevice,
-                queueFamilyIndex,
-                g_vulkanBackend.swapChain.surface,
-                &supportsPresent
-        );
+        VkResult presentResult = VK_ERROR_SURFACE_LOST_KHR;
+        if (g_vulkanBackend.swapChain.surface != VK_NULL_HANDLE) {
+            presentResult = vkGetPhysicalDeviceSurfaceSupportKHR(
+                    g_vulkanBackend.physicalDevice,
+                    queueFamilyIndex,
+                    g_vulkanBackend.swapChain.surface,
+                    &supportsPresent
+            );
+        }
 
         const uint32_t currentQueueFlags = queueFamilies[queueFamilyIndex].queueFlags;
 
@@ -271,7 +313,7 @@ static void gfx_create_queues() {
             }
         }
 
-        if (currentQueueFlags & graphicsQueueInfo.targetFlags) {
+        if ((currentQueueFlags & graphicsQueueInfo.targetFlags) == graphicsQueueInfo.targetFlags) {
             if (count_set_bits(currentQueueFlags) < count_set_bits(graphicsQueueInfo.currentFlags)) {
                 graphicsQueueInfo.currentFlags = currentQueueFlags;
                 graphicsQueueInfo.queueIndex = queueFamilyIndex;
@@ -280,7 +322,8 @@ static void gfx_create_queues() {
             }
         }
 
-        if (currentQueueFlags & transferQueueInfo.targetFlags) {
+        // graphics families implicitly support transfer, only a family without graphics can copy alongside rendering.
+        if ((currentQueueFlags & transferQueueInfo.targetFlags) && (currentQueueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) {
             if (count_set_bits(currentQueueFlags) < count_set_bits(transferQueueInfo.currentFlags)) {
                 transferQueueInfo.currentFlags = currentQueueFlags;
                 transferQueueInfo.queueIndex = queueFamilyIndex;
@@ -292,7 +335,7 @@ static void gfx_create_queues() {
 
     log_verbose(MSG_GFX, "graphics queue index: %u \n", graphicsQueueInfo.queueIndex);
 //    log_verbose(MSG_GFX, "present queue index:  %u \n", presentQueueInfo.queueIndex);
-//    log_verbose(MSG_GFX, "transfer queue index: %u \n", transferQueueInfo.queueIndex);
+    log_verbose(MSG_GFX, "transfer queue index: %u \n", transferQueueInfo.queueIndex);
 //    TODO: COMPUTE QUEUE
 
     ASSERT_MSG(graphicsQueueInfo.queueIndex != UINT32_MAX, "Err: did not find graphics queue");
@@ -305,7 +348,7 @@ static void gfx_create_queues() {
     uint32_t currentQueueCount = 0;
 
     VkDeviceQueueCreateInfo queueCreateInfo[maxSupportedQueueCount] = {};
-    if (presentQueueInfo.queueIndex != graphicsQueueInfo.queueIndex) {
+    if (presentQueueInfo.queueIndex != UINT32_MAX && presentQueueInfo.queueIndex != graphicsQueueInfo.queueIndex) {
         queueCreateInfo[currentQueueCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueCreateInfo[currentQueueCount].queueFamilyIndex = presentQueueInfo.queueIndex;
         queueCreateInfo[currentQueueCount].queueCount = 1;
@@ -319,32 +362,75 @@ static void gfx_create_queues() {
     queueCreateInfo[currentQueueCount].pQueuePriorities = &queuePriority;
     ++currentQueueCount;
 
-    queueCreateInfo[currentQueueCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo[currentQueueCount].queueFamilyIndex = transferQueueInfo.queueIndex;
-    queueCreateInfo[currentQueueCount].queueCount = 1;
-    queueCreateInfo[currentQueueCount].pQueuePriorities = &queuePriority;
-    ++currentQueueCount;
+    // devices with a single queue family (e.g. lavapipe) never find a dedicated transfer family.
+    if (transferQueueInfo.queueIndex != UINT32_MAX
+        && transferQueueInfo.queueIndex != graphicsQueueInfo.queueIndex
+        && transferQueueInfo.queueIndex != presentQueueInfo.queueIndex) {
+        queueCreateInfo[currentQueueCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo[currentQueueCount].queueFamilyIndex = transferQueueInfo.queueIndex;
+        queueCreateInfo[currentQueueCount].queueCount = 1;
+        queueCreateInfo[currentQueueCount].pQueuePriorities = &queuePriority;
+        ++currentQueueCount;
+    }
 
     uint32_t deviceExtensionCount = 0;
     const char *enabledDeviceExtensions[BEET_VK_MAX_DEVICE_EXTENSION_COUNT] = {};
     for (int32_t i = 0; i < BEET_VK_REQUIRED_DEVICE_EXTENSION_COUNT; ++i) {
-        enabledDeviceExtensions[i] = BEET_VK_REQUIRED_DEVICE_EXTENSIONS[i];
+        if (s_vulkanBackendInternal.headless && c_str_equal(BEET_VK_REQUIRED_DEVICE_EXTENSIONS[i], VK_KHR_SWAPCHAIN_EXTENSION_NAME)) {
+            continue;
+        }
+        enabledDeviceExtensions[deviceExtensionCount] = BEET_VK_REQUIRED_DEVICE_EXTENSIONS[i];
         deviceExtensionCount++;
     }
+    // optional, without it the residency manager estimates the budget from heap sizes.
+    for (uint32_t i = 0; i < devicePropertyCount; ++i) {
+        if (c_str_equal(selectedPhysicalDeviceExtensions[i].extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+            enabledDeviceExtensions[deviceExtensionCount] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+            deviceExtensionCount++;
+            g_vulkanBackend.memoryBudgetSupported = true;
+            break;
+        }
+    }
 
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeaturesKHR{
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
             .pNext = nullptr,
             .dynamicRendering = VK_TRUE,
     };
+    // timeline semaphores (upload service), descriptor indexing (bindless textures) and indirect count (gpu culling)
+    // all come from the 1.2 feature set.
+    ASSERT_MSG(g_vulkanBackend.deviceProperties.apiVersion >= BEET_VK_API_VERSION_1_2, "Err: vulkan 1.2 is required for timeline semaphores");
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDeviceFeatures2 supportedFeatures2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    supportedFeatures2.pNext = &supportedVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(g_vulkanBackend.physicalDevice, &supportedFeatures2);
+    // lit materials index a single bindless sampler array that is rewritten while command buffers hold it bound.
+    ASSERT_MSG(supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind && supportedVulkan12Features.descriptorBindingPartiallyBound,
+               "Err: descriptor indexing with update after bind is required for bindless textures");
+    g_vulkanBackend.drawIndirectCountSupported = supportedVulkan12Features.drawIndirectCount;
+    VkPhysicalDeviceVulkan12Features vulkan12Features{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .pNext = nullptr,
+            .drawIndirectCount = supportedVulkan12Features.drawIndirectCount,
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+            .descriptorBindingPartiallyBound = VK_TRUE,
+            .timelineSemaphore = VK_TRUE,
+    };
+    dynamicRenderingFeaturesKHR.pNext = &vulkan12Features;
     void *pNextRoot0 = &dynamicRenderingFeaturesKHR;
 
+    // lit.frag picks its albedo from the bindless array with a per instance index.
+    ASSERT_MSG(g_vulkanBackend.deviceFeatures.shaderSampledImageArrayDynamicIndexing, "Err: shaderSampledImageArrayDynamicIndexing is required for bindless textures");
+    // optional, without drawIndirectFirstInstance gfx_indexed_indirect falls back to direct instanced draws.
     const VkPhysicalDeviceFeatures2 deviceFeatures2 = {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
             .pNext = pNextRoot0,
             .features = {
+                    .multiDrawIndirect = g_vulkanBackend.deviceFeatures.multiDrawIndirect,
+                    .drawIndirectFirstInstance = g_vulkanBackend.deviceFeatures.drawIndirectFirstInstance,
                     .wideLines = VK_TRUE,
                     .samplerAnisotropy = VK_TRUE,
+                    .shaderSampledImageArrayDynamicIndexing = VK_TRUE,
             },
     };
 
@@ -372,17 +458,25 @@ static void gfx_create_queues() {
 
     vkGetDeviceQueue(g_vulkanBackend.device, graphicsQueueInfo.queueIndex, 0, &g_vulkanBackend.queue);
 //    vkGetDeviceQueue(g_vulkanBackend.device, presentQueueInfo.queueIndex, 0, &g_vulkanBackend.queuePresent);
-//    vkGetDeviceQueue(g_vulkanBackend.device, transferQueueInfo.queueIndex, 0, &g_vulkanBackend.queueTransfer);
+    // without a dedicated family uploads share the graphics queue, ownership then never has to change hands.
+    const bool dedicatedTransfer = transferQueueInfo.queueIndex != UINT32_MAX
+                                   && transferQueueInfo.queueIndex != graphicsQueueInfo.queueIndex
+                                   && transferQueueInfo.queueIndex != presentQueueInfo.queueIndex;
+    if (dedicatedTransfer) {
+        vkGetDeviceQueue(g_vulkanBackend.device, transferQueueInfo.queueIndex, 0, &g_vulkanBackend.queueTransfer);
+    } else {
+        g_vulkanBackend.queueTransfer = g_vulkanBackend.queue;
+    }
 //    TODO: COMPUTE QUEUE
 
     g_vulkanBackend.queueFamilyIndices.graphics = graphicsQueueInfo.queueIndex;
 //    g_gfxDevice->presentQueueIndex = presentQueueInfo.queueIndex;
-//    g_gfxDevice->transferQueueIndex = transferQueueInfo.queueIndex;
+    g_vulkanBackend.queueFamilyIndices.transfer = dedicatedTransfer ? transferQueueInfo.queueIndex : graphicsQueueInfo.queueIndex;
 //    TODO: COMPUTE QUEUE
 
     ASSERT_MSG(g_vulkanBackend.queue, "Err: failed to create graphics queue");
 //    ASSERT_MSG(g_gfxDevice->vkPresentQueue, "Err: failed to create present queue");
-//    ASSERT_MSG(g_gfxDevice->vkTransferQueue, "Err: failed to create transfer queue");
+    ASSERT_MSG(g_vulkanBackend.queueTransfer, "Err: failed to create transfer queue");
 //    TODO: COMPUTE QUEUE
 
     mem_free(queueFamilies);
@@ -409,7 +503,7 @@ static VkPresentModeKHR select_present_mode() {
     ASSERT_MSG(presentRes == VK_SUCCESS, "Err: failed to get physical device surface present modes");
     ASSERT(presentModeCount > 0);
 
-    VkPresentModeKHR *presentModes = (VkPresentModeKHR *) mem_zalloc(sizeof(VkPresentModeKHR) * presentModeCount);
+    VkPresentModeKHR *presentModes = (VkPresentModeKHR *) mem_zalloc(sizeof(VkPresentModeKHR) * presentModeCount, MSG_GFX);
     const VkResult populateRes = vkGetPhysicalDeviceSurfacePresentModesKHR(g_vulkanBackend.physicalDevice, g_vulkanBackend.swapChain.surface, &presentModeCount, presentModes);
     ASSERT_MSG(populateRes == VK_SUCCESS, "Err: failed to populate present modes array");
 
@@ -562,6 +656,65 @@ static void gfx_cleanup_swap_chain() {
     g_vulkanBackend.swapChain.swapChain = VK_NULL_HANDLE;
 }
 
+// Stands in for the swap chain when headless, the images are rendered into exactly like swap chain images but never presented.
+static void gfx_create_headless_targets() {
+    g_vulkanTargetFormats.surfaceFormat = BEET_TARGET_SWAPCHAIN_FORMAT;
+    g_vulkanBackend.swapChain.imageCount = BEET_GFX_HEADLESS_TARGET_COUNT;
+    g_vulkanBackend.swapChain.currentImageIndex = 0;
+
+    for (uint32_t i = 0; i < g_vulkanBackend.swapChain.imageCount; i++) {
+        SwapChainBuffers &target = g_vulkanBackend.swapChain.buffers[i];
+        const VkImageCreateInfo imageInfo = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = g_vulkanTargetFormats.surfaceFormat.format,
+                .extent = {.width = g_vulkanBackend.swapChain.width, .height = g_vulkanBackend.swapChain.height, .depth = 1},
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+        const VkResult imageRes = vkCreateImage(g_vulkanBackend.device, &imageInfo, nullptr, &target.image);
+        ASSERT_MSG(imageRes == VK_SUCCESS, "Err: failed to create headless target image %u", i);
+
+        VkMemoryRequirements memoryRequirements{};
+        vkGetImageMemoryRequirements(g_vulkanBackend.device, target.image, &memoryRequirements);
+        const VkMemoryAllocateInfo allocInfo{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                .allocationSize = memoryRequirements.size,
+                .memoryTypeIndex = gfx_utils_get_memory_type(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+        };
+        const VkResult allocRes = vkAllocateMemory(g_vulkanBackend.device, &allocInfo, nullptr, &target.deviceMemory);
+        ASSERT_MSG(allocRes == VK_SUCCESS, "Err: failed to allocate memory for headless target %u", i);
+        const VkResult bindRes = vkBindImageMemory(g_vulkanBackend.device, target.image, target.deviceMemory, 0);
+        ASSERT_MSG(bindRes == VK_SUCCESS, "Err: failed to bind headless target %u", i);
+
+        const VkImageViewCreateInfo viewInfo{
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = target.image,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = g_vulkanTargetFormats.surfaceFormat.format,
+                .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+        };
+        const VkResult viewRes = vkCreateImageView(g_vulkanBackend.device, &viewInfo, nullptr, &target.view);
+        ASSERT_MSG(viewRes == VK_SUCCESS, "Err: failed to create headless target view %u", i);
+        g_vulkanBackend.swapChain.images[i] = target.image;
+    }
+}
+
+static void gfx_cleanup_headless_targets() {
+    for (uint32_t i = 0; i < g_vulkanBackend.swapChain.imageCount; i++) {
+        SwapChainBuffers &target = g_vulkanBackend.swapChain.buffers[i];
+        vkDestroyImageView(g_vulkanBackend.device, target.view, nullptr);
+        vkDestroyImage(g_vulkanBackend.device, target.image, nullptr);
+        vkFreeMemory(g_vulkanBackend.device, target.deviceMemory, nullptr);
+        target = {};
+        g_vulkanBackend.swapChain.images[i] = VK_NULL_HANDLE;
+    }
+}
+
 static void gfx_create_command_buffers() {
     const VkCommandBufferAllocateInfo gfxCommandBufferInfo = {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -608,6 +761,10 @@ static void gfx_create_fences() {
         const VkResult fenceRes = vkCreateFence(g_vulkanBackend.device, &fenceCreateInfo, nullptr, &g_vulkanBackend.graphicsFenceWait[i]);
         ASSERT_MSG(fenceRes == VK_SUCCESS, "Err: failed to create graphics fence [%u]", i);
     }
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        const VkResult fenceRes = vkCreateFence(g_vulkanBackend.device, &fenceCreateInfo, nullptr, &g_vulkanBackend.frameFences[i]);
+        ASSERT_MSG(fenceRes == VK_SUCCESS, "Err: failed to create frame fence [%u]", i);
+    }
 }
 
 static void gfx_cleanup_fences() {
@@ -615,6 +772,10 @@ static void gfx_cleanup_fences() {
         vkDestroyFence(g_vulkanBackend.device, g_vulkanBackend.graphicsFenceWait[i], nullptr);
         g_vulkanBackend.graphicsFenceWait[i] = VK_NULL_HANDLE;
     }
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        vkDestroyFence(g_vulkanBackend.device, g_vulkanBackend.frameFences[i], nullptr);
+        g_vulkanBackend.frameFences[i] = VK_NULL_HANDLE;
+    }
 }
 
 static void gfx_create_color_buffer() {
@@ -815,14 +976,16 @@ static void gfx_cleanup_pipeline_cache() {
 }
 
 static void gfx_flush() {
+    BEET_PROFILE_SCOPE("gfx_flush");
     if (g_vulkanBackend.device != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(g_vulkanBackend.device);
     }
 }
 
 static void gfx_render_frame(const VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_render_frame");
     constexpr VkPipelineStageFlags submitPipelineStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    const VkSubmitInfo submitInfo = {
+    VkSubmitInfo submitInfo = {
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
             .waitSemaphoreCount = 1,
             .pWaitSemaphores = &g_vulkanBackend.semaphores[gfx_last_swap_chain_index()].presentDone,
@@ -832,12 +995,29 @@ static void gfx_render_frame(const VkCommandBuffer &cmdBuffer) {
             .signalSemaphoreCount = 1,
             .pSignalSemaphores = &g_vulkanBackend.semaphores[gfx_swap_chain_index()].renderDone,
     };
+    if (s_vulkanBackendInternal.headless) {
+        // nothing is acquired or presented, so there is nothing to wait on or signal.
+        submitInfo.waitSemaphoreCount = 0;
+        submitInfo.signalSemaphoreCount = 0;
+    }
 
     const VkResult submitRes = vkQueueSubmit(g_vulkanBackend.queue, 1, &submitInfo, g_vulkanBackend.graphicsFenceWait[gfx_swap_chain_index()]);
     ASSERT(submitRes == VK_SUCCESS);
+
+    // the graphics fences follow swap chain images rather than frame slots. An empty submit signals the slot's fence
+    // once everything queued before it, this frame included, has completed.
+    VkFence &frameFence = g_vulkanBackend.frameFences[gfx_buffer_index()];
+    vkResetFences(g_vulkanBackend.device, 1, &frameFence);
+    const VkResult frameFenceRes = vkQueueSubmit(g_vulkanBackend.queue, 0, nullptr, frameFence);
+    ASSERT(frameFenceRes == VK_SUCCESS);
 }
 
 static VkResult gfx_acquire_next_swap_chain_image() {
+    BEET_PROFILE_SCOPE("gfx_acquire_next_swap_chain_image");
+    if (s_vulkanBackendInternal.headless) {
+        g_vulkanBackend.swapChain.currentImageIndex = (g_vulkanBackend.swapChain.currentImageIndex + 1) % g_vulkanBackend.swapChain.imageCount;
+        return VK_SUCCESS;
+    }
     return vkAcquireNextImageKHR(
             g_vulkanBackend.device,
             g_vulkanBackend.swapChain.swapChain,
@@ -849,6 +1029,10 @@ static VkResult gfx_acquire_next_swap_chain_image() {
 }
 
 static VkResult gfx_present() {
+    BEET_PROFILE_SCOPE("gfx_present");
+    if (s_vulkanBackendInternal.headless) {
+        return VK_SUCCESS;
+    }
     VkPresentInfoKHR presentInfo = {
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
             .pNext = nullptr,
@@ -905,6 +1089,7 @@ static void gfx_window_resize() {
 }
 
 static void gfx_update_uniform_buffers() {
+    BEET_PROFILE_SCOPE("gfx_update_uniform_buffers");
     //TODO: UPDATE UBO with camera info i.e. view & proj.
     const CameraEntity &camEntity = *db_get_camera_entity(0);
     const Camera &camera = *db_get_camera(camEntity.cameraIndex);
@@ -1179,6 +1364,7 @@ void resolve_color_buffer_to_swapchain(VkCommandBuffer &cmdBuffer) {
 }
 
 static void gfx_dynamic_render(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_dynamic_render");
     const bool isMultisampling = (g_vulkanBackend.sampleCount != VK_SAMPLE_COUNT_1_BIT);
 
     gfx_command_insert_memory_barrier(
@@ -1232,12 +1418,14 @@ static void gfx_dynamic_render(VkCommandBuffer &cmdBuffer) {
             .pStencilAttachment = &depthStencilAttachment,
     };
 
+    gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_RESOLVE_DEPTH);
     if(isMultisampling){
         resolve_depth_stencil_to_resolved_depth(cmdBuffer, g_vulkanBackend.depthStencilBuffer, g_vulkanBackend.resolvedDepthBuffer);
     }
     else{
         blit_depth_stencil_to_resolved_depth(cmdBuffer, g_vulkanBackend.depthStencilBuffer, g_vulkanBackend.resolvedDepthBuffer);
     }
+    gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_RESOLVE_DEPTH);
 
     {
         gfx_command_begin_rendering(cmdBuffer, renderingInfo);
@@ -1248,19 +1436,36 @@ static void gfx_dynamic_render(VkCommandBuffer &cmdBuffer) {
             const VkRect2D scissor = {0, 0, g_vulkanBackend.swapChain.width, g_vulkanBackend.swapChain.height};
             vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
 
+            gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_SKY);
             gfx_sky_draw(cmdBuffer);
+            gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_SKY);
+
+            gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_LIT);
             gfx_lit_draw(cmdBuffer);
+            gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_LIT);
+
+            gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_TRIANGLE_STRIP);
             gfx_triangle_strip_draw(cmdBuffer);
+            gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_TRIANGLE_STRIP);
+
+            gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_LINE);
             gfx_line_draw(cmdBuffer);
+            gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_LINE);
 #if BEET_GFX_IMGUI
-            gfx_imgui_draw(cmdBuffer);
+            if (!s_vulkanBackendInternal.headless) {
+                gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_IMGUI);
+                gfx_imgui_draw(cmdBuffer);
+                gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_IMGUI);
+            }
 #endif // BEET_GFX_IMGUI
         }
         gfx_command_end_rendering(cmdBuffer);
     }
 
     if (isMultisampling) {
+        gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_RESOLVE_COLOR);
         resolve_color_buffer_to_swapchain(cmdBuffer);
+        gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_RESOLVE_COLOR);
     }
 
     gfx_command_insert_memory_barrier(
@@ -1269,7 +1474,7 @@ static void gfx_dynamic_render(VkCommandBuffer &cmdBuffer) {
             isMultisampling ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
             0,
             isMultisampling ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            s_vulkanBackendInternal.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
             isMultisampling ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
             VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}
@@ -1303,14 +1508,10 @@ static void gfx_create_uniform_buffers() {
             nullptr
     );
     ASSERT(uniformResult == VK_SUCCESS);
-
-    const VkResult mapResult = vkMapMemory(g_vulkanBackend.device, g_vulkanBackend.uniformBuffer.memory, 0, VK_WHOLE_SIZE, 0, &g_vulkanBackend.uniformBuffer.mappedData);
-    ASSERT(mapResult == VK_SUCCESS);
 }
 
 static void gfx_cleanup_uniform_buffers() {
-    vkDestroyBuffer(g_vulkanBackend.device, g_vulkanBackend.uniformBuffer.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, g_vulkanBackend.uniformBuffer.memory, nullptr);
+    gfx_buffer_cleanup(g_vulkanBackend.uniformBuffer);
 }
 //======================================================================================================================
 
@@ -1319,17 +1520,29 @@ void gfx_create(void *windowHandle) {
 #if BEET_CONVERT_ON_DEMAND
     gfx_converter_init(BEET_CMAKE_PIPELINE_ASSETS_DIR, BEET_CMAKE_RUNTIME_ASSETS_DIR);
 #endif //BEET_CONVERT_ON_DEMAND
+    mem_arena_create(s_vulkanBackendInternal.frameArena, BEET_GFX_FRAME_ARENA_RESERVE_SIZE, MSG_GFX);
 
     gfx_create_instance();
-    gfx_create_debug_callbacks();
+    if (s_vulkanBackendInternal.debugUtilsEnabled) {
+        gfx_create_debug_callbacks();
+    }
     gfx_create_physical_device();
-    gfx_create_surface(windowHandle, &g_vulkanBackend.instance, &g_vulkanBackend.swapChain.surface);
+    if (!s_vulkanBackendInternal.headless) {
+        gfx_create_surface(windowHandle, &g_vulkanBackend.instance, &g_vulkanBackend.swapChain.surface);
+    }
     gfx_create_queues();
+    gfx_create_memory();
     gfx_create_command_pool();
     gfx_create_semaphores();
-    gfx_create_swap_chain();
+    if (s_vulkanBackendInternal.headless) {
+        gfx_create_headless_targets();
+    } else {
+        gfx_create_swap_chain();
+    }
     gfx_create_command_buffers();
     gfx_create_fences();
+    gfx_create_upload();
+    gfx_create_residency();
     gfx_create_color_buffer();
     gfx_create_depth_stencil_buffer();
     gfx_create_resolve_depth_buffer();
@@ -1338,10 +1551,15 @@ void gfx_create(void *windowHandle) {
     gfx_create_function_pointers();
 
     gfx_create_uniform_buffers();
+    gfx_create_timestamps();
 
 #if BEET_GFX_IMGUI
-    gfx_create_imgui(windowHandle);
+    if (!s_vulkanBackendInternal.headless) {
+        gfx_create_imgui(windowHandle);
+    }
 #endif //BEET_GFX_IMGUI
+    gfx_create_bindless();
+    gfx_create_indexed_indirect();
     gfx_create_sky();
     gfx_create_lit();
     gfx_create_line();
@@ -1349,14 +1567,22 @@ void gfx_create(void *windowHandle) {
 }
 
 void gfx_cleanup() {
+    gfx_cleanup_residency();
+    gfx_cleanup_texture_streaming();
+    gfx_cleanup_upload();
+    gfx_cleanup_timestamps();
     gfx_cleanup_uniform_buffers();
 
     gfx_cleanup_triangle_strip();
     gfx_cleanup_line();
     gfx_cleanup_lit();
+    gfx_cleanup_indexed_indirect();
+    gfx_cleanup_bindless();
     gfx_cleanup_sky();
 #if BEET_GFX_IMGUI
-    gfx_cleanup_imgui();
+    if (!s_vulkanBackendInternal.headless) {
+        gfx_cleanup_imgui();
+    }
 #endif //BEET_GFX_IMGUI
     gfx_cleanup_samplers();
     gfx_cleanup_pipeline_cache();
@@ -1365,20 +1591,52 @@ void gfx_cleanup() {
     gfx_cleanup_resolve_depth_stencil_buffer();
     gfx_cleanup_fences();
     gfx_cleanup_command_buffers();
-    gfx_cleanup_swap_chain();
+    if (s_vulkanBackendInternal.headless) {
+        gfx_cleanup_headless_targets();
+    } else {
+        gfx_cleanup_swap_chain();
+    }
     gfx_cleanup_semaphores();
     gfx_cleanup_command_pool();
+    gfx_cleanup_memory();
     gfx_cleanup_queues();
-    gfx_cleanup_surface();
+    if (!s_vulkanBackendInternal.headless) {
+        gfx_cleanup_surface();
+    }
     gfx_cleanup_physical_device();
-    gfx_cleanup_debug_callbacks();
+    if (s_vulkanBackendInternal.debugUtilsEnabled) {
+        gfx_cleanup_debug_callbacks();
+    }
     gfx_cleanup_instance();
     gfx_cleanup_function_pointers();
+    mem_arena_cleanup(s_vulkanBackendInternal.frameArena);
+    s_vulkanBackendInternal.headless = false;
+    s_vulkanBackendInternal.debugUtilsEnabled = false;
+}
+
+void gfx_create_headless(const vec2i targetSize) {
+    s_vulkanBackendInternal.headless = true;
+    g_vulkanBackend.swapChain.width = (uint32_t) targetSize.x;
+    g_vulkanBackend.swapChain.height = (uint32_t) targetSize.y;
+    gfx_create(nullptr);
 }
 //======================================================================================================================
 
 //===API================================================================================================================
 void gfx_update(const double &deltaTime) {
+    BEET_PROFILE_SCOPE("gfx_update");
+    mem_arena_reset(s_vulkanBackendInternal.frameArena);
+    {
+        // the last frame submitted from this slot has to be done before anything below rewrites its resources.
+        BEET_PROFILE_SCOPE("gfx_wait_for_frame_fence");
+        vkWaitForFences(g_vulkanBackend.device, 1, &g_vulkanBackend.frameFences[gfx_buffer_index()], true, UINT64_MAX);
+    }
+    gfx_upload_update();
+    gfx_residency_update();
+    gfx_texture_streaming_update();
+    gfx_bindless_update();
+    gfx_upload_flush(); // this frame's streaming copies overlap with its rendering
+
     g_vulkanBackend.swapChain.lastImageIndex = gfx_swap_chain_index();
     const VkResult nextRes = gfx_acquire_next_swap_chain_image();
     if (nextRes == VK_ERROR_OUT_OF_DATE_KHR) {
@@ -1387,16 +1645,27 @@ void gfx_update(const double &deltaTime) {
     } else if (nextRes < 0) {
         ASSERT(nextRes == VK_SUCCESS)
     }
-    vkWaitForFences(g_vulkanBackend.device, 1, &g_vulkanBackend.graphicsFenceWait[gfx_swap_chain_index()], true, UINT64_MAX);
-    vkResetFences(g_vulkanBackend.device, 1, &g_vulkanBackend.graphicsFenceWait[gfx_swap_chain_index()]);
+    {
+        BEET_PROFILE_SCOPE("gfx_wait_for_fence");
+        vkWaitForFences(g_vulkanBackend.device, 1, &g_vulkanBackend.graphicsFenceWait[gfx_swap_chain_index()], true, UINT64_MAX);
+        vkResetFences(g_vulkanBackend.device, 1, &g_vulkanBackend.graphicsFenceWait[gfx_swap_chain_index()]);
+    }
 
     gfx_update_uniform_buffers();
+    gfx_indexed_indirect_build();
 
+    s_vulkanBackendInternal.drawCallCount = 0;
     VkCommandBuffer cmdBuffer = g_vulkanBackend.graphicsCommandBuffers[gfx_buffer_index()];
     vkResetCommandBuffer(cmdBuffer, 0);
     begin_command_recording(cmdBuffer);
     {
+        gfx_timestamps_begin_frame(cmdBuffer);
+        gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_FRAME);
+        gfx_timestamps_write_begin(cmdBuffer, GFX_GPU_PASS_CULL);
+        gfx_indexed_indirect_cull(cmdBuffer);
+        gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_CULL);
         gfx_dynamic_render(cmdBuffer);
+        gfx_timestamps_write_end(cmdBuffer, GFX_GPU_PASS_FRAME);
     }
     end_command_recording(cmdBuffer);
     gfx_render_frame(cmdBuffer);
@@ -1404,9 +1673,18 @@ void gfx_update(const double &deltaTime) {
     gfx_present();
     gfx_flush();
 
+    s_vulkanBackendInternal.lastDrawCallCount = s_vulkanBackendInternal.drawCallCount;
     s_vulkanBackendInternal.currentFrame++;
 }
 
+MemArena *gfx_frame_arena() {
+    return &s_vulkanBackendInternal.frameArena;
+}
+
+uint32_t gfx_current_frame() {
+    return s_vulkanBackendInternal.currentFrame;
+}
+
 uint32_t gfx_buffer_index() {
     return (s_vulkanBackendInternal.currentFrame % BEET_BUFFER_COUNT);
 }
@@ -1427,4 +1705,20 @@ uint32_t get_multisample_count(){
     return (uint32_t)g_userArguments.msaa;
 }
 
+bool gfx_is_headless() {
+    return s_vulkanBackendInternal.headless;
+}
+
+const char *gfx_device_name() {
+    return g_vulkanBackend.deviceProperties.deviceName;
+}
+
+uint32_t gfx_draw_call_count() {
+    return s_vulkanBackendInternal.lastDrawCallCount;
+}
+
+void gfx_add_draw_calls(const uint32_t drawCount) {
+    s_vulkanBackendInternal.drawCallCount += drawCount;
+}
+
 //======================================================================================================================
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <beet_gfx/gfx_bindless.h>
+#include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_descriptors.h>
+#include <beet_gfx/db_asset.h>
+
+#include <beet_shared/assert.h>
+#include <beet_shared/profiler.h>
+
+#include <vulkan/vulkan_core.h>
+
+//===INTERNAL_STRUCTS===================================================================================================
+// handles can be recycled once destroyed, the image and base mip are compared too so a streaming view swap that gets
+// the old handle value back is still rewritten.
+struct GfxBindlessSlot {
+    VkImage image;
+    VkImageView view;
+    uint32_t residentBaseMip;
+};
+
+static struct GfxBindless {
+    VkDescriptorSetLayout descriptorSetLayout = {VK_NULL_HANDLE};
+    VkDescriptorPool descriptorPool = {VK_NULL_HANDLE};
+    VkDescriptorSet descriptorSet = {VK_NULL_HANDLE};
+    // what was last written into each slot, the db has no change notifications so slots are compared every frame.
+    GfxBindlessSlot published[GFX_BINDLESS_MAX_TEXTURES] = {};
+} s_gfxBindless;
+
+extern VulkanBackend g_vulkanBackend;
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static void gfx_bindless_create_descriptor_set_layout() {
+    //=== POOL =====//
+    const VkDescriptorPoolSize poolSize = {
+            .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = GFX_BINDLESS_MAX_TEXTURES,
+    };
+    const VkDescriptorPoolCreateInfo descriptorPoolInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets = 1,
+            .poolSizeCount = 1,
+            .pPoolSizes = &poolSize,
+    };
+    const VkResult createPoolRes = vkCreateDescriptorPool(g_vulkanBackend.device, &descriptorPoolInfo, nullptr, &s_gfxBindless.descriptorPool);
+    ASSERT(createPoolRes == VK_SUCCESS);
+
+    //=== LAYOUT ===//
+    // slots without a texture are never sampled, partially bound lets them stay unwritten.
+    const VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindingFlags = &bindingFlags,
+    };
+    const VkDescriptorSetLayoutBinding layoutBinding{
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = GFX_BINDLESS_MAX_TEXTURES,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+    };
+    const VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = &bindingFlagsCreateInfo,
+            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .bindingCount = 1,
+            .pBindings = &layoutBinding,
+    };
+    const VkResult descriptorResult = vkCreateDescriptorSetLayout(g_vulkanBackend.device, &descriptorSetLayoutCreateInfo, nullptr, &s_gfxBindless.descriptorSetLayout);
+    ASSERT(descriptorResult == VK_SUCCESS);
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void gfx_bindless_update() {
+    BEET_PROFILE_SCOPE("gfx_bindless_update");
+    const uint32_t textureCount = db_get_texture_count();
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        if (!db_valid_texture(i)) {
+            // a released slot is left as is, partially bound only validates descriptors that are actually sampled.
+            s_gfxBindless.published[i] = {};
+            continue;
+        }
+        const GfxTexture &texture = *db_get_texture(i);
+        GfxBindlessSlot &slot = s_gfxBindless.published[i];
+        // the shaders declare a sampler2D array, cube maps and volumes keep binding their own descriptors.
+        // db_add_lit_material asserts materials only reference 2D textures, so a skipped slot is never sampled.
+        if (texture.viewType != VK_IMAGE_VIEW_TYPE_2D ||
+            (slot.image == texture.image && slot.view == texture.view && slot.residentBaseMip == texture.residentBaseMip)) {
+            continue;
+        }
+        const VkWriteDescriptorSet write = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = s_gfxBindless.descriptorSet,
+                .dstBinding = 0,
+                .dstArrayElement = i,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &texture.descriptor,
+        };
+        vkUpdateDescriptorSets(g_vulkanBackend.device, 1, &write, 0, nullptr);
+        slot = {texture.image, texture.view, texture.residentBaseMip};
+    }
+}
+
+void gfx_bindless_invalidate(const uint32_t textureIndex) {
+    ASSERT(textureIndex < GFX_BINDLESS_MAX_TEXTURES);
+    s_gfxBindless.published[textureIndex] = {};
+}
+
+VkDescriptorSetLayout gfx_bindless_layout() {
+    return s_gfxBindless.descriptorSetLayout;
+}
+
+VkDescriptorSet gfx_bindless_set() {
+    return s_gfxBindless.descriptorSet;
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_bindless() {
+    gfx_bindless_create_descriptor_set_layout();
+    const VkDescriptorSetAllocateInfo allocInfo = gfx_descriptor_set_alloc_info(s_gfxBindless.descriptorPool, &s_gfxBindless.descriptorSetLayout, 1);
+    const VkResult allocDescRes = vkAllocateDescriptorSets(g_vulkanBackend.device, &allocInfo, &s_gfxBindless.descriptorSet);
+    ASSERT(allocDescRes == VK_SUCCESS);
+}
+
+void gfx_cleanup_bindless() {
+    vkDestroyDescriptorPool(g_vulkanBackend.device, s_gfxBindless.descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(g_vulkanBackend.device, s_gfxBindless.descriptorSetLayout, nullptr);
+    s_gfxBindless = {};
+}
+//======================================================================================================================
@@ -2,17 +2,43 @@
 #include <beet_gfx/gfx_types.h>
 #include <beet_gfx/gfx_utils.h>
 #include <beet_gfx/gfx_command.h>
+#include <beet_gfx/gfx_memory.h>
 
 #include <beet_shared/assert.h>
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstring>
+
 //===INTERNAL_STRUCTS===================================================================================================
 extern VulkanBackend g_vulkanBackend;
 //======================================================================================================================
 
+//===INTERNAL_FUNCTIONS=================================================================================================
+static VkMemoryAllocateFlags gfx_buffer_allocate_flags(const VkBufferUsageFlags usageFlags) {
+    // when the buffer has VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT set we also need to enable the appropriate flag during allocation
+    return (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) ? VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT : 0;
+}
+
+static void gfx_buffer_write_initial_data(const GfxAllocation &allocation, const VkMemoryPropertyFlags memoryPropertyFlags, const void *inData, const VkDeviceSize size) {
+    ASSERT_MSG(allocation.mapped != nullptr, "Err: initial buffer data requires host visible memory");
+    memcpy(allocation.mapped, inData, size);
+    // when host coherency hasn't been requested, do a manual flush to make writes visible
+    if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0) {
+        // the block is shared, so the flushed range has to start on a nonCoherentAtomSize boundary
+        const VkDeviceSize atomSize = g_vulkanBackend.deviceProperties.limits.nonCoherentAtomSize;
+        VkMappedMemoryRange mappedRange{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+        mappedRange.memory = allocation.memory;
+        mappedRange.offset = allocation.offset / atomSize * atomSize;
+        mappedRange.size = VK_WHOLE_SIZE;
+        vkFlushMappedMemoryRanges(g_vulkanBackend.device, 1, &mappedRange);
+    }
+}
+//======================================================================================================================
+
 //===API================================================================================================================
-VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryPropertyFlags &memoryPropertyFlags, GfxBuffer &outBuffer, const VkDeviceSize size, void *inData) {
+VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryPropertyFlags &memoryPropertyFlags, GfxBuffer &outBuffer, const VkDeviceSize size, void *inData,
+                           const GfxMemoryStrategy strategy) {
     VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
     bufferCreateInfo.usage = usageFlags;
     bufferCreateInfo.size = size;
@@ -22,41 +48,18 @@ VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryP
     ASSERT(createResult == VK_SUCCESS);
 
     VkMemoryRequirements memReqs;
-    VkMemoryAllocateInfo memAllocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
     vkGetBufferMemoryRequirements(g_vulkanBackend.device, outBuffer.buffer, &memReqs);
-    memAllocInfo.allocationSize = memReqs.size;
-    memAllocInfo.memoryTypeIndex = gfx_utils_get_memory_type(memReqs.memoryTypeBits, memoryPropertyFlags);
-
-    // when outBuffer has VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT set we also need to enable the appropriate flag during allocation
-    VkMemoryAllocateFlagsInfoKHR allocFlagsInfo{};
-    if (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-        allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
-        allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
-        memAllocInfo.pNext = &allocFlagsInfo;
-    }
-    const VkResult allocResult = vkAllocateMemory(g_vulkanBackend.device, &memAllocInfo, nullptr, &outBuffer.memory);
-    ASSERT(allocResult == VK_SUCCESS);
-
+    outBuffer.allocation = gfx_memory_alloc(memReqs, memoryPropertyFlags, GfxMemoryResource::Linear, strategy, gfx_buffer_allocate_flags(usageFlags));
+    const VkResult bindRes = vkBindBufferMemory(g_vulkanBackend.device, outBuffer.buffer, outBuffer.allocation.memory, outBuffer.allocation.offset);
+    ASSERT(bindRes == VK_SUCCESS);
+    outBuffer.mappedData = outBuffer.allocation.mapped;
     outBuffer.alignment = memReqs.alignment;
     outBuffer.size = size;
     outBuffer.usageFlags = usageFlags;
     outBuffer.memoryPropertyFlags = memoryPropertyFlags;
 
     if (inData != nullptr) {
-        void *mapped;
-        const VkResult VkMapRes = vkMapMemory(g_vulkanBackend.device, outBuffer.memory, 0, size, 0, &mapped);
-        ASSERT(VkMapRes == VK_SUCCESS);
-
-        memcpy(mapped, inData, size);
-        // when host coherency hasn't been requested, do a manual flush to make writes visible
-        if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0) {
-            VkMappedMemoryRange mappedRange{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
-            mappedRange.memory = outBuffer.memory;
-            mappedRange.offset = 0;
-            mappedRange.size = size;
-            vkFlushMappedMemoryRanges(g_vulkanBackend.device, 1, &mappedRange);
-        }
-        vkUnmapMemory(g_vulkanBackend.device, outBuffer.memory);
+        gfx_buffer_write_initial_data(outBuffer.allocation, memoryPropertyFlags, inData, size);
     }
 
     // Initialize a default descriptor that covers the whole buffer size
@@ -64,11 +67,11 @@ VkResult gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryP
     outBuffer.descriptor.buffer = outBuffer.buffer;
     outBuffer.descriptor.range = VK_WHOLE_SIZE;
 
-    return vkBindBufferMemory(g_vulkanBackend.device, outBuffer.buffer, outBuffer.memory, 0);
+    return VK_SUCCESS;
 }
 
 VkResult
-gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryPropertyFlags &memoryPropertyFlags, const VkDeviceSize &size, VkBuffer &outBuffer, VkDeviceMemory &memory,
+gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryPropertyFlags &memoryPropertyFlags, const VkDeviceSize &size, VkBuffer &outBuffer, GfxAllocation &outAllocation,
                   void *inData) {
     VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
     bufferCreateInfo.usage = usageFlags;
@@ -79,42 +82,23 @@ gfx_buffer_create(const VkBufferUsageFlags &usageFlags, const VkMemoryPropertyFl
     const VkResult createBuffer = vkCreateBuffer(g_vulkanBackend.device, &bufferCreateInfo, nullptr, &outBuffer);
     ASSERT(createBuffer == VK_SUCCESS);
 
-    VkMemoryRequirements memReqs;
-    VkMemoryAllocateInfo memAlloc{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-
-    vkGetBufferMemoryRequirements(g_vulkanBackend.device, outBuffer, &memReqs);
-    memAlloc.allocationSize = memReqs.size;
-    memAlloc.memoryTypeIndex = gfx_utils_get_memory_type(memReqs.memoryTypeBits, memoryPropertyFlags);
-
-    // when outBuffer has VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT set we also need to enable the appropriate flag during allocation
-    VkMemoryAllocateFlagsInfoKHR allocFlagsInfo{};
-    if (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-        allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
-        allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
-        memAlloc.pNext = &allocFlagsInfo;
-    }
-    const VkResult allocRes = vkAllocateMemory(g_vulkanBackend.device, &memAlloc, nullptr, &memory);
-    ASSERT(allocRes == VK_SUCCESS);
+    outAllocation = gfx_memory_alloc_buffer(outBuffer, memoryPropertyFlags, GfxMemoryStrategy::FreeList, gfx_buffer_allocate_flags(usageFlags));
 
     if (inData != nullptr) {
-        void *mapped;
-        const VkResult VkMapRes = vkMapMemory(g_vulkanBackend.device, memory, 0, size, 0, &mapped);
-        ASSERT(VkMapRes == VK_SUCCESS);
-
-        memcpy(mapped, inData, size);
-        // when host coherency hasn't been requested, do a manual flush to make writes visible
-        if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0) {
-            VkMappedMemoryRange mappedRange{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
-            mappedRange.memory = memory;
-            mappedRange.offset = 0;
-            mappedRange.size = size;
-            vkFlushMappedMemoryRanges(g_vulkanBackend.device, 1, &mappedRange);
-        }
-        vkUnmapMemory(g_vulkanBackend.device, memory);
+        gfx_buffer_write_initial_data(outAllocation, memoryPropertyFlags, inData, size);
     }
+    return VK_SUCCESS;
+}
+
+void gfx_buffer_cleanup(GfxBuffer &buffer) {
+    gfx_buffer_cleanup(buffer.buffer, buffer.allocation);
+    buffer.mappedData = nullptr;
+}
 
-    const VkResult bindRes = vkBindBufferMemory(g_vulkanBackend.device, outBuffer, memory, 0);
-    return bindRes;
+void gfx_buffer_cleanup(VkBuffer &buffer, GfxAllocation &allocation) {
+    vkDestroyBuffer(g_vulkanBackend.device, buffer, nullptr);
+    gfx_memory_free(allocation);
+    buffer = VK_NULL_HANDLE;
 }
 
 void gfx_buffer_copy_immediate(GfxBuffer &src, GfxBuffer &dst, VkQueue queue, VkBufferCopy *copyRegion) {
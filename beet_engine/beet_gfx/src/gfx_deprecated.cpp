@@ -12,7 +12,7 @@ extern VulkanBackend g_vulkanBackend;
 
 void gfx_create_deprecated_frame_buffer() {
     ASSERT(g_vulkanBackend.deprecated_frameBuffers == nullptr);
-    g_vulkanBackend.deprecated_frameBuffers = (VkFramebuffer *) mem_zalloc(sizeof(VkFramebuffer) * g_vulkanBackend.swapChain.imageCount);
+    g_vulkanBackend.deprecated_frameBuffers = (VkFramebuffer *) mem_zalloc(sizeof(VkFramebuffer) * g_vulkanBackend.swapChain.imageCount, MSG_GFX);
 
     constexpr uint32_t ATTACHMENT_COUNT = 2;
     for (uint32_t i = 0; i < g_vulkanBackend.swapChain.imageCount; ++i) {
@@ -138,9 +138,6 @@ void gfx_deprecated_render_pass(VkCommandBuffer &cmdBuffer) {
 
         VkRect2D scissor = {0, 0, g_vulkanBackend.swapChain.width, g_vulkanBackend.swapChain.height};
         vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
-
-//        gfx_indexed_indirect_render(cmdBuffer); // Disabled for now
-
     }
     vkCmdEndRenderPass(cmdBuffer);
 }
\ No newline at end of file
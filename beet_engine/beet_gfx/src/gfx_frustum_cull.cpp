@@ -0,0 +1,177 @@
+#include <beet_gfx/gfx_frustum_cull.h>
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#define GFX_FRUSTUM_CULL_AVX2 1
+#else
+#define GFX_FRUSTUM_CULL_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_FRUSTUM_CULL_SSE 1
+#else
+#define GFX_FRUSTUM_CULL_SSE 0
+#endif
+
+#if GFX_FRUSTUM_CULL_AVX2
+#include <immintrin.h>
+#elif GFX_FRUSTUM_CULL_SSE
+#include <xmmintrin.h>
+#endif
+
+//===INTERNAL_STRUCTS===================================================================================================
+constexpr uint32_t GFX_FRUSTUM_PLANE_COUNT = 6;
+
+// planes split into components, the absolute normal projects a box extent onto the plane normal.
+struct GfxFrustumPlanesSoA {
+    float x[GFX_FRUSTUM_PLANE_COUNT];
+    float y[GFX_FRUSTUM_PLANE_COUNT];
+    float z[GFX_FRUSTUM_PLANE_COUNT];
+    float w[GFX_FRUSTUM_PLANE_COUNT];
+    float absX[GFX_FRUSTUM_PLANE_COUNT];
+    float absY[GFX_FRUSTUM_PLANE_COUNT];
+    float absZ[GFX_FRUSTUM_PLANE_COUNT];
+};
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static GfxFrustumPlanesSoA gfx_frustum_planes_soa(const vec4f planes[6]) {
+    GfxFrustumPlanesSoA planesSoA = {};
+    for (uint32_t i = 0; i < GFX_FRUSTUM_PLANE_COUNT; ++i) {
+        planesSoA.x[i] = planes[i].x;
+        planesSoA.y[i] = planes[i].y;
+        planesSoA.z[i] = planes[i].z;
+        planesSoA.w[i] = planes[i].w;
+        planesSoA.absX[i] = fabsf(planes[i].x);
+        planesSoA.absY[i] = fabsf(planes[i].y);
+        planesSoA.absZ[i] = fabsf(planes[i].z);
+    }
+    return planesSoA;
+}
+
+// a box is outside once its center sits further behind a plane than the box reaches along that plane's normal.
+static bool gfx_frustum_test_aabb(const GfxFrustumPlanesSoA &planes, const GfxCullBoundsSoA &bounds, const uint32_t index) {
+    for (uint32_t i = 0; i < GFX_FRUSTUM_PLANE_COUNT; ++i) {
+        const float distance = planes.x[i] * bounds.centerX[index] + planes.y[i] * bounds.centerY[index] + planes.z[i] * bounds.centerZ[index] + planes.w[i];
+        const float reach = planes.absX[i] * bounds.extentX[index] + planes.absY[i] * bounds.extentY[index] + planes.absZ[i] * bounds.extentZ[index];
+        if (distance + reach < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// appends the lanes set in visibleMask without branching on them. Every lane is written, rejected ones are overwritten by
+// the next survivor, visibleCount never passes the box index so the write stays inside outVisible.
+static uint32_t gfx_frustum_append_visible(const uint32_t firstIndex, const uint32_t laneCount, const uint32_t visibleMask, uint32_t *outVisible, uint32_t visibleCount) {
+    for (uint32_t lane = 0; lane < laneCount; ++lane) {
+        outVisible[visibleCount] = firstIndex + lane;
+        visibleCount += (visibleMask >> lane) & 1;
+    }
+    return visibleCount;
+}
+
+#if GFX_FRUSTUM_CULL_AVX2
+static uint32_t gfx_frustum_cull_avx2(const GfxFrustumPlanesSoA &planes, const GfxCullBoundsSoA &bounds, const uint32_t count, uint32_t &inOutIndex, uint32_t *outVisible, uint32_t visibleCount) {
+    constexpr uint32_t laneCount = 8;
+    const __m256 zero = _mm256_setzero_ps();
+    for (; inOutIndex + laneCount <= count; inOutIndex += laneCount) {
+        const __m256 centerX = _mm256_loadu_ps(bounds.centerX + inOutIndex);
+        const __m256 centerY = _mm256_loadu_ps(bounds.centerY + inOutIndex);
+        const __m256 centerZ = _mm256_loadu_ps(bounds.centerZ + inOutIndex);
+        const __m256 extentX = _mm256_loadu_ps(bounds.extentX + inOutIndex);
+        const __m256 extentY = _mm256_loadu_ps(bounds.extentY + inOutIndex);
+        const __m256 extentZ = _mm256_loadu_ps(bounds.extentZ + inOutIndex);
+        __m256 outside = zero;
+        for (uint32_t i = 0; i < GFX_FRUSTUM_PLANE_COUNT; ++i) {
+            __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes.x[i]), centerX);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.y[i]), centerY));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.z[i]), centerZ));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.w[i]));
+            __m256 reach = _mm256_mul_ps(_mm256_set1_ps(planes.absX[i]), extentX);
+            reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(planes.absY[i]), extentY));
+            reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(planes.absZ[i]), extentZ));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_LT_OQ));
+        }
+        const uint32_t visibleMask = ~(uint32_t) _mm256_movemask_ps(outside) & 0xFF;
+        visibleCount = gfx_frustum_append_visible(inOutIndex, laneCount, visibleMask, outVisible, visibleCount);
+    }
+    return visibleCount;
+}
+#endif
+
+#if GFX_FRUSTUM_CULL_SSE
+static uint32_t gfx_frustum_cull_sse(const GfxFrustumPlanesSoA &planes, const GfxCullBoundsSoA &bounds, const uint32_t count, uint32_t &inOutIndex, uint32_t *outVisible, uint32_t visibleCount) {
+    constexpr uint32_t laneCount = 4;
+    const __m128 zero = _mm_setzero_ps();
+    for (; inOutIndex + laneCount <= count; inOutIndex += laneCount) {
+        const __m128 centerX = _mm_loadu_ps(bounds.centerX + inOutIndex);
+        const __m128 centerY = _mm_loadu_ps(bounds.centerY + inOutIndex);
+        const __m128 centerZ = _mm_loadu_ps(bounds.centerZ + inOutIndex);
+        const __m128 extentX = _mm_loadu_ps(bounds.extentX + inOutIndex);
+        const __m128 extentY = _mm_loadu_ps(bounds.extentY + inOutIndex);
+        const __m128 extentZ = _mm_loadu_ps(bounds.extentZ + inOutIndex);
+        __m128 outside = zero;
+        for (uint32_t i = 0; i < GFX_FRUSTUM_PLANE_COUNT; ++i) {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(planes.x[i]), centerX);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.y[i]), centerY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.z[i]), centerZ));
+            distance = _mm_add_ps(distance, _mm_set1_ps(planes.w[i]));
+            __m128 reach = _mm_mul_ps(_mm_set1_ps(planes.absX[i]), extentX);
+            reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(planes.absY[i]), extentY));
+            reach = _mm_add_ps(reach, _mm_mul_ps(_mm_set1_ps(planes.absZ[i]), extentZ));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+        }
+        const uint32_t visibleMask = ~(uint32_t) _mm_movemask_ps(outside) & 0xF;
+        visibleCount = gfx_frustum_append_visible(inOutIndex, laneCount, visibleMask, outVisible, visibleCount);
+    }
+    return visibleCount;
+}
+#endif
+//======================================================================================================================
+
+//===API================================================================================================================
+void gfx_frustum_planes(const mat4f &viewProj, vec4f outPlanes[6]) {
+    // glm matrices are indexed [column][row]
+    const vec4f row0 = {viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]};
+    const vec4f row1 = {viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]};
+    const vec4f row2 = {viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]};
+    const vec4f row3 = {viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]};
+    outPlanes[0] = row3 + row0;
+    outPlanes[1] = row3 - row0;
+    outPlanes[2] = row3 + row1;
+    outPlanes[3] = row3 - row1;
+    outPlanes[4] = row3 + row2;
+    outPlanes[5] = row3 - row2;
+    for (uint32_t i = 0; i < GFX_FRUSTUM_PLANE_COUNT; ++i) {
+        outPlanes[i] /= sqrtf(outPlanes[i].x * outPlanes[i].x + outPlanes[i].y * outPlanes[i].y + outPlanes[i].z * outPlanes[i].z);
+    }
+}
+
+void gfx_frustum_transform_aabb(const mat4f &model, const vec3f &boundsMin, const vec3f &boundsMax, vec3f &outCenter, vec3f &outExtent) {
+    // arvo, the world extent along each axis is the local extent projected through the absolute rotation and scale.
+    const vec3f center = (boundsMin + boundsMax) * 0.5f;
+    const vec3f extent = (boundsMax - boundsMin) * 0.5f;
+    outCenter = vec3f(model * vec4f(center, 1.0f));
+    outExtent = glm::abs(vec3f(model[0])) * extent.x + glm::abs(vec3f(model[1])) * extent.y + glm::abs(vec3f(model[2])) * extent.z;
+}
+
+uint32_t gfx_frustum_cull_aabbs(const vec4f planes[6], const GfxCullBoundsSoA &bounds, const uint32_t count, uint32_t *outVisible) {
+    const GfxFrustumPlanesSoA planesSoA = gfx_frustum_planes_soa(planes);
+    uint32_t index = 0;
+    uint32_t visibleCount = 0;
+#if GFX_FRUSTUM_CULL_AVX2
+    visibleCount = gfx_frustum_cull_avx2(planesSoA, bounds, count, index, outVisible, visibleCount);
+#endif
+#if GFX_FRUSTUM_CULL_SSE
+    visibleCount = gfx_frustum_cull_sse(planesSoA, bounds, count, index, outVisible, visibleCount);
+#endif
+    for (; index < count; ++index) {
+        if (gfx_frustum_test_aabb(planesSoA, bounds, index)) {
+            outVisible[visibleCount++] = index;
+        }
+    }
+    return visibleCount;
+}
+//======================================================================================================================
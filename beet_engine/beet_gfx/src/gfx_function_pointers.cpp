@@ -28,6 +28,9 @@ static void gfx_cleanup_function_pointers_dynamic_rendering() {
 }
 
 static void gfx_cleanup_function_pointers_debug_util_messenger() {
+    if (g_vkCreateDebugUtilsMessengerEXT_Func == VK_NULL_HANDLE) {
+        return; // headless instances may run without VK_EXT_debug_utils, in which case these were never loaded.
+    }
     ASSERT_MSG(g_vkCreateDebugUtilsMessengerEXT_Func != VK_NULL_HANDLE, "vulkan function pointer has already been invalidated");
     ASSERT_MSG(g_vkDestroyDebugUtilsMessengerEXT_Func != VK_NULL_HANDLE, "vulkan function pointer has already been invalidated");
     ASSERT_MSG(g_vkSetDebugUtilsObjectNameEXT_Func != VK_NULL_HANDLE, "vulkan function pointer has already been invalidated");
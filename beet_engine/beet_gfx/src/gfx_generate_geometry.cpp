@@ -1,8 +1,10 @@
 #include <beet_gfx/gfx_generate_geometry.h>
 #include <beet_shared/assert.h>
 
-std::vector<LinePoint3D> gfx_generate_geometry_cone(const vec3f &baseCenter, const float radius, const float height, const uint32_t color, const uint32_t segments) {
-    std::vector<LinePoint3D> vertices;
+LinePoint3D *gfx_generate_geometry_cone(MemArena &arena, const vec3f &baseCenter, const float radius, const float height, const uint32_t color, const uint32_t segments, uint32_t &outPointCount) {
+    outPointCount = (segments + 1) * 4;
+    LinePoint3D *vertices = (LinePoint3D *) mem_arena_alloc(arena, sizeof(LinePoint3D) * outPointCount);
+    uint32_t vertexIndex = 0;
 
     // top
     vec3f topVertex = baseCenter + vec3f(0.0f, height, 0.0f);
@@ -16,8 +18,8 @@ std::vector<LinePoint3D> gfx_generate_geometry_cone(const vec3f &baseCenter, con
         const float z = baseCenter.z + radius * glm::sin(angle);
 
         const vec3f baseVertex(x, y, z);
-        vertices.push_back({centerVertex, color});
-        vertices.push_back({baseVertex, color});
+        vertices[vertexIndex++] = {centerVertex, color};
+        vertices[vertexIndex++] = {baseVertex, color};
     }
 
     // side
@@ -28,31 +30,35 @@ std::vector<LinePoint3D> gfx_generate_geometry_cone(const vec3f &baseCenter, con
         const float z = baseCenter.z + radius * glm::sin(angle);
 
         const vec3f baseVertex(x, y, z);
-        vertices.push_back({baseVertex, color});
-        vertices.push_back({topVertex, color});
+        vertices[vertexIndex++] = {baseVertex, color};
+        vertices[vertexIndex++] = {topVertex, color};
     }
 
+    ASSERT(vertexIndex == outPointCount);
     return vertices;
 }
 
-std::vector<LinePoint3D> gfx_generate_geometry_thick_polyline(const std::vector<vec2f> &points, const float lineWidth, const uint32_t color, const bool closedLoop) {
-    std::vector<LinePoint3D> outVertices;
-    outVertices.reserve(points.size() * 2);
+LinePoint3D *gfx_generate_geometry_thick_polyline(MemArena &arena, const vec2f *points, const uint32_t pointCount, const float lineWidth, const uint32_t color, const bool closedLoop,
+                                                  uint32_t &outPointCount) {
+    ASSERT_MSG(pointCount > 2, "Err: Not enough points to create a thick polyline");
 
-    ASSERT_MSG(points.size() > 2, "Err: Not enough points to create a thick polyline");
-
-    if (points.size() < 2) {
-        return {};
+    if (pointCount < 2) {
+        outPointCount = 0;
+        return nullptr;
     }
 
+    outPointCount = (pointCount * 2) + (closedLoop ? 2 : 0);
+    LinePoint3D *outVertices = (LinePoint3D *) mem_arena_alloc(arena, sizeof(LinePoint3D) * outPointCount);
+    uint32_t vertexIndex = 0;
+
     const vec2 firstDir = glm::normalize(points[1] - points[0]);
     const vec2 firstNormal = vec2f(-firstDir.y, firstDir.x);
     const vec2 firstOffset = firstNormal * (lineWidth / 2.0f);
 
-    outVertices.push_back({vec3f(points[0] + firstOffset, 0.0f), color});
-    outVertices.push_back({vec3f(points[0] - firstOffset, 0.0f), color});
+    outVertices[vertexIndex++] = {vec3f(points[0] + firstOffset, 0.0f), color};
+    outVertices[vertexIndex++] = {vec3f(points[0] - firstOffset, 0.0f), color};
 
-    for (size_t i = 1; i < points.size() - 1; ++i) {
+    for (uint32_t i = 1; i < pointCount - 1; ++i) {
         const vec2f prevDir = glm::normalize(points[i] - points[i - 1]);
         const vec2f nextDir = glm::normalize(points[i + 1] - points[i]);
 
@@ -64,22 +70,23 @@ std::vector<LinePoint3D> gfx_generate_geometry_thick_polyline(const std::vector<
 
         const vec2f bevelOffset = joinNormal * (lineWidth / 2.0f);
 
-        outVertices.push_back({vec3f(points[i] + bevelOffset, 0.0f), color});
-        outVertices.push_back({vec3f(points[i] - bevelOffset, 0.0f), color});
+        outVertices[vertexIndex++] = {vec3f(points[i] + bevelOffset, 0.0f), color};
+        outVertices[vertexIndex++] = {vec3f(points[i] - bevelOffset, 0.0f), color};
     }
 
-    const size_t lastIndex = points.size() - 1;
+    const uint32_t lastIndex = pointCount - 1;
     const vec2f lastDir = glm::normalize(points[lastIndex] - points[lastIndex - 1]);
     const vec2f lastNormal = vec2f(-lastDir.y, lastDir.x);
     const vec2f lastOffset = lastNormal * (lineWidth / 2.0f);
 
-    outVertices.push_back({vec3f(points[lastIndex] + lastOffset, 0.0f), color});
-    outVertices.push_back({vec3f(points[lastIndex] - lastOffset, 0.0f), color});
+    outVertices[vertexIndex++] = {vec3f(points[lastIndex] + lastOffset, 0.0f), color};
+    outVertices[vertexIndex++] = {vec3f(points[lastIndex] - lastOffset, 0.0f), color};
 
     if (closedLoop) {
-        outVertices.push_back({vec3f(points[0] + firstOffset, 0.0f), color});
-        outVertices.push_back({vec3f(points[0] - firstOffset, 0.0f), color});
+        outVertices[vertexIndex++] = {vec3f(points[0] + firstOffset, 0.0f), color};
+        outVertices[vertexIndex++] = {vec3f(points[0] - firstOffset, 0.0f), color};
     }
 
+    ASSERT(vertexIndex == outPointCount);
     return outVertices;
-}
\ No newline at end of file
+}
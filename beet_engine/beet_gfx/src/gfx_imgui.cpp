@@ -2,6 +2,7 @@
 #include <beet_gfx/gfx_types.h>
 
 #include <beet_shared/assert.h>
+#include <beet_shared/profiler.h>
 
 #include <vulkan/vulkan_core.h>
 #include <imgui.h>
@@ -93,6 +94,7 @@ void gfx_imgui_demo_window() {
 }
 
 void gfx_imgui_draw(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_imgui_draw");
     ImGui::Render();
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmdBuffer, nullptr);
     g_imguiFinishedRendering = true;
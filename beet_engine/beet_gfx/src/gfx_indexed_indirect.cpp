@@ -1,300 +1,658 @@
 #include <beet_gfx/gfx_indexed_indirect.h>
 #include <beet_gfx/gfx_types.h>
-#include <beet_gfx/gfx_pipeline.h>
+#include <beet_gfx/gfx_buffer.h>
 #include <beet_gfx/gfx_mesh.h>
 #include <beet_gfx/gfx_shader.h>
 #include <beet_gfx/gfx_descriptors.h>
-#include <beet_gfx/gfx_command.h>
+#include <beet_gfx/gfx_frustum_cull.h>
+#include <beet_gfx/gfx_residency.h>
+#include <beet_gfx/gfx_interface.h>
 #include <beet_gfx/db_asset.h>
 
 #include <beet_shared/assert.h>
 #include <beet_shared/beet_types.h>
+#include <beet_shared/log.h>
+#include <beet_shared/memory.h>
+#include <beet_shared/profiler.h>
+#include <beet_shared/radix_sort.h>
+
+#include <beet_math/quat.h>
+#include <beet_math/transform.h>
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 //===INTERNAL_STRUCTS===================================================================================================
-constexpr uint32_t BEET_INSTANCE_BUFFER_BIND_ID = 1;
-#define OBJECT_INSTANCE_COUNT 1
-extern VulkanBackend g_vulkanBackend;
+// every lit entity is at most one instance and one command, so the buffers never need to grow.
+constexpr uint32_t GFX_INDIRECT_MAX_INSTANCES = MAX_DB_LIT_ENTITIES;
+constexpr uint32_t GFX_INDIRECT_MAX_COMMANDS = MAX_DB_LIT_ENTITIES;
+constexpr uint32_t GFX_CULL_WORKGROUP_SIZE = 64; // local_size_x of both culling shaders
+// float results differ slightly between the cpu reference and the shader, spheres this close to a plane may go either way.
+constexpr float GFX_CULL_VALIDATION_EPSILON = 1e-4f;
+
+// draw key, most significant first: pipeline | mesh | material | depth. Everything above the depth identifies a batch,
+// mesh sits above material because vertex and index buffers are the only per batch state left to bind.
+constexpr uint32_t GFX_DRAW_KEY_DEPTH_BITS = 24;
+constexpr uint32_t GFX_DRAW_KEY_MATERIAL_BITS = 16;
+constexpr uint32_t GFX_DRAW_KEY_MESH_BITS = 16;
+constexpr uint32_t GFX_DRAW_KEY_PIPELINE_BITS = 8;
+constexpr uint32_t GFX_DRAW_KEY_MATERIAL_SHIFT = GFX_DRAW_KEY_DEPTH_BITS;
+constexpr uint32_t GFX_DRAW_KEY_MESH_SHIFT = GFX_DRAW_KEY_MATERIAL_SHIFT + GFX_DRAW_KEY_MATERIAL_BITS;
+constexpr uint32_t GFX_DRAW_KEY_PIPELINE_SHIFT = GFX_DRAW_KEY_MESH_SHIFT + GFX_DRAW_KEY_MESH_BITS;
+static_assert(GFX_DRAW_KEY_PIPELINE_SHIFT + GFX_DRAW_KEY_PIPELINE_BITS == 64, "draw key fields must fill 64 bits");
+static_assert(MAX_DB_GFX_MESHES <= (1u << GFX_DRAW_KEY_MESH_BITS), "mesh index doesn't fit the draw key");
+static_assert(MAX_DB_LIT_MATERIALS <= (1u << GFX_DRAW_KEY_MATERIAL_BITS), "material index doesn't fit the draw key");
+// lit entities all go through the one lit pipeline for now, variants get their own value and sort into their own range.
+constexpr uint64_t GFX_DRAW_KEY_PIPELINE_LIT = 0;
+
+// range of indirect commands that share a mesh and therefore its vertex and index buffers.
+struct GfxIndirectMeshRun {
+    uint32_t meshIndex;
+    uint32_t firstCommand;
+    uint32_t commandCount;
+};
+
+// std430 mirror of CullInstance in cull_instances.comp
+struct GfxCullInstance {
+    mat4f model;
+    vec4f localSphere; // xyz center, w radius, in mesh space
+    uint32_t albedoIndex;
+    uint32_t commandIndex;
+    uint32_t unused_0;
+    uint32_t unused_1;
+};
+static_assert(sizeof(GfxCullInstance) == 96, "GfxCullInstance must match the std430 layout of CullInstance");
+
+// std430 mirror of CullCommand in the culling shaders, instanceCount is counted up on the gpu.
+struct GfxCullCommand {
+    VkDrawIndexedIndirectCommand command;
+    uint32_t meshRunIndex;
+    uint32_t meshRunFirstCommand;
+    uint32_t unused_0;
+};
+static_assert(sizeof(GfxCullCommand) == 32, "GfxCullCommand must match the std430 layout of CullCommand");
+
+struct GfxCullPushConstants {
+    uint32_t instanceCount;
+    uint32_t commandCount;
+    uint32_t compact;
+};
 
 static struct GfxIndexedIndirect {
+    // draw keys of the visible candidates and the candidate each key belongs to, radix sorted every frame.
+    uint64_t sortKeys[MAX_DB_LIT_ENTITIES] = {};
+    uint32_t sortCandidates[MAX_DB_LIT_ENTITIES] = {};
+    uint64_t scratchKeys[MAX_DB_LIT_ENTITIES] = {};
+    uint32_t scratchCandidates[MAX_DB_LIT_ENTITIES] = {};
+    GfxIndirectMeshRun meshRuns[GFX_INDIRECT_MAX_COMMANDS] = {};
+    uint32_t meshRunCount = {0};
+    uint32_t instanceCount = {0};
+    uint32_t commandCount = {0};
+    GfxIndirectStats stats = {};
+    bool multiDrawSupported = {false};
+
+    //===DIRECT_INSTANCING==========
+    // without drawIndirectFirstInstance batches are drawn with vkCmdDrawIndexed instead, firstInstance is always allowed
+    // on direct draws. The gpu culling pass is skipped and the cpu writes instances straight into a host visible buffer.
+    bool directInstancingRequired = {false};
+    bool directInstancing = {false};
+    GfxBuffer directInstanceBuffers[BEET_BUFFER_COUNT] = {};
+    //==============================
+
+    //===CPU_CULLING================
+    // valid lit entities of this frame, their world space bounds are tested before anything is sorted or uploaded.
+    bool cpuCulling = {true};
+    uint32_t candidateEntities[MAX_DB_LIT_ENTITIES] = {};
+    mat4f candidateModels[MAX_DB_LIT_ENTITIES] = {};
+    GfxCullBoundsSoA bounds = {}; // MEM_SIMD_ALIGNMENT arrays of GFX_INDIRECT_MAX_INSTANCES floats
+    uint32_t visibleCandidates[MAX_DB_LIT_ENTITIES] = {};
+    //==============================
+
+    //===CULLING====================
+    // host visible inputs, the culling pass compacts them into g_vulkanBackend.instanceBuffers and indirectCommandsBuffers.
+    // one copy per frame slot, the cpu rewrites a slot only once gfx_update has waited on its frame fence.
+    GfxBuffer cullInstanceBuffers[BEET_BUFFER_COUNT] = {};
+    GfxBuffer cullCommandBuffers[BEET_BUFFER_COUNT] = {};
+    uint32_t slotCommandCounts[BEET_BUFFER_COUNT] = {}; // commands built into each slot, read back when it comes around
     VkDescriptorSetLayout descriptorSetLayout = {VK_NULL_HANDLE};
     VkDescriptorPool descriptorPool = {VK_NULL_HANDLE};
+    VkDescriptorSet descriptorSets[BEET_BUFFER_COUNT] = {VK_NULL_HANDLE};
     VkPipelineLayout pipelineLayout = {VK_NULL_HANDLE};
-    VkPipeline pipeline = {VK_NULL_HANDLE};
-
-    uint32 usedDescriptorCount = 0;
-    static constexpr uint32_t MAX_DESCRIPTOR_COUNT = 1;
-    VkDescriptorSet descriptorSets[MAX_DESCRIPTOR_COUNT] = {};
+    VkPipeline cullInstancesPipeline = {VK_NULL_HANDLE};
+    VkPipeline cullCommandsPipeline = {VK_NULL_HANDLE};
+    //==============================
+
+    //===VALIDATION=================
+    // survivor range per command from the cpu reference, checked against the gpu counts once the frame has completed.
+    bool validateCulling = {false};
+    bool referenceReady[BEET_BUFFER_COUNT] = {}; // the frame last built into the slot has a reference to compare against
+    uint32_t referenceMin[BEET_BUFFER_COUNT][GFX_INDIRECT_MAX_COMMANDS] = {};
+    uint32_t referenceMax[BEET_BUFFER_COUNT][GFX_INDIRECT_MAX_COMMANDS] = {};
+    //==============================
 } s_gfxIndirect;
-//======================================================================================================================
 
-//===INTERNAL_STRUCTS===================================================================================================
-static void gfx_indexed_indirect_update_material_descriptor(VkDescriptorSet &outDescriptorSet, const GfxTexture &albedoTexture) {
-    VkDescriptorSetAllocateInfo allocInfo = gfx_descriptor_set_alloc_info(s_gfxIndirect.descriptorPool, &s_gfxIndirect.descriptorSetLayout, 1);
-    const VkResult allocDescRes = vkAllocateDescriptorSets(g_vulkanBackend.device, &allocInfo, &outDescriptorSet);
-    ASSERT(allocDescRes == VK_SUCCESS);
-    // TODO:    Update this to a buffer of textures so we can modify the contents without needing to rebuild descriptors
-    //          runtime packages will not need this as the content won't change.
-
-    constexpr uint32_t descriptorSetSize = 2;
-    const VkWriteDescriptorSet writeDescriptorSets[descriptorSetSize] = {
-            // Binding 0: Vertex shader uniform buffer
-            // Binding 1: albedoTexture // TODO: Add a per package loaded texture array
-            gfx_descriptor_set_write(outDescriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &g_vulkanBackend.uniformBuffer.descriptor, 1),
-            gfx_descriptor_set_write(outDescriptorSet, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &albedoTexture.descriptor, 1)
-    };
-    vkUpdateDescriptorSets(g_vulkanBackend.device, descriptorSetSize, &writeDescriptorSets[0], 0, nullptr);
-}
+extern VulkanBackend g_vulkanBackend;
 //======================================================================================================================
 
-//===API================================================================================================================
-void gfx_indexed_indirect_render(VkCommandBuffer &cmdBuffer) {
-    const LitEntity &entity = *db_get_lit_entity(0);
-    const GfxMesh &mesh = *db_get_mesh(entity.meshIndex);
-
-    VkDeviceSize offsets[1] = {0};
-    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_gfxIndirect.pipelineLayout, 0, 1, &s_gfxIndirect.descriptorSets[0], 0, NULL);
-
-    //cubePipeline
-    // [POI] Instanced multi draw rendering of the cubes
-    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_gfxIndirect.pipeline);
-    // Binding point 0 : Mesh vertex buffer
-    // Binding point 1 : Instance data buffer
-    vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mesh.vertBuffer, offsets);
-    vkCmdBindVertexBuffers(cmdBuffer, 1, 1, &g_vulkanBackend.instanceBuffer.buffer, offsets);
-
-    vkCmdBindIndexBuffer(cmdBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-    vkCmdDrawIndexedIndirect(cmdBuffer, g_vulkanBackend.indirectCommandsBuffer.buffer, 0, g_vulkanBackend.indirectDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+//===INTERNAL_FUNCTIONS=================================================================================================
+// depth is the camera distance to the box center. Positive floats order the same as their bit patterns, so the top
+// GFX_DRAW_KEY_DEPTH_BITS of the 31 used bits sort front to back inside a batch.
+static uint64_t gfx_indexed_indirect_draw_key(const uint64_t pipeline, const LitEntity &entity, const float depth) {
+    uint32_t depthBits;
+    memcpy(&depthBits, &depth, sizeof(float));
+    const uint64_t quantisedDepth = depthBits >> (31 - GFX_DRAW_KEY_DEPTH_BITS);
+    return (pipeline << GFX_DRAW_KEY_PIPELINE_SHIFT) |
+           ((uint64_t) entity.meshIndex << GFX_DRAW_KEY_MESH_SHIFT) |
+           ((uint64_t) entity.materialIndex << GFX_DRAW_KEY_MATERIAL_SHIFT) |
+           quantisedDepth;
 }
 
-void gfx_build_indexed_indirect_pipelines() {
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount = 1,
-            .pSetLayouts = &s_gfxIndirect.descriptorSetLayout
-    };
-    const VkResult pipelineLayoutRes = vkCreatePipelineLayout(g_vulkanBackend.device, &pipelineLayoutCreateInfo, nullptr, &s_gfxIndirect.pipelineLayout);
-    ASSERT(pipelineLayoutRes == VK_SUCCESS);
-
-    const VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = gfx_pipeline_input_assembly_create(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
-    const VkPipelineRasterizationStateCreateInfo rasterizationState = gfx_pipeline_rasterization_create(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
-    const VkPipelineColorBlendAttachmentState blendAttachmentState = gfx_pipeline_color_blend_attachment_state(0xf, VK_FALSE);
-    const VkPipelineColorBlendStateCreateInfo colorBlendState = gfx_pipeline_color_blend_state_create(1, &blendAttachmentState);
-    const VkPipelineDepthStencilStateCreateInfo depthStencilState = gfx_pipeline_depth_stencil_state_create(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS_OR_EQUAL);
-    const VkPipelineViewportStateCreateInfo viewportState = gfx_pipeline_viewport_state_create(1, 1, 0);
-    const VkPipelineMultisampleStateCreateInfo multisampleState = gfx_pipeline_multisample_state_create(g_vulkanBackend.sampleCount, 0);
-
-    constexpr uint32_t dynamicStateCount = 2;
-    const VkDynamicState dynamicStateEnables[dynamicStateCount] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-    VkPipelineDynamicStateCreateInfo dynamicState = gfx_pipeline_dynamic_state_create(dynamicStateEnables, dynamicStateCount, 0);
-
-    constexpr uint32_t shaderStagesCount = 2;
-    VkPipelineShaderStageCreateInfo shaderStages[shaderStagesCount] = {};
-
-    VkGraphicsPipelineCreateInfo pipelineCreateInfo = gfx_graphics_pipeline_create(); // using VK_KHR_dynamic_rendering we can skip passing a render pass
-    pipelineCreateInfo.layout = s_gfxIndirect.pipelineLayout;
-    pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
-    pipelineCreateInfo.pRasterizationState = &rasterizationState;
-    pipelineCreateInfo.pColorBlendState = &colorBlendState;
-    pipelineCreateInfo.pMultisampleState = &multisampleState;
-    pipelineCreateInfo.pViewportState = &viewportState;
-    pipelineCreateInfo.pDepthStencilState = &depthStencilState;
-    pipelineCreateInfo.pDynamicState = &dynamicState;
-    pipelineCreateInfo.stageCount = shaderStagesCount;
-    pipelineCreateInfo.pStages = &shaderStages[0];
-
-    const uint32_t bindingDescriptionsSize = 2;
-    VkVertexInputBindingDescription bindingDescriptions[bindingDescriptionsSize] = {
-            gfx_vertex_input_binding_desc(0, sizeof(GfxVertex), VK_VERTEX_INPUT_RATE_VERTEX),
-            gfx_vertex_input_binding_desc(BEET_INSTANCE_BUFFER_BIND_ID, sizeof(GfxInstanceData), VK_VERTEX_INPUT_RATE_VERTEX),
-    };
-
-    constexpr uint32_t attributeDescriptionsSize = 8;
-    VkVertexInputAttributeDescription attributeDescriptions[attributeDescriptionsSize] = {
-            gfx_vertex_input_attribute_desc(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, pos)),                                  // 0: Position
-            gfx_vertex_input_attribute_desc(0, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, normal)),                               // 1: Normal
-            gfx_vertex_input_attribute_desc(0, 2, VK_FORMAT_R32G32_SFLOAT, offsetof(GfxVertex, uv)),                                      // 2: Texture coordinates
-            gfx_vertex_input_attribute_desc(0, 3, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, color)),                               // 3: Color
-
-            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 4, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxInstanceData, pos)), // 4: Position
-            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 5, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxInstanceData, rot)), // 5: Rotation
-            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 6, VK_FORMAT_R32_SFLOAT, offsetof(GfxInstanceData, scale)),     // 6: Scale
-            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 7, VK_FORMAT_R32_SINT, offsetof(GfxInstanceData, texIndex)),    // 7: Texture array layer index
-    };
-
-    VkPipelineVertexInputStateCreateInfo inputState = {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-            .vertexBindingDescriptionCount   = bindingDescriptionsSize,
-            .pVertexBindingDescriptions = &bindingDescriptions[0],
-
-            .vertexAttributeDescriptionCount = attributeDescriptionsSize,
-            .pVertexAttributeDescriptions = &attributeDescriptions[0],
-    };
-    pipelineCreateInfo.pVertexInputState = &inputState;
-
-    shaderStages[0] = gfx_load_shader("assets/shaders/indirectdraw/indirectdraw.vert", VK_SHADER_STAGE_VERTEX_BIT);
-    shaderStages[1] = gfx_load_shader("assets/shaders/indirectdraw/indirectdraw.frag", VK_SHADER_STAGE_FRAGMENT_BIT);
-    const VkResult pipelineRes = (vkCreateGraphicsPipelines(g_vulkanBackend.device, g_vulkanBackend.pipelineCache, 1, &pipelineCreateInfo, nullptr, &s_gfxIndirect.pipeline));
-    ASSERT_MSG(pipelineRes == VK_SUCCESS, "Err: failed to create graphics pipeline");
-    vkDestroyShaderModule(g_vulkanBackend.device, shaderStages[0].module, nullptr);
-    vkDestroyShaderModule(g_vulkanBackend.device, shaderStages[1].module, nullptr);
+static uint64_t gfx_indexed_indirect_draw_key_geometry(const uint64_t key) {
+    return key >> GFX_DRAW_KEY_MESH_SHIFT;
 }
 
-void gfx_cleanup_indexed_indirect_pipelines() {
-    vkDestroyPipeline(g_vulkanBackend.device, s_gfxIndirect.pipeline, nullptr);
+static uint64_t gfx_indexed_indirect_draw_key_batch(const uint64_t key) {
+    return key >> GFX_DRAW_KEY_MATERIAL_SHIFT;
 }
 
-void gfx_build_indexed_indirect_commands() {
-    auto &indirectCommands = g_vulkanBackend.indirectCommands;
-    auto &indirectCommandsBuffer = g_vulkanBackend.indirectCommandsBuffer;
-    auto &indirectDrawCount = g_vulkanBackend.indirectDrawCount;
-    auto &objectCount = g_vulkanBackend.objectCount;
-    indirectCommands.clear();
-
-    // TODO: Create on indirect command for each element in a package
-    {
-        const GfxMesh &mesh = *db_get_mesh(0); // default mesh
-
-        uint32_t idx = 0;
-        VkDrawIndexedIndirectCommand indirectCmd{};
-        indirectCmd.instanceCount = OBJECT_INSTANCE_COUNT;
-        indirectCmd.firstInstance = idx * OBJECT_INSTANCE_COUNT;
-        indirectCmd.firstIndex = 0; // TODO: figure out what this should be when there are multiple instances
-        indirectCmd.indexCount = mesh.indexCount;
-
-        indirectCommands.push_back(indirectCmd);
+// same plane extraction as cull_instances.comp, read from the scene uniforms written for this frame.
+static void gfx_indexed_indirect_frustum_planes(vec4f outPlanes[6]) {
+    const SceneUBO &scene = *(const SceneUBO *) g_vulkanBackend.uniformBuffer.mappedData;
+    gfx_frustum_planes(scene.projection * scene.view, outPlanes);
+}
 
-        idx++;
+// collects every valid lit entity with its model matrix and world space box, returns the candidate count.
+static uint32_t gfx_indexed_indirect_gather_candidates() {
+    uint32_t candidateCount = 0;
+    const uint32_t litEntityCount = db_get_lit_entity_count();
+    for (uint32_t i = 0; i < litEntityCount; ++i) {
+        if (!db_valid_lit_entity(i)) {
+            continue;
+        }
+        const LitEntity &entity = *db_get_lit_entity(i);
+        const GfxMesh &mesh = *db_get_mesh(entity.meshIndex);
+        const mat4f model = transform_model_matrix(*db_get_transform(entity.transformIndex));
+        vec3f center;
+        vec3f extent;
+        gfx_frustum_transform_aabb(model, mesh.boundsMin, mesh.boundsMax, center, extent);
+
+        s_gfxIndirect.candidateEntities[candidateCount] = i;
+        s_gfxIndirect.candidateModels[candidateCount] = model;
+        s_gfxIndirect.bounds.centerX[candidateCount] = center.x;
+        s_gfxIndirect.bounds.centerY[candidateCount] = center.y;
+        s_gfxIndirect.bounds.centerZ[candidateCount] = center.z;
+        s_gfxIndirect.bounds.extentX[candidateCount] = extent.x;
+        s_gfxIndirect.bounds.extentY[candidateCount] = extent.y;
+        s_gfxIndirect.bounds.extentZ[candidateCount] = extent.z;
+        candidateCount++;
     }
+    return candidateCount;
+}
 
-    indirectDrawCount = uint32_t(indirectCommands.size());
-
-    objectCount = 0;
-    for (auto indirectCmd: indirectCommands) {
-        objectCount += indirectCmd.instanceCount;
+// drops candidates outside the camera frustum and sorts the rest by draw key, returns the sorted entry count.
+static uint32_t gfx_indexed_indirect_gather() {
+    const uint32_t candidateCount = gfx_indexed_indirect_gather_candidates();
+    uint32_t visibleCount = candidateCount;
+    if (s_gfxIndirect.cpuCulling) {
+        vec4f planes[6];
+        gfx_indexed_indirect_frustum_planes(planes);
+        visibleCount = gfx_frustum_cull_aabbs(planes, s_gfxIndirect.bounds, candidateCount, s_gfxIndirect.visibleCandidates);
+    } else {
+        for (uint32_t i = 0; i < candidateCount; ++i) {
+            s_gfxIndirect.visibleCandidates[i] = i;
+        }
     }
 
-    GfxBuffer stagingBuffer;
-    const VkResult stagingResult = gfx_buffer_create(
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            indirectCommands.size() * sizeof(VkDrawIndexedIndirectCommand),
-            indirectCommands.data()
-    );
-    ASSERT(stagingResult == VK_SUCCESS);
-
-    const VkResult indirectCreateResult = gfx_buffer_create(
-            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            indirectCommandsBuffer,
-            stagingBuffer.size,
-            nullptr
-    );
-    ASSERT(indirectCreateResult == VK_SUCCESS);
-
-    gfx_command_begin_immediate_recording();
-    {
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = stagingBuffer.size;
-        vkCmdCopyBuffer(g_vulkanBackend.immediateCommandBuffer, stagingBuffer.buffer, g_vulkanBackend.indirectCommandsBuffer.buffer, 1, &copyRegion);
+    const vec3f cameraPosition = ((const SceneUBO *) g_vulkanBackend.uniformBuffer.mappedData)->position;
+    for (uint32_t i = 0; i < visibleCount; ++i) {
+        const uint32_t candidateIndex = s_gfxIndirect.visibleCandidates[i];
+        const LitEntity &entity = *db_get_lit_entity(s_gfxIndirect.candidateEntities[candidateIndex]);
+        const vec3f center = {s_gfxIndirect.bounds.centerX[candidateIndex], s_gfxIndirect.bounds.centerY[candidateIndex], s_gfxIndirect.bounds.centerZ[candidateIndex]};
+        s_gfxIndirect.sortKeys[i] = gfx_indexed_indirect_draw_key(GFX_DRAW_KEY_PIPELINE_LIT, entity, glm::length(center - cameraPosition));
+        s_gfxIndirect.sortCandidates[i] = candidateIndex;
     }
-    gfx_command_end_immediate_recording();
+    radix_sort_u64(s_gfxIndirect.sortKeys, s_gfxIndirect.sortCandidates, s_gfxIndirect.scratchKeys, s_gfxIndirect.scratchCandidates, visibleCount);
 
-    vkDestroyBuffer(g_vulkanBackend.device, stagingBuffer.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, stagingBuffer.memory, nullptr);
+    s_gfxIndirect.stats.litEntityCount = candidateCount;
+    s_gfxIndirect.stats.cpuCulledInstanceCount = candidateCount - visibleCount;
+    return visibleCount;
 }
 
-void gfx_cleanup_indexed_indirect_commands() {
-    vkDestroyBuffer(g_vulkanBackend.device, g_vulkanBackend.indirectCommandsBuffer.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, g_vulkanBackend.indirectCommandsBuffer.memory, nullptr);
+// scalar reference of cull_instances.comp, records how many survivors each command may legitimately end up with.
+static void gfx_indexed_indirect_cull_reference(const uint32_t bufferIndex, const GfxCullInstance *cullInstances) {
+    vec4f planes[6];
+    gfx_indexed_indirect_frustum_planes(planes);
+    uint32_t *referenceMin = s_gfxIndirect.referenceMin[bufferIndex];
+    uint32_t *referenceMax = s_gfxIndirect.referenceMax[bufferIndex];
+    memset(referenceMin, 0, sizeof(uint32_t) * s_gfxIndirect.commandCount);
+    memset(referenceMax, 0, sizeof(uint32_t) * s_gfxIndirect.commandCount);
+    for (uint32_t i = 0; i < s_gfxIndirect.instanceCount; ++i) {
+        const GfxCullInstance &cullInstance = cullInstances[i];
+        const mat4f &model = cullInstance.model;
+        const vec4f center = model * vec4f(cullInstance.localSphere.x, cullInstance.localSphere.y, cullInstance.localSphere.z, 1.0f);
+        const float scale = sqrtf(std::max({
+                model[0].x * model[0].x + model[0].y * model[0].y + model[0].z * model[0].z,
+                model[1].x * model[1].x + model[1].y * model[1].y + model[1].z * model[1].z,
+                model[2].x * model[2].x + model[2].y * model[2].y + model[2].z * model[2].z,
+        }));
+        const float radius = cullInstance.localSphere.w * scale;
+
+        bool surelyVisible = true;
+        bool surelyCulled = false;
+        for (uint32_t plane = 0; plane < 6; ++plane) {
+            const float distance = planes[plane].x * center.x + planes[plane].y * center.y + planes[plane].z * center.z + planes[plane].w + radius;
+            const float epsilon = GFX_CULL_VALIDATION_EPSILON * (1.0f + fabsf(distance) + radius);
+            surelyVisible &= distance >= epsilon;
+            surelyCulled |= distance < -epsilon;
+        }
+        referenceMin[cullInstance.commandIndex] += surelyVisible ? 1 : 0;
+        referenceMax[cullInstance.commandIndex] += surelyCulled ? 0 : 1;
+    }
 }
 
-
-void gfx_build_indexed_indirect_instance_data() {
-    constexpr uint32_t objectCount = 1;
-    std::vector<GfxInstanceData> instanceData;
-    instanceData.resize(objectCount);
-
-//    std::default_random_engine rndEngine(benchmark.active ? 0 : (unsigned)time(nullptr));
-//    std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
-//TODO: add to obj struct
-    for (uint32_t i = 0; i < objectCount; i++) {
-        instanceData[i].rot = vec3f(0);
-        instanceData[i].pos = vec3f(-2, 1, -12);
-        instanceData[i].scale = 1.0f;
-        instanceData[i].texIndex = i / OBJECT_INSTANCE_COUNT;
+// counts of the frame last built into this slot, gfx_update has waited on the slot's frame fence so they are final.
+static void gfx_indexed_indirect_read_back(const uint32_t bufferIndex) {
+    const uint32_t commandCount = s_gfxIndirect.slotCommandCounts[bufferIndex];
+    if (commandCount == 0) {
+        s_gfxIndirect.stats.visibleInstanceCount = 0;
+        return;
     }
+    const bool validate = s_gfxIndirect.validateCulling && s_gfxIndirect.referenceReady[bufferIndex];
+    const uint32_t *referenceMin = s_gfxIndirect.referenceMin[bufferIndex];
+    const uint32_t *referenceMax = s_gfxIndirect.referenceMax[bufferIndex];
+    const auto *cullCommands = (const GfxCullCommand *) s_gfxIndirect.cullCommandBuffers[bufferIndex].mappedData;
+    uint32_t visibleInstanceCount = 0;
+    uint32_t mismatchCount = 0;
+    for (uint32_t i = 0; i < commandCount; ++i) {
+        const uint32_t survivors = cullCommands[i].command.instanceCount;
+        visibleInstanceCount += survivors;
+        if (validate && (survivors < referenceMin[i] || survivors > referenceMax[i])) {
+            log_warning(MSG_GFX, "culling validation: command %u kept %u instances, cpu reference expects %u to %u\n",
+                        i, survivors, referenceMin[i], referenceMax[i]);
+            mismatchCount++;
+        }
+    }
+    s_gfxIndirect.stats.visibleInstanceCount = visibleInstanceCount;
+    if (validate) {
+        s_gfxIndirect.stats.validatedFrameCount++;
+        s_gfxIndirect.stats.validationMismatchCount += mismatchCount;
+    }
+}
 
-    GfxBuffer stagingBuffer;
-    gfx_buffer_create(
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            instanceData.size() * sizeof(GfxInstanceData),
-            instanceData.data()
-    );
-
-    gfx_buffer_create(
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            g_vulkanBackend.instanceBuffer,
-            stagingBuffer.size,
-            nullptr
-    );
-
-    gfx_buffer_copy_immediate(stagingBuffer, g_vulkanBackend.instanceBuffer, g_vulkanBackend.queue, nullptr);
-
-    vkDestroyBuffer(g_vulkanBackend.device, stagingBuffer.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, stagingBuffer.memory, nullptr);
+// one instanced draw per batch, commands and instances were both written by the cpu in gfx_indexed_indirect_build.
+static void gfx_indexed_indirect_draw_direct(VkCommandBuffer &cmdBuffer) {
+    const VkDeviceSize offsets[] = {0};
+    const uint32_t bufferIndex = gfx_buffer_index();
+    vkCmdBindVertexBuffers(cmdBuffer, BEET_INSTANCE_BUFFER_BIND_ID, 1, &s_gfxIndirect.directInstanceBuffers[bufferIndex].buffer, offsets);
+
+    const auto *cullCommands = (const GfxCullCommand *) s_gfxIndirect.cullCommandBuffers[bufferIndex].mappedData;
+    for (uint32_t i = 0; i < s_gfxIndirect.meshRunCount; ++i) {
+        const GfxIndirectMeshRun &meshRun = s_gfxIndirect.meshRuns[i];
+        const GfxMesh &mesh = *db_get_mesh(meshRun.meshIndex);
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mesh.vertBuffer, offsets);
+        vkCmdBindIndexBuffer(cmdBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+        for (uint32_t command = meshRun.firstCommand; command < meshRun.firstCommand + meshRun.commandCount; ++command) {
+            const VkDrawIndexedIndirectCommand &drawCommand = cullCommands[command].command;
+            vkCmdDrawIndexed(cmdBuffer, drawCommand.indexCount, drawCommand.instanceCount, drawCommand.firstIndex, drawCommand.vertexOffset, drawCommand.firstInstance);
+        }
+        gfx_add_draw_calls(meshRun.commandCount);
+    }
 }
 
-void gfx_build_indexed_indirect_descriptor_set_layout() {
+static void gfx_indexed_indirect_create_descriptor_set() {
     //=== POOL =====//
     constexpr uint32_t poolSizeCount = 2;
-    VkDescriptorPoolSize poolSizes[poolSizeCount] = {
-            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1},
-            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1},
+    const VkDescriptorPoolSize poolSizes[poolSizeCount] = {
+            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = BEET_BUFFER_COUNT},
+            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 5 * BEET_BUFFER_COUNT},
     };
-
-    VkDescriptorPoolCreateInfo descriptorPoolInfo{
+    const VkDescriptorPoolCreateInfo descriptorPoolInfo{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .maxSets = 2,
+            .maxSets = BEET_BUFFER_COUNT,
             .poolSizeCount = poolSizeCount,
             .pPoolSizes = &poolSizes[0],
     };
-    const VkResult createPoolRes = (vkCreateDescriptorPool(g_vulkanBackend.device, &descriptorPoolInfo, nullptr, &s_gfxIndirect.descriptorPool));
+    const VkResult createPoolRes = vkCreateDescriptorPool(g_vulkanBackend.device, &descriptorPoolInfo, nullptr, &s_gfxIndirect.descriptorPool);
     ASSERT(createPoolRes == VK_SUCCESS);
 
     //=== LAYOUT ===//
-    constexpr uint32_t layoutBindingsCount = 2;
-    VkDescriptorSetLayoutBinding layoutBindings[layoutBindingsCount] = {
-            {VkDescriptorSetLayoutBinding{
-                    .binding = 0,
-                    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                    .descriptorCount = 1,
-                    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-            }},
-            {VkDescriptorSetLayoutBinding{
-                    .binding = 1,
-                    .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    .descriptorCount = 1,
-                    .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-            }},
-    };
-
-    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+    // 0: scene, 1: cull instances, 2: cull commands, 3: visible instances, 4: draw commands, 5: draw counts
+    constexpr uint32_t layoutBindingsCount = 6;
+    VkDescriptorSetLayoutBinding layoutBindings[layoutBindingsCount] = {};
+    for (uint32_t i = 0; i < layoutBindingsCount; ++i) {
+        layoutBindings[i] = {
+                .binding = i,
+                .descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        };
+    }
+    const VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
             .bindingCount = layoutBindingsCount,
             .pBindings = &layoutBindings[0],
     };
     const VkResult descriptorResult = vkCreateDescriptorSetLayout(g_vulkanBackend.device, &descriptorSetLayoutCreateInfo, nullptr, &s_gfxIndirect.descriptorSetLayout);
     ASSERT(descriptorResult == VK_SUCCESS);
+
+    //=== SETS =====//
+    // one set per frame slot, each pointing at the buffers of its slot.
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        const VkDescriptorSetAllocateInfo allocInfo = gfx_descriptor_set_alloc_info(s_gfxIndirect.descriptorPool, &s_gfxIndirect.descriptorSetLayout, 1);
+        const VkResult allocDescRes = vkAllocateDescriptorSets(g_vulkanBackend.device, &allocInfo, &s_gfxIndirect.descriptorSets[i]);
+        ASSERT(allocDescRes == VK_SUCCESS);
+
+        const VkDescriptorSet descriptorSet = s_gfxIndirect.descriptorSets[i];
+        const VkWriteDescriptorSet writeDescriptorSets[layoutBindingsCount] = {
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &g_vulkanBackend.uniformBuffer.descriptor, 1),
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, &s_gfxIndirect.cullInstanceBuffers[i].descriptor, 1),
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &s_gfxIndirect.cullCommandBuffers[i].descriptor, 1),
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3, &g_vulkanBackend.instanceBuffers[i].descriptor, 1),
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4, &g_vulkanBackend.indirectCommandsBuffers[i].descriptor, 1),
+                gfx_descriptor_set_write(descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5, &g_vulkanBackend.indirectCountBuffers[i].descriptor, 1),
+        };
+        vkUpdateDescriptorSets(g_vulkanBackend.device, layoutBindingsCount, &writeDescriptorSets[0], 0, nullptr);
+    }
+}
+
+static void gfx_indexed_indirect_create_cull_pipeline(const char *shaderPath, VkPipeline &outPipeline) {
+    const VkPipelineShaderStageCreateInfo shaderStage = gfx_load_shader(shaderPath, VK_SHADER_STAGE_COMPUTE_BIT);
+    const VkComputePipelineCreateInfo pipelineCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .stage = shaderStage,
+            .layout = s_gfxIndirect.pipelineLayout,
+    };
+    const VkResult pipelineRes = vkCreateComputePipelines(g_vulkanBackend.device, g_vulkanBackend.pipelineCache, 1, &pipelineCreateInfo, nullptr, &outPipeline);
+    ASSERT_MSG(pipelineRes == VK_SUCCESS, "Err: failed to create compute pipeline %s", shaderPath);
+    vkDestroyShaderModule(g_vulkanBackend.device, shaderStage.module, nullptr);
+}
+
+static void gfx_indexed_indirect_create_cull_pipelines() {
+    const VkPushConstantRange pushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = sizeof(GfxCullPushConstants),
+    };
+    const VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &s_gfxIndirect.descriptorSetLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange,
+    };
+    const VkResult pipelineLayoutRes = vkCreatePipelineLayout(g_vulkanBackend.device, &pipelineLayoutCreateInfo, nullptr, &s_gfxIndirect.pipelineLayout);
+    ASSERT(pipelineLayoutRes == VK_SUCCESS);
+
+    gfx_indexed_indirect_create_cull_pipeline("assets/shaders/cull/cull_instances.comp", s_gfxIndirect.cullInstancesPipeline);
+    gfx_indexed_indirect_create_cull_pipeline("assets/shaders/cull/cull_commands.comp", s_gfxIndirect.cullCommandsPipeline);
+}
+
+// every buffer here is a per frame slot copy created at startup and released at shutdown, so they share linear blocks
+// rather than carving up the free list blocks long lived resources come from.
+static void gfx_indexed_indirect_create_buffer(const VkBufferUsageFlags usageFlags, const VkMemoryPropertyFlags memoryPropertyFlags, const VkDeviceSize size, GfxBuffer &outBuffer) {
+    const VkResult createResult = gfx_buffer_create(usageFlags, memoryPropertyFlags, outBuffer, size, nullptr, GfxMemoryStrategy::Linear);
+    ASSERT(createResult == VK_SUCCESS);
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void gfx_indexed_indirect_build() {
+    BEET_PROFILE_SCOPE("gfx_indexed_indirect_build");
+    const uint32_t bufferIndex = gfx_buffer_index();
+    gfx_indexed_indirect_read_back(bufferIndex);
+    const uint32_t entryCount = gfx_indexed_indirect_gather();
+
+    // host visible and rewritten in place, nothing in flight reads this slot once its frame fence has been waited on.
+    auto *cullInstances = (GfxCullInstance *) s_gfxIndirect.cullInstanceBuffers[bufferIndex].mappedData;
+    auto *cullCommands = (GfxCullCommand *) s_gfxIndirect.cullCommandBuffers[bufferIndex].mappedData;
+    auto *directInstances = (GfxInstanceData *) s_gfxIndirect.directInstanceBuffers[bufferIndex].mappedData;
+
+    uint32_t commandCount = 0;
+    uint32_t redundantBindsAvoided = 0;
+    s_gfxIndirect.meshRunCount = 0;
+    GfxIndirectMeshRun *meshRun = nullptr;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        const uint64_t key = s_gfxIndirect.sortKeys[i];
+        const uint32_t candidateIndex = s_gfxIndirect.sortCandidates[i];
+        const LitEntity &entity = *db_get_lit_entity(s_gfxIndirect.candidateEntities[candidateIndex]);
+        const LitMaterial &material = *db_get_lit_material(entity.materialIndex);
+        const GfxMesh &mesh = *db_get_mesh(entity.meshIndex);
+
+        // only what differs from the previous key is recorded. A per entity loop would bind pipeline, descriptor sets,
+        // vertex and index buffer for every draw, count the ones the sorted order made unnecessary.
+        // the first entry compares against its own complement, so it always opens a mesh run and a batch.
+        const uint64_t previousKey = i > 0 ? s_gfxIndirect.sortKeys[i - 1] : ~key;
+        if (i > 0) {
+            const bool samePipeline = (key >> GFX_DRAW_KEY_PIPELINE_SHIFT) == (previousKey >> GFX_DRAW_KEY_PIPELINE_SHIFT);
+            const bool sameGeometry = gfx_indexed_indirect_draw_key_geometry(key) == gfx_indexed_indirect_draw_key_geometry(previousKey);
+            redundantBindsAvoided += (samePipeline ? 2 : 0) + (sameGeometry ? 2 : 0);
+        }
+        if (gfx_indexed_indirect_draw_key_geometry(key) != gfx_indexed_indirect_draw_key_geometry(previousKey)) {
+            s_gfxIndirect.meshRuns[s_gfxIndirect.meshRunCount++] = {entity.meshIndex, commandCount, 0};
+            meshRun = &s_gfxIndirect.meshRuns[s_gfxIndirect.meshRunCount - 1];
+        }
+        if (gfx_indexed_indirect_draw_key_batch(key) != gfx_indexed_indirect_draw_key_batch(previousKey)) {
+            // every instance of the batch gets a slot from firstInstance on, culling fills them from the front.
+            cullCommands[commandCount] = {
+                    .command = {
+                            .indexCount = mesh.indexCount,
+                            .instanceCount = 0,
+                            .firstIndex = 0,
+                            .vertexOffset = 0,
+                            .firstInstance = i,
+                    },
+                    .meshRunIndex = s_gfxIndirect.meshRunCount - 1,
+                    .meshRunFirstCommand = meshRun->firstCommand,
+            };
+            meshRun->commandCount++;
+            commandCount++;
+            gfx_residency_touch(material.albedoIndex);
+        }
+
+        if (s_gfxIndirect.directInstancing) {
+            directInstances[i] = {
+                    .model = s_gfxIndirect.candidateModels[candidateIndex],
+                    .albedoIndex = material.albedoIndex,
+            };
+            cullCommands[commandCount - 1].command.instanceCount++;
+        }
+
+        cullInstances[i] = {
+                .model = s_gfxIndirect.candidateModels[candidateIndex],
+                .localSphere = vec4f(mesh.boundsCenter, mesh.boundsRadius),
+                .albedoIndex = material.albedoIndex,
+                .commandIndex = commandCount - 1,
+        };
+    }
+    memset(g_vulkanBackend.indirectCountBuffers[bufferIndex].mappedData, 0, sizeof(uint32_t) * s_gfxIndirect.meshRunCount);
+
+    s_gfxIndirect.instanceCount = entryCount;
+    s_gfxIndirect.commandCount = commandCount;
+    s_gfxIndirect.slotCommandCounts[bufferIndex] = commandCount;
+    g_vulkanBackend.indirectDrawCount = commandCount;
+    // direct instancing has no gpu pass to validate, the counts above are already final.
+    s_gfxIndirect.referenceReady[bufferIndex] = s_gfxIndirect.validateCulling && !s_gfxIndirect.directInstancing;
+    if (s_gfxIndirect.referenceReady[bufferIndex]) {
+        gfx_indexed_indirect_cull_reference(bufferIndex, cullInstances);
+    }
+
+    s_gfxIndirect.stats.instanceCount = entryCount;
+    s_gfxIndirect.stats.commandCount = commandCount;
+    s_gfxIndirect.stats.redundantBindsAvoided = redundantBindsAvoided;
+    const bool drawPerMeshRun = !s_gfxIndirect.directInstancing && (s_gfxIndirect.multiDrawSupported || g_vulkanBackend.drawIndirectCountSupported);
+    s_gfxIndirect.stats.drawCallCount = drawPerMeshRun ? s_gfxIndirect.meshRunCount : commandCount;
+    s_gfxIndirect.stats.directInstancing = s_gfxIndirect.directInstancing;
+}
+
+void gfx_indexed_indirect_cull(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_indexed_indirect_cull");
+    if (s_gfxIndirect.commandCount == 0 || s_gfxIndirect.directInstancing) {
+        return;
+    }
+    const GfxCullPushConstants pushConstants = {
+            .instanceCount = s_gfxIndirect.instanceCount,
+            .commandCount = s_gfxIndirect.commandCount,
+            .compact = g_vulkanBackend.drawIndirectCountSupported ? 1u : 0u,
+    };
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, s_gfxIndirect.pipelineLayout, 0, 1, &s_gfxIndirect.descriptorSets[gfx_buffer_index()], 0, nullptr);
+    vkCmdPushConstants(cmdBuffer, s_gfxIndirect.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GfxCullPushConstants), &pushConstants);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, s_gfxIndirect.cullInstancesPipeline);
+    vkCmdDispatch(cmdBuffer, (s_gfxIndirect.instanceCount + GFX_CULL_WORKGROUP_SIZE - 1) / GFX_CULL_WORKGROUP_SIZE, 1, 1);
+
+    // survivor counts have to be final before commands are compacted.
+    const VkMemoryBarrier countsBarrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &countsBarrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, s_gfxIndirect.cullCommandsPipeline);
+    vkCmdDispatch(cmdBuffer, (s_gfxIndirect.commandCount + GFX_CULL_WORKGROUP_SIZE - 1) / GFX_CULL_WORKGROUP_SIZE, 1, 1);
+
+    // the host reads the survivor counts back once the frame has completed.
+    const VkMemoryBarrier drawBarrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
 }
 
-void gfx_cleanup_indexed_indirect_descriptor_set_layout() {
+void gfx_indexed_indirect_draw(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_indexed_indirect_draw");
+    if (s_gfxIndirect.commandCount == 0) {
+        return;
+    }
+    if (s_gfxIndirect.directInstancing) {
+        gfx_indexed_indirect_draw_direct(cmdBuffer);
+        return;
+    }
+    const VkDeviceSize offsets[] = {0};
+    const uint32_t bufferIndex = gfx_buffer_index();
+    vkCmdBindVertexBuffers(cmdBuffer, BEET_INSTANCE_BUFFER_BIND_ID, 1, &g_vulkanBackend.instanceBuffers[bufferIndex].buffer, offsets);
+    const VkBuffer indirectCommandsBuffer = g_vulkanBackend.indirectCommandsBuffers[bufferIndex].buffer;
+
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    for (uint32_t i = 0; i < s_gfxIndirect.meshRunCount; ++i) {
+        const GfxIndirectMeshRun &meshRun = s_gfxIndirect.meshRuns[i];
+        const GfxMesh &mesh = *db_get_mesh(meshRun.meshIndex);
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mesh.vertBuffer, offsets);
+        vkCmdBindIndexBuffer(cmdBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+        const VkDeviceSize commandOffset = meshRun.firstCommand * stride;
+        if (g_vulkanBackend.drawIndirectCountSupported) {
+            vkCmdDrawIndexedIndirectCount(cmdBuffer, indirectCommandsBuffer, commandOffset,
+                                          g_vulkanBackend.indirectCountBuffers[bufferIndex].buffer, i * sizeof(uint32_t), meshRun.commandCount, stride);
+        } else if (s_gfxIndirect.multiDrawSupported) {
+            // commands were not compacted, culled ones are still recorded but draw zero instances.
+            vkCmdDrawIndexedIndirect(cmdBuffer, indirectCommandsBuffer, commandOffset, meshRun.commandCount, stride);
+        } else {
+            // without multiDrawIndirect the draw count has to be 0 or 1.
+            for (uint32_t command = 0; command < meshRun.commandCount; ++command) {
+                vkCmdDrawIndexedIndirect(cmdBuffer, indirectCommandsBuffer, commandOffset + command * stride, 1, stride);
+            }
+        }
+        gfx_add_draw_calls(meshRun.commandCount);
+    }
+}
+
+void gfx_indexed_indirect_set_direct_instancing(const bool enabled) {
+    s_gfxIndirect.directInstancing = enabled || s_gfxIndirect.directInstancingRequired;
+    memset(s_gfxIndirect.referenceReady, 0, sizeof(s_gfxIndirect.referenceReady));
+}
+
+void gfx_indexed_indirect_set_cpu_culling(const bool enabled) {
+    s_gfxIndirect.cpuCulling = enabled;
+}
+
+void gfx_indexed_indirect_set_culling_validation(const bool enabled) {
+    s_gfxIndirect.validateCulling = enabled;
+    // frames built before validation was enabled have no reference to compare against.
+    memset(s_gfxIndirect.referenceReady, 0, sizeof(s_gfxIndirect.referenceReady));
+}
+
+GfxIndirectStats gfx_indexed_indirect_stats() {
+    return s_gfxIndirect.stats;
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_indexed_indirect() {
+    // instances are read through a per instance vertex binding starting at each command's firstInstance.
+    s_gfxIndirect.directInstancingRequired = !g_vulkanBackend.deviceFeatures.drawIndirectFirstInstance;
+    s_gfxIndirect.directInstancing = s_gfxIndirect.directInstancingRequired;
+    if (s_gfxIndirect.directInstancingRequired) {
+        log_warning(MSG_GFX, "drawIndirectFirstInstance not supported, lit entities fall back to direct instanced draws without gpu culling\n");
+    }
+    s_gfxIndirect.multiDrawSupported = g_vulkanBackend.deviceFeatures.multiDrawIndirect;
+
+    constexpr VkMemoryPropertyFlags hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    // the culling pass of one frame writes these while the previous frame may still be drawing from them.
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible,
+                                           GFX_INDIRECT_MAX_INSTANCES * sizeof(GfxCullInstance), s_gfxIndirect.cullInstanceBuffers[i]);
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible,
+                                           GFX_INDIRECT_MAX_COMMANDS * sizeof(GfxCullCommand), s_gfxIndirect.cullCommandBuffers[i]);
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, hostVisible,
+                                           GFX_INDIRECT_MAX_INSTANCES * sizeof(GfxInstanceData), s_gfxIndirect.directInstanceBuffers[i]);
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible,
+                                           GFX_INDIRECT_MAX_COMMANDS * sizeof(uint32_t), g_vulkanBackend.indirectCountBuffers[i]);
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                           GFX_INDIRECT_MAX_INSTANCES * sizeof(GfxInstanceData), g_vulkanBackend.instanceBuffers[i]);
+        gfx_indexed_indirect_create_buffer(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                           GFX_INDIRECT_MAX_COMMANDS * sizeof(VkDrawIndexedIndirectCommand), g_vulkanBackend.indirectCommandsBuffers[i]);
+    }
+
+    // simd aligned so every batch load of gfx_frustum_cull_aabbs starts on a vector boundary.
+    float **boundsArrays[] = {&s_gfxIndirect.bounds.centerX, &s_gfxIndirect.bounds.centerY, &s_gfxIndirect.bounds.centerZ,
+                              &s_gfxIndirect.bounds.extentX, &s_gfxIndirect.bounds.extentY, &s_gfxIndirect.bounds.extentZ};
+    for (float **boundsArray: boundsArrays) {
+        *boundsArray = mem_alloc_array<float>(GFX_INDIRECT_MAX_INSTANCES, MSG_GFX, MEM_SIMD_ALIGNMENT);
+    }
+
+    gfx_indexed_indirect_create_descriptor_set();
+    gfx_indexed_indirect_create_cull_pipelines();
+}
+
+void gfx_cleanup_indexed_indirect() {
+    vkDestroyPipeline(g_vulkanBackend.device, s_gfxIndirect.cullCommandsPipeline, nullptr);
+    vkDestroyPipeline(g_vulkanBackend.device, s_gfxIndirect.cullInstancesPipeline, nullptr);
     vkDestroyPipelineLayout(g_vulkanBackend.device, s_gfxIndirect.pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(g_vulkanBackend.device, s_gfxIndirect.descriptorPool, nullptr);
     vkDestroyDescriptorSetLayout(g_vulkanBackend.device, s_gfxIndirect.descriptorSetLayout, nullptr);
+
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        gfx_buffer_cleanup(g_vulkanBackend.indirectCommandsBuffers[i]);
+        gfx_buffer_cleanup(g_vulkanBackend.instanceBuffers[i]);
+        gfx_buffer_cleanup(g_vulkanBackend.indirectCountBuffers[i]);
+        gfx_buffer_cleanup(s_gfxIndirect.directInstanceBuffers[i]);
+        gfx_buffer_cleanup(s_gfxIndirect.cullCommandBuffers[i]);
+        gfx_buffer_cleanup(s_gfxIndirect.cullInstanceBuffers[i]);
+        s_gfxIndirect.descriptorSets[i] = VK_NULL_HANDLE;
+        s_gfxIndirect.slotCommandCounts[i] = 0;
+        s_gfxIndirect.referenceReady[i] = false;
+    }
+    float *boundsArrays[] = {s_gfxIndirect.bounds.centerX, s_gfxIndirect.bounds.centerY, s_gfxIndirect.bounds.centerZ,
+                             s_gfxIndirect.bounds.extentX, s_gfxIndirect.bounds.extentY, s_gfxIndirect.bounds.extentZ};
+    for (float *boundsArray: boundsArrays) {
+        mem_aligned_free(boundsArray);
+    }
+    s_gfxIndirect.bounds = {};
+    g_vulkanBackend.indirectDrawCount = 0;
+    s_gfxIndirect.meshRunCount = 0;
+    s_gfxIndirect.instanceCount = 0;
+    s_gfxIndirect.commandCount = 0;
+    s_gfxIndirect.cpuCulling = true;
+    s_gfxIndirect.directInstancing = false;
+    s_gfxIndirect.directInstancingRequired = false;
+    s_gfxIndirect.validateCulling = false;
+    s_gfxIndirect.stats = {};
 }
 //======================================================================================================================
-
@@ -7,6 +7,7 @@
 #include <beet_gfx/gfx_samplers.h>
 
 #include <beet_shared/assert.h>
+#include <beet_shared/profiler.h>
 
 #include <beet_math/quat.h>
 
@@ -63,16 +64,12 @@ static void gfx_create_lines_uniform_buffers() {
                 (sizeof(LinePoint3D) * MAX_POINT_SIZE),
                 nullptr);
         ASSERT(uniformResult == VK_SUCCESS);
-
-        const VkResult mapResult = vkMapMemory(g_vulkanBackend.device, s_gfxLine.lineUniformBuffers[i].memory, 0, VK_WHOLE_SIZE, 0, &s_gfxLine.lineUniformBuffers[i].mappedData);
-        ASSERT(mapResult == VK_SUCCESS);
     }
 }
 
 static void gfx_cleanup_lines_uniform_buffers() {
     for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
-        vkDestroyBuffer(g_vulkanBackend.device, s_gfxLine.lineUniformBuffers[i].buffer, nullptr);
-        vkFreeMemory(g_vulkanBackend.device, s_gfxLine.lineUniformBuffers[i].memory, nullptr);
+        gfx_buffer_cleanup(s_gfxLine.lineUniformBuffers[i]);
     }
 }
 
@@ -207,6 +204,7 @@ static bool gfx_create_line_pipelines(VkPipeline &outLinePipeline) {
 
 //===API================================================================================================================
 void gfx_line_draw(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_line_draw");
     gfx_line_update_material_descriptor(s_gfxLine.descriptorSets[gfx_buffer_index()]);
     vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_gfxLine.pipeline);
     vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_gfxLine.pipelineLayout, 0, 1, &s_gfxLine.descriptorSets[gfx_buffer_index()], 0, nullptr);
@@ -215,6 +213,7 @@ void gfx_line_draw(VkCommandBuffer &cmdBuffer) {
         const uint32_t numberOfPoints = (lineEntity.lineRangeEnd - lineEntity.lineRangeStart);
         vkCmdSetLineWidth(cmdBuffer, lineEntity.lineWidth);
         vkCmdDraw(cmdBuffer, numberOfPoints, 1, lineEntity.lineRangeStart, 0);
+        gfx_add_draw_calls(1);
     }
     s_pointCount = {0};
     s_lineEntityCount = {0};
@@ -4,23 +4,20 @@
 #include <beet_gfx/gfx_shader.h>
 #include <beet_gfx/gfx_pipeline.h>
 #include <beet_gfx/db_asset.h>
+#include <beet_gfx/gfx_interface.h>
+#include <beet_gfx/gfx_bindless.h>
+#include <beet_gfx/gfx_indexed_indirect.h>
 
 #include <beet_shared/assert.h>
-#include <beet_shared/beet_types.h>
-
-#include <beet_math/quat.h>
-#include <beet_math/transform.h>
+#include <beet_shared/profiler.h>
 
 #include <vulkan/vulkan_core.h>
 
 //===INTERNAL_STRUCTS===================================================================================================
-struct LitPushConstantBuffer {
-    mat4f model;
-};
-
 static struct VulkanLit {
     VkDescriptorSetLayout descriptorSetLayout = {VK_NULL_HANDLE};
     VkDescriptorPool descriptorPool = {VK_NULL_HANDLE};
+    VkDescriptorSet sceneDescriptorSet = {VK_NULL_HANDLE}; // set 0, set 1 is the bindless texture array
     VkPipelineLayout pipelineLayout = {VK_NULL_HANDLE};
     VkPipeline pipeline = {VK_NULL_HANDLE};
 } g_gfxLit;
@@ -32,15 +29,14 @@ extern TargetVulkanFormats g_vulkanTargetFormats;
 //===INTERNAL_FUNCTIONS=================================================================================================
 static void gfx_create_lit_descriptor_set_layout() {
     //=== POOL =====//
-    constexpr uint32_t poolSizeCount = 2;
+    constexpr uint32_t poolSizeCount = 1;
     VkDescriptorPoolSize poolSizes[poolSizeCount] = {
             VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1},
-            VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1},
     };
 
     VkDescriptorPoolCreateInfo descriptorPoolInfo{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .maxSets = 2,
+            .maxSets = 1,
             .poolSizeCount = poolSizeCount,
             .pPoolSizes = &poolSizes[0],
     };
@@ -48,7 +44,7 @@ static void gfx_create_lit_descriptor_set_layout() {
     ASSERT(createPoolRes == VK_SUCCESS);
 
     //=== LAYOUT ===//
-    constexpr uint32_t layoutBindingsCount = 2;
+    constexpr uint32_t layoutBindingsCount = 1;
     VkDescriptorSetLayoutBinding layoutBindings[layoutBindingsCount] = {
             {VkDescriptorSetLayoutBinding{
                     .binding = 0,
@@ -56,12 +52,6 @@ static void gfx_create_lit_descriptor_set_layout() {
                     .descriptorCount = 1,
                     .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
             }},
-            {VkDescriptorSetLayoutBinding{
-                    .binding = 1,
-                    .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    .descriptorCount = 1,
-                    .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-            }},
     };
 
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
@@ -73,20 +63,22 @@ static void gfx_create_lit_descriptor_set_layout() {
     ASSERT(descriptorResult == VK_SUCCESS);
 }
 
-static void gfx_create_lit_pipeline_layout() {
-    constexpr static uint32_t pushConstantRangeCount = 1;
-    VkPushConstantRange pushConstantRange{
-            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-            .offset = 0,
-            .size = sizeof(LitPushConstantBuffer),
-    };
+static void gfx_create_lit_scene_descriptor_set() {
+    VkDescriptorSetAllocateInfo allocInfo = gfx_descriptor_set_alloc_info(g_gfxLit.descriptorPool, &g_gfxLit.descriptorSetLayout, 1);
+    const VkResult allocDescRes = vkAllocateDescriptorSets(g_vulkanBackend.device, &allocInfo, &g_gfxLit.sceneDescriptorSet);
+    ASSERT(allocDescRes == VK_SUCCESS);
 
+    const VkWriteDescriptorSet writeDescriptorSet = gfx_descriptor_set_write(g_gfxLit.sceneDescriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &g_vulkanBackend.uniformBuffer.descriptor, 1);
+    vkUpdateDescriptorSets(g_vulkanBackend.device, 1, &writeDescriptorSet, 0, nullptr);
+}
+
+static void gfx_create_lit_pipeline_layout() {
+    constexpr uint32_t setLayoutCount = 2;
+    const VkDescriptorSetLayout setLayouts[setLayoutCount] = {g_gfxLit.descriptorSetLayout, gfx_bindless_layout()};
     VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount = 1,
-            .pSetLayouts = &g_gfxLit.descriptorSetLayout,
-            .pushConstantRangeCount = pushConstantRangeCount,
-            .pPushConstantRanges = &pushConstantRange,
+            .setLayoutCount = setLayoutCount,
+            .pSetLayouts = &setLayouts[0],
     };
     const VkResult pipelineLayoutRes = vkCreatePipelineLayout(g_vulkanBackend.device, &pipelineLayoutCreateInfo, nullptr, &g_gfxLit.pipelineLayout);
     ASSERT(pipelineLayoutRes == VK_SUCCESS);
@@ -132,17 +124,25 @@ static bool gfx_create_lit_pipelines(VkPipeline &outLitPipeline) {
     };
     pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo;
 
-    const uint32_t bindingDescriptionsSize = 1;
+    const uint32_t bindingDescriptionsSize = 2;
     VkVertexInputBindingDescription bindingDescriptions[bindingDescriptionsSize] = {
             gfx_vertex_input_binding_desc(0, sizeof(GfxVertex), VK_VERTEX_INPUT_RATE_VERTEX),
+            gfx_vertex_input_binding_desc(BEET_INSTANCE_BUFFER_BIND_ID, sizeof(GfxInstanceData), VK_VERTEX_INPUT_RATE_INSTANCE),
     };
 
-    constexpr uint32_t attributeDescriptionsSize = 4;
+    constexpr uint32_t attributeDescriptionsSize = 9;
+    constexpr uint32_t columnSize = sizeof(vec4f);
     VkVertexInputAttributeDescription attributeDescriptions[attributeDescriptionsSize] = {
             gfx_vertex_input_attribute_desc(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, pos)),    // 0: Position
             gfx_vertex_input_attribute_desc(0, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, normal)), // 1: Normal
             gfx_vertex_input_attribute_desc(0, 2, VK_FORMAT_R32G32_SFLOAT, offsetof(GfxVertex, uv)),        // 2: Texture coordinates
             gfx_vertex_input_attribute_desc(0, 3, VK_FORMAT_R32G32B32_SFLOAT, offsetof(GfxVertex, color)),  // 3: Color
+
+            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 4, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GfxInstanceData, model) + columnSize * 0), // 4-7: Model matrix columns
+            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 5, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GfxInstanceData, model) + columnSize * 1),
+            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 6, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GfxInstanceData, model) + columnSize * 2),
+            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 7, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GfxInstanceData, model) + columnSize * 3),
+            gfx_vertex_input_attribute_desc(BEET_INSTANCE_BUFFER_BIND_ID, 8, VK_FORMAT_R32_UINT, offsetof(GfxInstanceData, albedoIndex)),     // 8: Bindless albedo slot
     };
 
     VkPipelineVertexInputStateCreateInfo inputState = {
@@ -167,45 +167,13 @@ static bool gfx_create_lit_pipelines(VkPipeline &outLitPipeline) {
 
 //===API================================================================================================================
 void gfx_lit_draw(VkCommandBuffer &cmdBuffer) {
-    const uint32_t litEntityCount = db_get_lit_entity_count();
+    BEET_PROFILE_SCOPE("gfx_lit_draw");
     vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_gfxLit.pipeline);
-    for (uint32_t i = 0; i < litEntityCount; ++i) {
-        const LitEntity &entity = *db_get_lit_entity(i);
-        const LitMaterial &material = *db_get_lit_material(entity.materialIndex);
-        const VkDescriptorSet &descriptorSet = *db_get_descriptor_set(material.descriptorSetIndex);
-        const Transform &transform = *db_get_transform(entity.transformIndex);
-        const GfxMesh &mesh = *db_get_mesh(entity.meshIndex);
-        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_gfxLit.pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
-
-
-        const mat4f model = transform_model_matrix(transform);
-        const LitPushConstantBuffer pushConstantBuffer = {model};
-        vkCmdPushConstants(cmdBuffer, g_gfxLit.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(LitPushConstantBuffer), &pushConstantBuffer);
-
-        const VkBuffer vertexBuffers[] = {mesh.vertBuffer};
-        const VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
-
-        vkCmdBindIndexBuffer(cmdBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(cmdBuffer, mesh.indexCount, 1, 0, 0, 0);
-    }
-}
-
-void gfx_lit_update_material_descriptor(VkDescriptorSet &outDescriptorSet, const GfxTexture &albedoTexture) {
-    VkDescriptorSetAllocateInfo allocInfo = gfx_descriptor_set_alloc_info(g_gfxLit.descriptorPool, &g_gfxLit.descriptorSetLayout, 1);
-    const VkResult allocDescRes = vkAllocateDescriptorSets(g_vulkanBackend.device, &allocInfo, &outDescriptorSet);
-    ASSERT(allocDescRes == VK_SUCCESS);
-    // TODO:    Update this to a buffer of textures so we can modify the contents without needing to rebuild descriptors
-    //          runtime packages will not need this as the content won't change.
-
-    constexpr uint32_t descriptorSetSize = 2;
-    const VkWriteDescriptorSet writeDescriptorSets[descriptorSetSize] = {
-            // Binding 0: Vertex shader uniform buffer
-            // Binding 1: albedoTexture // TODO: Add a per package loaded texture array
-            gfx_descriptor_set_write(outDescriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &g_vulkanBackend.uniformBuffer.descriptor, 1),
-            gfx_descriptor_set_write(outDescriptorSet, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &albedoTexture.descriptor, 1)
-    };
-    vkUpdateDescriptorSets(g_vulkanBackend.device, descriptorSetSize, &writeDescriptorSets[0], 0, nullptr);
+    // materials only differ by texture index, both sets are bound once for every lit draw.
+    constexpr uint32_t descriptorSetCount = 2;
+    const VkDescriptorSet descriptorSets[descriptorSetCount] = {g_gfxLit.sceneDescriptorSet, gfx_bindless_set()};
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_gfxLit.pipelineLayout, 0, descriptorSetCount, &descriptorSets[0], 0, nullptr);
+    gfx_indexed_indirect_draw(cmdBuffer);
 }
 
 bool gfx_rebuild_lit_pipeline() {
@@ -223,6 +191,7 @@ bool gfx_rebuild_lit_pipeline() {
 //===INIT_&_SHUTDOWN====================================================================================================
 void gfx_create_lit() {
     gfx_create_lit_descriptor_set_layout();
+    gfx_create_lit_scene_descriptor_set();
     gfx_create_lit_pipeline_layout();
     const bool pipelineResult = gfx_create_lit_pipelines(g_gfxLit.pipeline);
     ASSERT(pipelineResult);
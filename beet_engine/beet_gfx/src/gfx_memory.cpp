@@ -0,0 +1,397 @@
+#include <beet_gfx/gfx_memory.h>
+#include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_utils.h>
+#include <beet_gfx/gfx_residency.h>
+
+#include <beet_shared/assert.h>
+#include <beet_shared/log.h>
+#include <beet_shared/memory.h>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstring>
+
+//===INTERNAL_STRUCTS===================================================================================================
+struct GfxMemoryRange {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct GfxMemoryBlock {
+    VkDeviceMemory memory = {VK_NULL_HANDLE};
+    VkDeviceSize size = {0};
+    uint8_t *mapped = {nullptr};
+    uint32_t memoryTypeIndex = {UINT32_MAX};
+    VkMemoryAllocateFlags allocateFlags = {0};
+    GfxMemoryStrategy strategy = {GfxMemoryStrategy::FreeList};
+    GfxMemoryResource resource = {GfxMemoryResource::Linear};
+    bool dedicated = {false};
+
+    uint32_t allocationCount = {0};
+    VkDeviceSize usedBytes = {0};
+
+    // linear blocks bump this and rewind to 0 once allocationCount drops to 0.
+    VkDeviceSize linearHead = {0};
+
+    // free list blocks keep their free ranges sorted by offset so neighbours can be merged on free.
+    GfxMemoryRange *freeRanges = {nullptr};
+    uint32_t freeRangeCount = {0};
+    uint32_t freeRangeCapacity = {0};
+};
+
+static struct GfxMemory {
+    GfxMemoryBlock blocks[GFX_MEMORY_MAX_BLOCKS] = {};
+    uint32_t blockSlotCount = {0}; // slots past this have never been used, released slots below it are reused
+    VkDeviceSize bufferImageGranularity = {1};
+} s_gfxMemory;
+
+extern VulkanBackend g_vulkanBackend;
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static VkDeviceSize gfx_memory_align(const VkDeviceSize value, const VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static void gfx_memory_insert_range(GfxMemoryBlock &block, const uint32_t index, const GfxMemoryRange range) {
+    if (block.freeRangeCount == block.freeRangeCapacity) {
+        const uint32_t newCapacity = block.freeRangeCapacity ? block.freeRangeCapacity * 2 : 16;
+        GfxMemoryRange *newRanges = (GfxMemoryRange *) mem_malloc(sizeof(GfxMemoryRange) * newCapacity, MSG_GFX);
+        if (block.freeRanges) {
+            memcpy(newRanges, block.freeRanges, sizeof(GfxMemoryRange) * block.freeRangeCount);
+            mem_free(block.freeRanges);
+        }
+        block.freeRanges = newRanges;
+        block.freeRangeCapacity = newCapacity;
+    }
+    memmove(&block.freeRanges[index + 1], &block.freeRanges[index], sizeof(GfxMemoryRange) * (block.freeRangeCount - index));
+    block.freeRanges[index] = range;
+    block.freeRangeCount++;
+}
+
+static void gfx_memory_remove_range(GfxMemoryBlock &block, const uint32_t index) {
+    memmove(&block.freeRanges[index], &block.freeRanges[index + 1], sizeof(GfxMemoryRange) * (block.freeRangeCount - index - 1));
+    block.freeRangeCount--;
+}
+
+// first fit, the alignment padding in front of the allocation stays on the free list.
+static bool gfx_memory_free_list_alloc(GfxMemoryBlock &block, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize &outOffset) {
+    for (uint32_t i = 0; i < block.freeRangeCount; ++i) {
+        const GfxMemoryRange range = block.freeRanges[i];
+        const VkDeviceSize offset = gfx_memory_align(range.offset, alignment);
+        const VkDeviceSize rangeEnd = range.offset + range.size;
+        if (offset + size > rangeEnd) {
+            continue;
+        }
+        gfx_memory_remove_range(block, i);
+        uint32_t insertIndex = i;
+        if (offset > range.offset) {
+            gfx_memory_insert_range(block, insertIndex++, {range.offset, offset - range.offset});
+        }
+        if (offset + size < rangeEnd) {
+            gfx_memory_insert_range(block, insertIndex, {offset + size, rangeEnd - (offset + size)});
+        }
+        outOffset = offset;
+        return true;
+    }
+    return false;
+}
+
+static void gfx_memory_free_list_free(GfxMemoryBlock &block, const VkDeviceSize offset, const VkDeviceSize size) {
+    uint32_t index = 0;
+    while (index < block.freeRangeCount && block.freeRanges[index].offset < offset) {
+        ++index;
+    }
+    const bool mergePrev = index > 0 && block.freeRanges[index - 1].offset + block.freeRanges[index - 1].size == offset;
+    const bool mergeNext = index < block.freeRangeCount && offset + size == block.freeRanges[index].offset;
+    if (mergePrev && mergeNext) {
+        block.freeRanges[index - 1].size += size + block.freeRanges[index].size;
+        gfx_memory_remove_range(block, index);
+    } else if (mergePrev) {
+        block.freeRanges[index - 1].size += size;
+    } else if (mergeNext) {
+        block.freeRanges[index].offset = offset;
+        block.freeRanges[index].size += size;
+    } else {
+        gfx_memory_insert_range(block, index, {offset, size});
+    }
+}
+
+static bool gfx_memory_block_alloc(GfxMemoryBlock &block, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize &outOffset) {
+    if (block.strategy == GfxMemoryStrategy::Linear) {
+        const VkDeviceSize offset = gfx_memory_align(block.linearHead, alignment);
+        if (offset + size > block.size) {
+            return false;
+        }
+        block.linearHead = offset + size;
+        outOffset = offset;
+        return true;
+    }
+    return gfx_memory_free_list_alloc(block, size, alignment, outOffset);
+}
+
+// blocks are sized down on small heaps (e.g. the 256MB device local + host visible window) so one block can't eat it.
+static VkDeviceSize gfx_memory_block_size(const uint32_t memoryTypeIndex) {
+    const uint32_t heapIndex = g_vulkanBackend.deviceMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    const VkDeviceSize heapSize = g_vulkanBackend.deviceMemoryProperties.memoryHeaps[heapIndex].size;
+    return heapSize / 8 < GFX_MEMORY_BLOCK_SIZE ? heapSize / 8 : GFX_MEMORY_BLOCK_SIZE;
+}
+
+static void gfx_memory_release_block(const uint32_t blockIndex) {
+    GfxMemoryBlock &block = s_gfxMemory.blocks[blockIndex];
+    if (block.mapped) {
+        vkUnmapMemory(g_vulkanBackend.device, block.memory);
+    }
+    vkFreeMemory(g_vulkanBackend.device, block.memory, nullptr);
+    if (block.freeRanges) {
+        mem_free(block.freeRanges);
+    }
+    block = {};
+}
+
+static bool gfx_memory_release_empty_blocks() {
+    bool released = false;
+    for (uint32_t i = 0; i < s_gfxMemory.blockSlotCount; ++i) {
+        const GfxMemoryBlock &block = s_gfxMemory.blocks[i];
+        if (block.memory != VK_NULL_HANDLE && block.allocationCount == 0) {
+            gfx_memory_release_block(i);
+            released = true;
+        }
+    }
+    return released;
+}
+
+// returns UINT32_MAX when the driver is out of device memory, gfx_memory_alloc decides how to make room. The block slot
+// is only picked once the allocation succeeds.
+static uint32_t gfx_memory_create_block(const uint32_t memoryTypeIndex, const VkDeviceSize size, const VkMemoryAllocateFlags allocateFlags,
+                                        const GfxMemoryStrategy strategy, const GfxMemoryResource resource, const bool dedicated) {
+    VkMemoryAllocateInfo memAllocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    memAllocInfo.allocationSize = size;
+    memAllocInfo.memoryTypeIndex = memoryTypeIndex;
+    VkMemoryAllocateFlagsInfo allocFlagsInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO};
+    if (allocateFlags != 0) {
+        allocFlagsInfo.flags = allocateFlags;
+        memAllocInfo.pNext = &allocFlagsInfo;
+    }
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    const VkResult allocResult = vkAllocateMemory(g_vulkanBackend.device, &memAllocInfo, nullptr, &memory);
+    if (allocResult == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+        return UINT32_MAX;
+    }
+    ASSERT_MSG(allocResult == VK_SUCCESS, "Err: failed to allocate %llu bytes of gpu memory from type %u", (unsigned long long) size, memoryTypeIndex);
+
+    uint32_t blockIndex = 0;
+    while (blockIndex < s_gfxMemory.blockSlotCount && s_gfxMemory.blocks[blockIndex].memory != VK_NULL_HANDLE) {
+        ++blockIndex;
+    }
+    ASSERT_MSG(blockIndex < GFX_MEMORY_MAX_BLOCKS, "Err: out of gpu memory blocks, raise GFX_MEMORY_MAX_BLOCKS");
+    if (blockIndex == s_gfxMemory.blockSlotCount) {
+        s_gfxMemory.blockSlotCount++;
+    }
+
+    GfxMemoryBlock &block = s_gfxMemory.blocks[blockIndex];
+    block.memory = memory;
+    block.size = size;
+    block.memoryTypeIndex = memoryTypeIndex;
+    block.allocateFlags = allocateFlags;
+    block.strategy = strategy;
+    block.resource = resource;
+    block.dedicated = dedicated;
+    if (strategy == GfxMemoryStrategy::FreeList && !dedicated) {
+        gfx_memory_insert_range(block, 0, {0, size});
+    }
+
+    const VkMemoryPropertyFlags typeFlags = g_vulkanBackend.deviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        const VkResult mapResult = vkMapMemory(g_vulkanBackend.device, block.memory, 0, VK_WHOLE_SIZE, 0, (void **) &block.mapped);
+        ASSERT(mapResult == VK_SUCCESS);
+    }
+    return blockIndex;
+}
+
+// when the device reports a granularity above 1, linear and optimal resources are kept in separate blocks rather than
+// padding every neighbouring pair of allocations.
+static bool gfx_memory_block_accepts(const GfxMemoryBlock &block, const uint32_t memoryTypeIndex, const VkMemoryAllocateFlags allocateFlags,
+                                     const GfxMemoryStrategy strategy, const GfxMemoryResource resource) {
+    return block.memory != VK_NULL_HANDLE
+           && !block.dedicated
+           && block.memoryTypeIndex == memoryTypeIndex
+           && block.allocateFlags == allocateFlags
+           && block.strategy == strategy
+           && (s_gfxMemory.bufferImageGranularity <= 1 || block.resource == resource);
+}
+
+static uint32_t gfx_memory_alloc_from_blocks(const VkMemoryRequirements &requirements, const uint32_t memoryTypeIndex, const VkMemoryAllocateFlags allocateFlags,
+                                             const GfxMemoryStrategy strategy, const GfxMemoryResource resource, VkDeviceSize &outOffset) {
+    for (uint32_t i = 0; i < s_gfxMemory.blockSlotCount; ++i) {
+        GfxMemoryBlock &block = s_gfxMemory.blocks[i];
+        if (gfx_memory_block_accepts(block, memoryTypeIndex, allocateFlags, strategy, resource) &&
+            gfx_memory_block_alloc(block, requirements.size, requirements.alignment, outOffset)) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+GfxAllocation gfx_memory_try_alloc(const VkMemoryRequirements &requirements,
+                                   const VkMemoryPropertyFlags properties,
+                                   const GfxMemoryResource resource,
+                                   const GfxMemoryStrategy strategy,
+                                   const VkMemoryAllocateFlags allocateFlags) {
+    ASSERT(requirements.size > 0);
+    const uint32_t memoryTypeIndex = gfx_utils_get_memory_type(requirements.memoryTypeBits, properties);
+    const VkDeviceSize blockSize = gfx_memory_block_size(memoryTypeIndex);
+
+    const bool dedicated = requirements.size > blockSize / 2;
+    uint32_t blockIndex = UINT32_MAX;
+    VkDeviceSize offset = 0;
+    // under memory pressure hand back empty blocks first, then have the residency manager drop texture mips. Eviction
+    // frees ranges inside existing blocks, so those are searched again before the driver is asked for another block.
+    do {
+        if (!dedicated) {
+            blockIndex = gfx_memory_alloc_from_blocks(requirements, memoryTypeIndex, allocateFlags, strategy, resource, offset);
+            if (blockIndex != UINT32_MAX) {
+                break;
+            }
+        }
+        blockIndex = gfx_memory_create_block(memoryTypeIndex, dedicated ? requirements.size : blockSize, allocateFlags, strategy, resource, dedicated);
+        if (blockIndex != UINT32_MAX) {
+            if (!dedicated) {
+                const bool allocated = gfx_memory_block_alloc(s_gfxMemory.blocks[blockIndex], requirements.size, requirements.alignment, offset);
+                ASSERT(allocated);
+            }
+            break;
+        }
+    } while (gfx_memory_release_empty_blocks() || gfx_residency_evict_lru());
+    if (blockIndex == UINT32_MAX) {
+        return {};
+    }
+
+    GfxMemoryBlock &block = s_gfxMemory.blocks[blockIndex];
+    block.allocationCount++;
+    block.usedBytes += requirements.size;
+    return {
+            .memory = block.memory,
+            .offset = offset,
+            .size = requirements.size,
+            .mapped = block.mapped ? block.mapped + offset : nullptr,
+            .blockIndex = blockIndex,
+    };
+}
+
+GfxAllocation gfx_memory_alloc(const VkMemoryRequirements &requirements,
+                               const VkMemoryPropertyFlags properties,
+                               const GfxMemoryResource resource,
+                               const GfxMemoryStrategy strategy,
+                               const VkMemoryAllocateFlags allocateFlags) {
+    const GfxAllocation allocation = gfx_memory_try_alloc(requirements, properties, resource, strategy, allocateFlags);
+    ASSERT_MSG(allocation.blockIndex != UINT32_MAX, "Err: failed to allocate %llu bytes of gpu memory with properties 0x%x",
+               (unsigned long long) requirements.size, properties);
+    return allocation;
+}
+
+void gfx_memory_free(GfxAllocation &allocation) {
+    if (allocation.blockIndex == UINT32_MAX) {
+        return;
+    }
+    GfxMemoryBlock &block = s_gfxMemory.blocks[allocation.blockIndex];
+    ASSERT_MSG(block.memory == allocation.memory && block.allocationCount > 0, "Err: gpu allocation does not belong to block %u", allocation.blockIndex);
+    block.allocationCount--;
+    block.usedBytes -= allocation.size;
+
+    if (block.dedicated) {
+        gfx_memory_release_block(allocation.blockIndex);
+    } else if (block.strategy == GfxMemoryStrategy::Linear) {
+        if (block.allocationCount == 0) {
+            block.linearHead = 0;
+        }
+    } else {
+        gfx_memory_free_list_free(block, allocation.offset, allocation.size);
+    }
+    allocation = {};
+}
+
+GfxAllocation gfx_memory_alloc_buffer(const VkBuffer buffer, const VkMemoryPropertyFlags properties, const GfxMemoryStrategy strategy, const VkMemoryAllocateFlags allocateFlags) {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(g_vulkanBackend.device, buffer, &requirements);
+    const GfxAllocation allocation = gfx_memory_alloc(requirements, properties, GfxMemoryResource::Linear, strategy, allocateFlags);
+    const VkResult bindRes = vkBindBufferMemory(g_vulkanBackend.device, buffer, allocation.memory, allocation.offset);
+    ASSERT(bindRes == VK_SUCCESS);
+    return allocation;
+}
+
+GfxAllocation gfx_memory_alloc_image(const VkImage image, const VkMemoryPropertyFlags properties, const GfxMemoryStrategy strategy) {
+    const GfxAllocation allocation = gfx_memory_try_alloc_image(image, properties, strategy);
+    ASSERT_MSG(allocation.blockIndex != UINT32_MAX, "Err: failed to allocate gpu memory for image");
+    return allocation;
+}
+
+GfxAllocation gfx_memory_try_alloc_image(const VkImage image, const VkMemoryPropertyFlags properties, const GfxMemoryStrategy strategy) {
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(g_vulkanBackend.device, image, &requirements);
+    const GfxAllocation allocation = gfx_memory_try_alloc(requirements, properties, GfxMemoryResource::Optimal, strategy);
+    if (allocation.blockIndex == UINT32_MAX) {
+        return allocation;
+    }
+    const VkResult bindRes = vkBindImageMemory(g_vulkanBackend.device, image, allocation.memory, allocation.offset);
+    ASSERT(bindRes == VK_SUCCESS);
+    return allocation;
+}
+
+GfxMemoryStats gfx_memory_stats() {
+    GfxMemoryStats stats = {};
+    for (uint32_t i = 0; i < s_gfxMemory.blockSlotCount; ++i) {
+        const GfxMemoryBlock &block = s_gfxMemory.blocks[i];
+        if (block.memory == VK_NULL_HANDLE) {
+            continue;
+        }
+        const uint32_t heapIndex = g_vulkanBackend.deviceMemoryProperties.memoryTypes[block.memoryTypeIndex].heapIndex;
+        stats.blockCount++;
+        stats.dedicatedBlockCount += block.dedicated ? 1 : 0;
+        stats.allocationCount += block.allocationCount;
+        stats.reservedBytes += block.size;
+        stats.usedBytes += block.usedBytes;
+        stats.heapReservedBytes[heapIndex] += block.size;
+        stats.heapUsedBytes[heapIndex] += block.usedBytes;
+    }
+    return stats;
+}
+
+void gfx_memory_dump_stats() {
+    const GfxMemoryStats stats = gfx_memory_stats();
+    log_info(MSG_GFX, "gpu memory: %u blocks (%u dedicated), %u allocations, %llu / %llu bytes used\n",
+             stats.blockCount, stats.dedicatedBlockCount, stats.allocationCount,
+             (unsigned long long) stats.usedBytes, (unsigned long long) stats.reservedBytes);
+    for (uint32_t heap = 0; heap < g_vulkanBackend.deviceMemoryProperties.memoryHeapCount; ++heap) {
+        if (stats.heapReservedBytes[heap] == 0) {
+            continue;
+        }
+        log_info(MSG_GFX, "  heap %u: %llu / %llu bytes used\n", heap,
+                 (unsigned long long) stats.heapUsedBytes[heap], (unsigned long long) stats.heapReservedBytes[heap]);
+    }
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_memory() {
+    s_gfxMemory.bufferImageGranularity = g_vulkanBackend.deviceProperties.limits.bufferImageGranularity;
+}
+
+void gfx_cleanup_memory() {
+    for (uint32_t i = 0; i < s_gfxMemory.blockSlotCount; ++i) {
+        GfxMemoryBlock &block = s_gfxMemory.blocks[i];
+        if (block.memory == VK_NULL_HANDLE) {
+            continue;
+        }
+        if (block.allocationCount > 0) {
+            log_warning(MSG_GFX, "gpu memory block %u released with %u live allocations\n", i, block.allocationCount);
+        }
+        gfx_memory_release_block(i);
+    }
+    s_gfxMemory.blockSlotCount = 0;
+    s_gfxMemory.bufferImageGranularity = 1;
+}
+//======================================================================================================================
@@ -1,24 +1,39 @@
 #include <beet_gfx/gfx_mesh.h>
 #include <beet_gfx/gfx_buffer.h>
-#include <beet_gfx/gfx_command.h>
+#include <beet_gfx/gfx_upload.h>
 #include <beet_gfx/gfx_types.h>
 
 #include <beet_shared/assert.h>
 
+#include <cmath>
+
 //===INTERNAL_STRUCTS===================================================================================================
 extern VulkanBackend g_vulkanBackend;
 //======================================================================================================================
 
+//===INTERNAL_FUNCTIONS=================================================================================================
+static void gfx_mesh_compute_bounds(const RawMesh &rawMesh, GfxMesh &outMesh) {
+    outMesh.boundsMin = rawMesh.vertexData[0].pos;
+    outMesh.boundsMax = rawMesh.vertexData[0].pos;
+    for (uint32_t i = 1; i < rawMesh.vertexCount; ++i) {
+        outMesh.boundsMin = glm::min(outMesh.boundsMin, rawMesh.vertexData[i].pos);
+        outMesh.boundsMax = glm::max(outMesh.boundsMax, rawMesh.vertexData[i].pos);
+    }
+    outMesh.boundsCenter = (outMesh.boundsMin + outMesh.boundsMax) * 0.5f;
+
+    float radiusSquared = 0.0f;
+    for (uint32_t i = 0; i < rawMesh.vertexCount; ++i) {
+        const vec3f offset = rawMesh.vertexData[i].pos - outMesh.boundsCenter;
+        radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+    }
+    outMesh.boundsRadius = sqrtf(radiusSquared);
+}
+//======================================================================================================================
+
 //===API================================================================================================================
-void gfx_mesh_create_immediate(const RawMesh &rawMesh, GfxMesh &outMesh) {
+GfxUploadHandle gfx_mesh_create(const RawMesh &rawMesh, GfxMesh &outMesh) {
     ASSERT((rawMesh.vertexCount > 0) && (rawMesh.indexCount > 0))
-
-    struct StagingBuffer {
-        VkBuffer buffer;
-        VkDeviceMemory memory;
-    };
-    StagingBuffer vertexStaging = {};
-    StagingBuffer indexStaging = {};
+    gfx_mesh_compute_bounds(rawMesh, outMesh);
 
     const size_t vertexBufferSize = sizeof(GfxVertex) * rawMesh.vertexCount;
     const size_t indexBufferSize = sizeof(uint32_t) * rawMesh.indexCount;
@@ -26,34 +41,13 @@ void gfx_mesh_create_immediate(const RawMesh &rawMesh, GfxMesh &outMesh) {
     outMesh.indexCount = rawMesh.indexCount;
     outMesh.vertCount = rawMesh.vertexCount;
 
-    // Create staging buffers
-    VkResult vertexCreateStageRes = gfx_buffer_create(
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            vertexBufferSize,
-            vertexStaging.buffer,
-            vertexStaging.memory,
-            rawMesh.vertexData
-    );
-    ASSERT(vertexCreateStageRes == VK_SUCCESS)
-
-    VkResult indexCreateStageRes = gfx_buffer_create(
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            indexBufferSize,
-            indexStaging.buffer,
-            indexStaging.memory,
-            rawMesh.indexData
-    );
-    ASSERT(indexCreateStageRes == VK_SUCCESS)
-
     // Create device local buffers
     const VkResult vertexCreateDeviceLocalRes = gfx_buffer_create(
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             vertexBufferSize,
             outMesh.vertBuffer,
-            outMesh.vertMemory,
+            outMesh.vertAllocation,
             nullptr
     );
     ASSERT(vertexCreateDeviceLocalRes == VK_SUCCESS)
@@ -63,26 +57,18 @@ void gfx_mesh_create_immediate(const RawMesh &rawMesh, GfxMesh &outMesh) {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             indexBufferSize,
             outMesh.indexBuffer,
-            outMesh.indexMemory,
+            outMesh.indexAllocation,
             nullptr
     );
     ASSERT(indexCreateDeviceLocalRes == VK_SUCCESS)
 
-    gfx_command_begin_immediate_recording();
-    {
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = vertexBufferSize;
-        vkCmdCopyBuffer(g_vulkanBackend.immediateCommandBuffer, vertexStaging.buffer, outMesh.vertBuffer, 1, &copyRegion);
-
-        copyRegion.size = indexBufferSize;
-        vkCmdCopyBuffer(g_vulkanBackend.immediateCommandBuffer, indexStaging.buffer, outMesh.indexBuffer, 1, &copyRegion);
-    }
-    gfx_command_end_immediate_recording();
+    // both copies normally share a batch, waiting on the later handle covers the earlier one either way.
+    gfx_upload_buffer(outMesh.vertBuffer, 0, rawMesh.vertexData, vertexBufferSize);
+    return gfx_upload_buffer(outMesh.indexBuffer, 0, rawMesh.indexData, indexBufferSize);
+}
 
-    vkDestroyBuffer(g_vulkanBackend.device, vertexStaging.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, vertexStaging.memory, nullptr);
-    vkDestroyBuffer(g_vulkanBackend.device, indexStaging.buffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, indexStaging.memory, nullptr);
+void gfx_mesh_create_immediate(const RawMesh &rawMesh, GfxMesh &outMesh) {
+    gfx_upload_wait(gfx_mesh_create(rawMesh, outMesh));
 }
 
 
@@ -1152,7 +1138,7 @@ void *gltf_pull_out_binary_data_alloc(const uint32_t inAccessorIndex, size_t &ou
         const size_t allocSize = outCount * gltf_component_type_size_lookup(accessor.componentType);
         ASSERT(allocSize <= bufferView.byteLength); // sometimes we subview into a buffer.
 
-        void *outData = mem_zalloc(allocSize);
+        void *outData = mem_zalloc(allocSize, MSG_GLTF);
         ASSERT(outData != nullptr)
         if (bufferView.byteStride == 0) {
             memcpy(outData, &buffer.binaryData[0] + bufferView.byteOffset + accessor.byteOffset, allocSize);
@@ -1564,10 +1550,8 @@ void gfx_mesh_create_cube_immediate(GfxMesh &outMesh) {
 }
 
 void gfx_mesh_cleanup(GfxMesh &mesh) {
-    vkDestroyBuffer(g_vulkanBackend.device, mesh.vertBuffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, mesh.vertMemory, nullptr);
-    vkDestroyBuffer(g_vulkanBackend.device, mesh.indexBuffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, mesh.indexMemory, nullptr);
+    gfx_buffer_cleanup(mesh.vertBuffer, mesh.vertAllocation);
+    gfx_buffer_cleanup(mesh.indexBuffer, mesh.indexAllocation);
     mesh = {};
 
     //TODO:GFX We don't re-add this as a free slot in the texture pool i.e.
@@ -0,0 +1,197 @@
+#include <beet_gfx/gfx_residency.h>
+#include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_memory.h>
+#include <beet_gfx/gfx_texture.h>
+#include <beet_gfx/gfx_interface.h>
+#include <beet_gfx/db_asset.h>
+
+#include <beet_shared/assert.h>
+#include <beet_shared/log.h>
+#include <beet_shared/profiler.h>
+
+#include <vulkan/vulkan_core.h>
+
+//===INTERNAL_STRUCTS===================================================================================================
+static struct GfxResidency {
+    uint32_t lastUsedFrame[MAX_DB_GFX_TEXTURES] = {};
+    VkDeviceSize budgetOverride = {0};
+    uint32_t evictionCount = {0};
+    uint32_t restoreCount = {0};
+    // evicting rebuilds an image, which allocates, which may ask for another eviction.
+    bool busy = {false};
+} s_gfxResidency;
+
+extern VulkanBackend g_vulkanBackend;
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static void gfx_residency_query(VkDeviceSize &outBudget, VkDeviceSize &outUsage) {
+    const GfxMemoryStats memoryStats = gfx_memory_stats();
+    const VkPhysicalDeviceMemoryProperties &memoryProperties = g_vulkanBackend.deviceMemoryProperties;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+    if (g_vulkanBackend.memoryBudgetSupported) {
+        VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2};
+        memoryProperties2.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(g_vulkanBackend.physicalDevice, &memoryProperties2);
+    }
+
+    outBudget = 0;
+    outUsage = 0;
+    for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; ++heap) {
+        if ((memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0) {
+            continue;
+        }
+        if (g_vulkanBackend.memoryBudgetSupported) {
+            // free ranges inside our blocks are counted as used by the driver but are still ours to hand out.
+            const VkDeviceSize allocatorSlack = memoryStats.heapReservedBytes[heap] - memoryStats.heapUsedBytes[heap];
+            outBudget += budgetProperties.heapBudget[heap];
+            outUsage += budgetProperties.heapUsage[heap] > allocatorSlack ? budgetProperties.heapUsage[heap] - allocatorSlack : 0;
+        } else {
+            // same headroom the driver would typically leave for other processes and the compositor.
+            outBudget += memoryProperties.memoryHeaps[heap].size / 5 * 4;
+            outUsage += memoryStats.heapUsedBytes[heap];
+        }
+    }
+    if (s_gfxResidency.budgetOverride != 0) {
+        outBudget = s_gfxResidency.budgetOverride;
+    }
+}
+
+static bool gfx_residency_can_evict(const GfxTexture &texture) {
+    return texture.sourcePath[0] != '\0' && texture.imageBaseMip + texture.residentBaseMip < texture.tailBaseMip;
+}
+
+static uint32_t gfx_residency_find_lru() {
+    uint32_t lruIndex = UINT32_MAX;
+    uint32_t lruFrame = UINT32_MAX;
+    const uint32_t textureCount = db_get_texture_count();
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        if (!db_valid_texture(i) || !gfx_residency_can_evict(*db_get_texture(i)) || gfx_texture_restore_pending(i)) {
+            continue;
+        }
+        // ties go to the larger texture, it frees more per reload.
+        const uint32_t lastUsed = s_gfxResidency.lastUsedFrame[i];
+        if (lruIndex == UINT32_MAX || lastUsed < lruFrame || (lastUsed == lruFrame && db_get_texture(i)->allocation.size > db_get_texture(lruIndex)->allocation.size)) {
+            lruIndex = i;
+            lruFrame = lastUsed;
+        }
+    }
+    return lruIndex;
+}
+
+static VkDeviceSize gfx_residency_evict_texture(const uint32_t textureIndex) {
+    const GfxTexture &texture = *db_get_texture(textureIndex);
+    const VkDeviceSize sizeBefore = texture.allocation.size;
+    gfx_texture_evict_mips(textureIndex, texture.imageBaseMip + texture.residentBaseMip + 1);
+    s_gfxResidency.evictionCount++;
+    log_verbose(MSG_GFX, "residency: evicted top mip of %s, image now starts at mip %u\n", texture.sourcePath, texture.imageBaseMip);
+    return sizeBefore > texture.allocation.size ? sizeBefore - texture.allocation.size : 0;
+}
+
+// a rough upper bound, every evicted mip level quarters the footprint of a 2D texture.
+static VkDeviceSize gfx_residency_restore_estimate(const GfxTexture &texture) {
+    const uint32_t shift = texture.viewType == VK_IMAGE_VIEW_TYPE_3D ? 3 : 2;
+    return (texture.allocation.size << (shift * texture.imageBaseMip)) - texture.allocation.size;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void gfx_residency_touch(const uint32_t textureIndex) {
+    ASSERT(textureIndex < MAX_DB_GFX_TEXTURES);
+    s_gfxResidency.lastUsedFrame[textureIndex] = gfx_current_frame();
+}
+
+void gfx_residency_update() {
+    BEET_PROFILE_SCOPE("gfx_residency_update");
+    VkDeviceSize budget = 0;
+    VkDeviceSize usage = 0;
+    gfx_residency_query(budget, usage);
+
+    // restores stay inside the busy section too, evicting another texture to make room for one would only thrash.
+    s_gfxResidency.busy = true;
+    const VkDeviceSize evictAbove = (VkDeviceSize) ((double) budget * GFX_RESIDENCY_EVICT_THRESHOLD);
+    for (uint32_t evictions = 0; usage > evictAbove && evictions < GFX_RESIDENCY_MAX_EVICTIONS_PER_FRAME; ++evictions) {
+        const uint32_t lruIndex = gfx_residency_find_lru();
+        if (lruIndex == UINT32_MAX) {
+            break;
+        }
+        const VkDeviceSize freed = gfx_residency_evict_texture(lruIndex);
+        usage = usage > freed ? usage - freed : 0;
+    }
+
+    // only textures sampled last frame are worth bringing back, the rest stay evicted until they are drawn again.
+    const VkDeviceSize restoreBelow = (VkDeviceSize) ((double) budget * GFX_RESIDENCY_RESTORE_THRESHOLD);
+    const uint32_t previousFrame = gfx_current_frame() > 0 ? gfx_current_frame() - 1 : 0;
+    uint32_t restores = 0;
+    const uint32_t textureCount = db_get_texture_count();
+    for (uint32_t i = 0; i < textureCount && restores < GFX_RESIDENCY_MAX_RESTORES_PER_FRAME; ++i) {
+        if (!db_valid_texture(i) || db_get_texture(i)->imageBaseMip == 0 || s_gfxResidency.lastUsedFrame[i] < previousFrame ||
+            gfx_texture_restore_pending(i)) {
+            continue;
+        }
+        const VkDeviceSize estimate = gfx_residency_restore_estimate(*db_get_texture(i));
+        if (usage + estimate > restoreBelow) {
+            continue;
+        }
+        if (!gfx_texture_restore_mips(i)) {
+            // the estimate undershot what the driver can hand out, the texture is tried again next frame.
+            log_verbose(MSG_GFX, "residency: no device memory to restore %s, retrying next frame\n", db_get_texture(i)->sourcePath);
+            break;
+        }
+        usage += estimate;
+        s_gfxResidency.restoreCount++;
+        restores++;
+    }
+    s_gfxResidency.busy = false;
+}
+
+bool gfx_residency_evict_lru() {
+    if (s_gfxResidency.busy) {
+        return false;
+    }
+    const uint32_t lruIndex = gfx_residency_find_lru();
+    if (lruIndex == UINT32_MAX) {
+        return false;
+    }
+    s_gfxResidency.busy = true;
+    gfx_residency_evict_texture(lruIndex);
+    s_gfxResidency.busy = false;
+    return true;
+}
+
+void gfx_residency_set_budget_override(const VkDeviceSize budgetBytes) {
+    s_gfxResidency.budgetOverride = budgetBytes;
+}
+
+GfxResidencyStats gfx_residency_stats() {
+    GfxResidencyStats stats = {};
+    gfx_residency_query(stats.budgetBytes, stats.usageBytes);
+    const uint32_t textureCount = db_get_texture_count();
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        if (!db_valid_texture(i)) {
+            continue;
+        }
+        const GfxTexture &texture = *db_get_texture(i);
+        stats.textureBytes += texture.allocation.size;
+        stats.evictedTextureCount += texture.imageBaseMip > 0 ? 1 : 0;
+    }
+    stats.evictionCount = s_gfxResidency.evictionCount;
+    stats.restoreCount = s_gfxResidency.restoreCount;
+    return stats;
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_residency() {
+    VkDeviceSize budget = 0;
+    VkDeviceSize usage = 0;
+    gfx_residency_query(budget, usage);
+    log_info(MSG_GFX, "residency: %llu MB device local budget (%s)\n", (unsigned long long) (budget / (1024 * 1024)),
+             g_vulkanBackend.memoryBudgetSupported ? "VK_EXT_memory_budget" : "estimated from heap sizes");
+}
+
+void gfx_cleanup_residency() {
+    s_gfxResidency = {};
+}
+//======================================================================================================================
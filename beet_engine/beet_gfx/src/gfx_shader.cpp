@@ -20,7 +20,7 @@ VkShaderModule gfx_load_shader_binary(const char *path) {
     ASSERT_MSG(is.is_open(), "Err: Failed to open shader %s", path);
     size_t size = is.tellg();
     is.seekg(0, std::ios::beg);
-    char *shaderCode = (char *) mem_zalloc(sizeof(char) * size);
+    char *shaderCode = (char *) mem_zalloc(sizeof(char) * size, MSG_GFX);
     is.read(shaderCode, size);
     is.close();
     ASSERT(size > 0);
@@ -5,9 +5,12 @@
 #include <beet_gfx/gfx_shader.h>
 #include <beet_gfx/gfx_pipeline.h>
 #include <beet_gfx/db_asset.h>
+#include <beet_gfx/gfx_interface.h>
+#include <beet_gfx/gfx_residency.h>
 
 #include <beet_shared/assert.h>
 #include <beet_shared/beet_types.h>
+#include <beet_shared/profiler.h>
 
 #include <beet_math/quat.h>
 #include <beet_math/utilities.h>
@@ -195,10 +198,15 @@ bool gfx_rebuild_sky_pipeline() {
 }
 
 void gfx_sky_draw(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_sky_draw");
     const uint32_t skyEntityCount = db_get_sky_entity_count();
     for (uint32_t i = 0; i < skyEntityCount; ++i) {
+        if (!db_valid_sky_entity(i)) {
+            continue;
+        }
         const SkyEntity &entity = *db_get_sky_entity(i);
         const SkyMaterial &material = *db_get_sky_material(entity.materialIndex);
+        gfx_residency_touch(material.octahedralMapIndex);
         const VkDescriptorSet &descriptorSet = *db_get_descriptor_set(material.descriptorSetIndex);
         const GfxMesh &mesh = *db_get_mesh(entity.meshIndex);
 
@@ -215,6 +223,7 @@ void gfx_sky_draw(VkCommandBuffer &cmdBuffer) {
 
         vkCmdBindIndexBuffer(cmdBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
         vkCmdDrawIndexed(cmdBuffer, mesh.indexCount, 1, 0, 0, 0);
+        gfx_add_draw_calls(1);
     }
 }
 //======================================================================================================================
@@ -2,146 +2,389 @@
 #include <beet_gfx/gfx_types.h>
 #include <beet_gfx/gfx_samplers.h>
 #include <beet_gfx/gfx_utils.h>
-#include <beet_gfx/gfx_command.h>
+#include <beet_gfx/gfx_upload.h>
+#include <beet_gfx/gfx_memory.h>
 #include <beet_gfx/gfx_converter.h>
+#include <beet_gfx/gfx_interface.h>
+#include <beet_gfx/gfx_descriptors.h>
+#include <beet_gfx/gfx_bindless.h>
+#include <beet_gfx/db_asset.h>
 
 #include <beet_shared/texture_formats.h>
 #include <beet_shared/dds_loader.h>
 #include <beet_shared/assert.h>
 #include <beet_shared/memory.h>
 #include <beet_shared/filesystem.h>
+#include <beet_shared/log.h>
+#include <beet_shared/profiler.h>
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <cstring>
+
 //===INTERNAL_STRUCTS===================================================================================================
+struct GfxTextureStreamJob {
+    VkImage image;
+    VkFormat format;
+    RawImage rawImage; // mapped, released once every mip is resident
+    uint32_t residentBaseMip;
+
+    // a step in flight on the transfer queue, the view only moves to pendingBaseMip once it completes.
+    GfxUploadHandle pendingUpload;
+    uint32_t pendingBaseMip;
+
+    // restores build the full image next to the evicted one, which stays in the db slot until the tail has landed.
+    uint32_t restoreTextureIndex; // UINT32_MAX once the job streams into the db texture's own image
+    GfxAllocation restoreAllocation;
+};
+
+// a replaced view or image may still be sampled by frames in flight, it is destroyed once the frame that retired it has
+// completed. Every job retires at most one entry per frame.
+struct GfxTextureRetired {
+    VkImageView view;
+    VkImage image;
+    GfxAllocation allocation;
+    uint32_t frame;
+};
+constexpr uint32_t GFX_TEXTURE_MAX_RETIRED = MAX_DB_GFX_TEXTURES * BEET_BUFFER_COUNT;
+
+static struct GfxTextureStreaming {
+    GfxTextureStreamJob jobs[MAX_DB_GFX_TEXTURES] = {};
+    uint32_t jobCount = {0};
+    VkDeviceSize frameBudgetBytes = {GFX_TEXTURE_STREAM_DEFAULT_FRAME_BUDGET};
+
+    GfxTextureRetired retired[GFX_TEXTURE_MAX_RETIRED] = {}; // in retire order, so the oldest are always at the front
+    uint32_t retiredCount = {0};
+} s_gfxTextureStreaming;
+
 extern VulkanBackend g_vulkanBackend;
 //======================================================================================================================
 
 //===INTERNAL_FUNCTIONS=================================================================================================
-static void set_image_layout(
-        VkCommandBuffer cmdbuffer,
-        VkImage image,
-        VkImageLayout oldImageLayout,
-        VkImageLayout newImageLayout,
-        VkImageSubresourceRange subresourceRange,
-        VkPipelineStageFlags srcStageMask,
-        VkPipelineStageFlags dstStageMask) {
-    // Create an image barrier object
-    VkImageMemoryBarrier imageMemoryBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-    imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageMemoryBarrier.oldLayout = oldImageLayout;
-    imageMemoryBarrier.newLayout = newImageLayout;
-    imageMemoryBarrier.image = image;
-    imageMemoryBarrier.subresourceRange = subresourceRange;
-
-    // Source layouts (old)
-    // Source access mask controls actions that have to be finished on the old layout
-    // before it will be transitioned to the new layout
-    switch (oldImageLayout) {
-        case VK_IMAGE_LAYOUT_UNDEFINED:
-            // Image layout is undefined (or does not matter)
-            // Only valid as initial layout
-            // No flags required, listed only for completeness
-            imageMemoryBarrier.srcAccessMask = 0;
-            break;
+static VkDeviceSize gfx_texture_align_copy_size(const VkDeviceSize size) {
+    return (size + GFX_UPLOAD_STAGING_ALIGNMENT - 1) & ~(GFX_UPLOAD_STAGING_ALIGNMENT - 1);
+}
 
-        case VK_IMAGE_LAYOUT_PREINITIALIZED:
-            // Image is preinitialized
-            // Only valid as initial layout for linear images, preserves memory contents
-            // Make sure host writes have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-            break;
+// width and height of a compressed block, copies into a block compressed image start and end on block boundaries.
+static uint32_t gfx_texture_block_extent(const TextureFormat textureFormat) {
+    return textureFormat == TextureFormat::RGBA8 || textureFormat == TextureFormat::RGBA16 ? 1 : 4;
+}
 
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            // Image is a color attachment
-            // Make sure any writes to the color buffer have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+static VkImageViewType gfx_texture_view_type(const RawImage &rawImage) {
+    switch (rawImage.dimension) {
+        case TextureDimension::TEXTURE_3D:
+            return VK_IMAGE_VIEW_TYPE_3D;
+        case TextureDimension::TEXTURE_CUBE:
+            return rawImage.arrayLayers > 6 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+        case TextureDimension::TEXTURE_2D:
             break;
+    }
+    return rawImage.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+}
 
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            // Image is a depth/stencil attachment
-            // Make sure any writes to the depth/stencil buffer have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            break;
+static uint32_t gfx_texture_tail_base_mip(const RawImage &rawImage) {
+    uint32_t tailBaseMip = 0;
+    while (tailBaseMip + 1 < rawImage.mipMapCount &&
+           ((rawImage.width >> tailBaseMip) > GFX_TEXTURE_STREAM_TAIL_SIZE || (rawImage.height >> tailBaseMip) > GFX_TEXTURE_STREAM_TAIL_SIZE)) {
+        tailBaseMip++;
+    }
+    return tailBaseMip;
+}
 
-        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-            // Image is a transfer source
-            // Make sure any reads from the image have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            break;
+// the image only holds source mips [imageBaseMip, mipMapCount), mip 0 of the image is source mip imageBaseMip. Returns
+// false without leaving an image behind when device memory is short even after evictions.
+static bool gfx_texture_create_device_image(const RawImage &rawImage, const VkFormat format, const uint32_t imageBaseMip, GfxTexture &inOutTexture) {
+    const bool isVolume = rawImage.dimension == TextureDimension::TEXTURE_3D;
+    VkImageCreateInfo imageCreateInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageCreateInfo.imageType = isVolume ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+    imageCreateInfo.extent.width = std::max(1u, rawImage.width >> imageBaseMip);
+    imageCreateInfo.extent.height = std::max(1u, rawImage.height >> imageBaseMip);
+    imageCreateInfo.extent.depth = std::max(1u, rawImage.depth >> imageBaseMip);
+    imageCreateInfo.mipLevels = rawImage.mipMapCount - imageBaseMip;
+    imageCreateInfo.arrayLayers = rawImage.arrayLayers;
+    imageCreateInfo.format = format;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.flags = rawImage.dimension == TextureDimension::TEXTURE_CUBE ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
 
-        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            // Image is a transfer destination
-            // Make sure any writes to the image have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            break;
+    const VkResult createImageRes = vkCreateImage(g_vulkanBackend.device, &imageCreateInfo, nullptr, &inOutTexture.image);
+    ASSERT(createImageRes == VK_SUCCESS);
 
-        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-            // Image is read by a shader
-            // Make sure any shader reads from the image have been finished
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            break;
-        default:
-            // Other source layouts aren't handled (yet)
-            break;
+    inOutTexture.allocation = gfx_memory_try_alloc_image(inOutTexture.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (inOutTexture.allocation.blockIndex == UINT32_MAX) {
+        vkDestroyImage(g_vulkanBackend.device, inOutTexture.image, nullptr);
+        inOutTexture.image = VK_NULL_HANDLE;
+        return false;
     }
 
-    // Target layouts (new)
-    // Destination access mask controls the dependency for the new image layout
-    switch (newImageLayout) {
-        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            // Image will be used as a transfer destination
-            // Make sure any writes to the image have been finished
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            break;
+    inOutTexture.viewType = gfx_texture_view_type(rawImage);
+    inOutTexture.layerCount = rawImage.arrayLayers;
+    inOutTexture.mipCount = rawImage.mipMapCount - imageBaseMip;
+    inOutTexture.imageBaseMip = imageBaseMip;
+    inOutTexture.tailBaseMip = gfx_texture_tail_base_mip(rawImage);
+    return true;
+}
 
-        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-            // Image will be used as a transfer source
-            // Make sure any reads from the image have been finished
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            break;
+// the view only covers resident mips, so sampling clamps to the highest resident mip without touching the samplers.
+static void gfx_texture_create_view(GfxTexture &inOutTexture, const VkFormat format, const uint32_t baseMip) {
+    VkImageViewCreateInfo view{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    view.viewType = inOutTexture.viewType;
+    view.format = format;
+    view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view.subresourceRange.baseMipLevel = baseMip;
+    view.subresourceRange.baseArrayLayer = 0;
+    view.subresourceRange.layerCount = inOutTexture.layerCount;
+    view.subresourceRange.levelCount = inOutTexture.mipCount - baseMip;
+    view.image = inOutTexture.image;
 
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            // Image will be used as a color attachment
-            // Make sure any writes to the color buffer have been finished
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            break;
+    const VkResult imageViewRes = vkCreateImageView(g_vulkanBackend.device, &view, nullptr, &inOutTexture.view);
+    ASSERT(imageViewRes == VK_SUCCESS);
 
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            // Image layout will be used as a depth/stencil attachment
-            // Make sure any writes to depth/stencil buffer have been finished
-            imageMemoryBarrier.dstAccessMask =
-                    imageMemoryBarrier.dstAccessMask | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            break;
+    inOutTexture.residentBaseMip = baseMip;
+    inOutTexture.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    inOutTexture.descriptor.imageView = inOutTexture.view;
+    inOutTexture.descriptor.sampler = gfx_samplers()->samplers[inOutTexture.imageSamplerType];
+    inOutTexture.descriptor.imageLayout = inOutTexture.layout;
+}
+
+static VkDeviceSize gfx_texture_subresources_size(const RawImage &rawImage, const uint32_t firstMip, const uint32_t endMip, const uint32_t layerCount) {
+    VkDeviceSize size = 0;
+    for (uint32_t mip = firstMip; mip < endMip; ++mip) {
+        size += gfx_texture_align_copy_size(rawImage.mipDataSizes[mip]) * layerCount;
+    }
+    return size;
+}
+
+// copies source mips [firstMip, endMip) of layers [firstLayer, firstLayer + layerCount) out of the mapped file with a
+// single staging reservation and a region per layer per mip.
+static GfxUploadHandle gfx_texture_upload_subresources(const VkImage image, const uint32_t imageBaseMip, const RawImage &rawImage,
+                                                       const uint32_t firstMip, const uint32_t endMip,
+                                                       const uint32_t firstLayer, const uint32_t layerCount) {
+    const GfxUploadStaging staging = gfx_upload_reserve_staging(gfx_texture_subresources_size(rawImage, firstMip, endMip, layerCount));
+
+    const uint32_t mipRangeCount = endMip - firstMip;
+    const uint32_t regionCount = mipRangeCount * layerCount;
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    VkBufferImageCopy *bufferCopyRegions = (VkBufferImageCopy *) mem_arena_zalloc(arenaScope.arena, regionCount * sizeof(VkBufferImageCopy));
+    VkDeviceSize offset = 0;
+    for (uint32_t layerOffset = 0; layerOffset < layerCount; ++layerOffset) {
+        const uint32_t layer = firstLayer + layerOffset;
+        for (uint32_t mip = firstMip; mip < endMip; ++mip) {
+            memcpy(staging.mapped + offset, raw_image_subresource_data(rawImage, layer, mip), rawImage.mipDataSizes[mip]);
+
+            VkBufferImageCopy &bufferCopyRegion = bufferCopyRegions[layerOffset * mipRangeCount + (mip - firstMip)];
+            bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            bufferCopyRegion.imageSubresource.mipLevel = mip - imageBaseMip;
+            bufferCopyRegion.imageSubresource.baseArrayLayer = layer;
+            bufferCopyRegion.imageSubresource.layerCount = 1;
+            bufferCopyRegion.imageExtent.width = std::max(1u, rawImage.width >> mip);
+            bufferCopyRegion.imageExtent.height = std::max(1u, rawImage.height >> mip);
+            bufferCopyRegion.imageExtent.depth = std::max(1u, rawImage.depth >> mip);
+            bufferCopyRegion.bufferOffset = offset;
+            offset += gfx_texture_align_copy_size(rawImage.mipDataSizes[mip]);
+        }
+    }
+
+    VkImageSubresourceRange subresourceRange = {};
+    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresourceRange.baseMipLevel = firstMip - imageBaseMip;
+    subresourceRange.levelCount = mipRangeCount;
+    subresourceRange.baseArrayLayer = firstLayer;
+    subresourceRange.layerCount = layerCount;
+
+    return gfx_upload_image(image, subresourceRange, staging, bufferCopyRegions, regionCount, GFX_UPLOAD_IMAGE_WHOLE);
+}
+
+// copies a single subresource larger than a staging reservation in bands, runs of whole depth slices while one slice
+// fits and runs of block rows within a slice otherwise. Each band is its own reservation and region.
+static GfxUploadHandle gfx_texture_upload_subresource_bands(const VkImage image, const uint32_t imageBaseMip, const RawImage &rawImage, const uint32_t mip, const uint32_t layer) {
+    const uint32_t width = std::max(1u, rawImage.width >> mip);
+    const uint32_t height = std::max(1u, rawImage.height >> mip);
+    const uint32_t depth = std::max(1u, rawImage.depth >> mip);
+    const uint32_t blockExtent = gfx_texture_block_extent(rawImage.textureFormat);
+    const uint32_t blockRows = (height + blockExtent - 1) / blockExtent;
+    const VkDeviceSize sliceSize = rawImage.mipDataSizes[mip] / depth;
+    const VkDeviceSize blockRowSize = sliceSize / blockRows;
+
+    const VkDeviceSize maxStagingSize = gfx_upload_max_staging_size();
+    const bool sliceBands = sliceSize <= maxStagingSize;
+    const uint32_t slicesPerBand = sliceBands ? (uint32_t) std::min<VkDeviceSize>(maxStagingSize / sliceSize, depth) : 1;
+    const uint32_t rowsPerBand = sliceBands ? blockRows : (uint32_t) (maxStagingSize / blockRowSize);
+    ASSERT_MSG(rowsPerBand > 0, "Err: a block row of mip %u is larger than the staging ring allows", mip);
+
+    VkImageSubresourceRange subresourceRange = {};
+    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresourceRange.baseMipLevel = mip - imageBaseMip;
+    subresourceRange.levelCount = 1;
+    subresourceRange.baseArrayLayer = layer;
+    subresourceRange.layerCount = 1;
 
-        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-            // Image will be read in a shader (sampler, input attachment)
-            // Make sure any writes to the image have been finished
-            if (imageMemoryBarrier.srcAccessMask == 0) {
-                imageMemoryBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    const uint8_t *source = (const uint8_t *) raw_image_subresource_data(rawImage, layer, mip);
+    GfxUploadHandle handle = GFX_UPLOAD_INVALID_HANDLE;
+    for (uint32_t slice = 0; slice < depth; slice += slicesPerBand) {
+        const uint32_t sliceCount = std::min(slicesPerBand, depth - slice);
+        for (uint32_t row = 0; row < blockRows; row += rowsPerBand) {
+            const uint32_t rowCount = std::min(rowsPerBand, blockRows - row);
+            const VkDeviceSize bandSize = sliceBands ? sliceSize * sliceCount : blockRowSize * rowCount;
+            const GfxUploadStaging staging = gfx_upload_reserve_staging(gfx_texture_align_copy_size(bandSize));
+            memcpy(staging.mapped, source + slice * sliceSize + row * blockRowSize, bandSize);
+
+            VkBufferImageCopy bufferCopyRegion = {};
+            bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            bufferCopyRegion.imageSubresource.mipLevel = mip - imageBaseMip;
+            bufferCopyRegion.imageSubresource.baseArrayLayer = layer;
+            bufferCopyRegion.imageSubresource.layerCount = 1;
+            bufferCopyRegion.imageOffset = {0, (int32_t) (row * blockExtent), (int32_t) slice};
+            // the last band may end in a partial block, its extent stops at the mip edge.
+            bufferCopyRegion.imageExtent.width = width;
+            bufferCopyRegion.imageExtent.height = std::min(rowCount * blockExtent, height - row * blockExtent);
+            bufferCopyRegion.imageExtent.depth = sliceCount;
+            bufferCopyRegion.bufferOffset = 0;
+
+            const bool firstBand = slice == 0 && row == 0;
+            const bool lastBand = slice + sliceCount == depth && row + rowCount == blockRows;
+            const uint8_t flags = (firstBand ? GFX_UPLOAD_IMAGE_BEGIN : 0) | (lastBand ? GFX_UPLOAD_IMAGE_END : 0);
+            handle = gfx_upload_image(image, subresourceRange, staging, &bufferCopyRegion, 1, flags);
+        }
+    }
+    return handle;
+}
+
+// uploads mips [firstMip, endMip) of every layer and leaves them in SHADER_READ_ONLY_OPTIMAL once the returned handle
+// completes. Ranges too large for one staging reservation are split into runs of mips within a layer, a single
+// subresource that still doesn't fit is split into bands.
+static GfxUploadHandle gfx_texture_upload_mip_range(const VkImage image, const uint32_t imageBaseMip, const RawImage &rawImage, const uint32_t firstMip, const uint32_t endMip) {
+    const VkDeviceSize maxStagingSize = gfx_upload_max_staging_size();
+    if (gfx_texture_subresources_size(rawImage, firstMip, endMip, rawImage.arrayLayers) <= maxStagingSize) {
+        return gfx_texture_upload_subresources(image, imageBaseMip, rawImage, firstMip, endMip, 0, rawImage.arrayLayers);
+    }
+
+    GfxUploadHandle handle = GFX_UPLOAD_INVALID_HANDLE;
+    for (uint32_t layer = 0; layer < rawImage.arrayLayers; ++layer) {
+        uint32_t runFirstMip = firstMip;
+        while (runFirstMip < endMip) {
+            if (gfx_texture_subresources_size(rawImage, runFirstMip, runFirstMip + 1, 1) > maxStagingSize) {
+                handle = gfx_texture_upload_subresource_bands(image, imageBaseMip, rawImage, runFirstMip, layer);
+                runFirstMip++;
+                continue;
             }
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            break;
-        default:
-            // Other source layouts aren't handled (yet)
-            break;
+            uint32_t runEndMip = runFirstMip + 1;
+            while (runEndMip < endMip && gfx_texture_subresources_size(rawImage, runFirstMip, runEndMip + 1, 1) <= maxStagingSize) {
+                runEndMip++;
+            }
+            handle = gfx_texture_upload_subresources(image, imageBaseMip, rawImage, runFirstMip, runEndMip, layer, 1);
+            runFirstMip = runEndMip;
+        }
+    }
+    return handle;
+}
+
+static uint32_t gfx_texture_streaming_find_db_texture(const VkImage image) {
+    const uint32_t textureCount = db_get_texture_count();
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        if (db_valid_texture(i) && db_get_texture(i)->image == image) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+// sky materials bake the texture view into their descriptor set, rewrite the ones sampling this texture in place. Lit
+// materials go through the bindless array, gfx_bindless_update picks the new view up on its own.
+static void gfx_texture_streaming_rebind_materials(const uint32_t textureIndex, const GfxTexture &texture) {
+    const uint32_t skyMaterialCount = db_get_sky_material_count();
+    for (uint32_t i = 0; i < skyMaterialCount; ++i) {
+        if (!db_valid_sky_material(i) || db_get_sky_material(i)->octahedralMapIndex != textureIndex) {
+            continue;
+        }
+        const VkWriteDescriptorSet write = gfx_descriptor_set_write(*db_get_descriptor_set(db_get_sky_material(i)->descriptorSetIndex), VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &texture.descriptor, 1);
+        vkUpdateDescriptorSets(g_vulkanBackend.device, 1, &write, 0, nullptr);
+    }
+}
+
+static void gfx_texture_streaming_remove_job(const uint32_t jobIndex) {
+    unload_dds_image_mapped(&s_gfxTextureStreaming.jobs[jobIndex].rawImage);
+    // shift rather than swap so textures keep streaming in the order they were requested.
+    for (uint32_t i = jobIndex + 1; i < s_gfxTextureStreaming.jobCount; ++i) {
+        s_gfxTextureStreaming.jobs[i - 1] = s_gfxTextureStreaming.jobs[i];
     }
+    s_gfxTextureStreaming.jobCount--;
+}
+
+static void gfx_texture_streaming_cancel(const VkImage image) {
+    for (uint32_t i = 0; i < s_gfxTextureStreaming.jobCount; ++i) {
+        if (s_gfxTextureStreaming.jobs[i].image == image) {
+            // the transfer queue may still be writing into the image.
+            gfx_upload_wait(s_gfxTextureStreaming.jobs[i].pendingUpload);
+            gfx_texture_streaming_remove_job(i);
+            return;
+        }
+    }
+}
+
+static void gfx_texture_retire(const VkImageView view, const VkImage image, const GfxAllocation &allocation) {
+    ASSERT_MSG(s_gfxTextureStreaming.retiredCount < GFX_TEXTURE_MAX_RETIRED, "Err: too many retired texture resources");
+    s_gfxTextureStreaming.retired[s_gfxTextureStreaming.retiredCount++] = {
+            .view = view,
+            .image = image,
+            .allocation = allocation,
+            .frame = gfx_current_frame(),
+    };
+}
+
+// gfx_update waits on the frame fence of the current slot before streaming, which also covers every frame submitted
+// before the last one that used the slot.
+static void gfx_texture_destroy_retired(const bool all) {
+    uint32_t destroyCount = 0;
+    while (destroyCount < s_gfxTextureStreaming.retiredCount &&
+           (all || s_gfxTextureStreaming.retired[destroyCount].frame + BEET_BUFFER_COUNT <= gfx_current_frame())) {
+        GfxTextureRetired &retired = s_gfxTextureStreaming.retired[destroyCount];
+        vkDestroyImageView(g_vulkanBackend.device, retired.view, nullptr);
+        vkDestroyImage(g_vulkanBackend.device, retired.image, nullptr);
+        gfx_memory_free(retired.allocation);
+        destroyCount++;
+    }
+    s_gfxTextureStreaming.retiredCount -= destroyCount;
+    memmove(&s_gfxTextureStreaming.retired[0], &s_gfxTextureStreaming.retired[destroyCount], sizeof(GfxTextureRetired) * s_gfxTextureStreaming.retiredCount);
+}
 
-    // Put barrier inside setup command buffer
-    vkCmdPipelineBarrier(
-            cmdbuffer,
-            srcStageMask,
-            dstStageMask,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &imageMemoryBarrier);
+static void gfx_texture_release_image(GfxTexture &gfxTexture) {
+    gfx_texture_streaming_cancel(gfxTexture.image);
+    vkDestroyImageView(g_vulkanBackend.device, gfxTexture.view, nullptr);
+    vkDestroyImage(g_vulkanBackend.device, gfxTexture.image, nullptr);
+    gfx_memory_free(gfxTexture.allocation);
+}
+
+// the restored image takes over the db slot once its tail is resident, the view is created by the caller as for any
+// completed streaming step. The evicted image is retired, frames in flight may still sample it.
+static void gfx_texture_streaming_swap_restored(GfxTextureStreamJob &job) {
+    GfxTexture &texture = *db_get_texture(job.restoreTextureIndex);
+    gfx_texture_retire(texture.view, texture.image, texture.allocation);
+    texture.image = job.image;
+    texture.allocation = job.restoreAllocation;
+    texture.view = VK_NULL_HANDLE;
+    texture.mipCount = job.rawImage.mipMapCount;
+    texture.imageBaseMip = 0;
+    job.restoreTextureIndex = UINT32_MAX;
+    job.restoreAllocation = {};
+}
+
+// the db texture was released while its restore was still uploading, nothing references the new image yet.
+static void gfx_texture_streaming_drop_restore(const uint32_t jobIndex) {
+    GfxTextureStreamJob &job = s_gfxTextureStreaming.jobs[jobIndex];
+    gfx_upload_wait(job.pendingUpload);
+    vkDestroyImage(g_vulkanBackend.device, job.image, nullptr);
+    gfx_memory_free(job.restoreAllocation);
+    gfx_texture_streaming_remove_job(jobIndex);
 }
 //======================================================================================================================
 
 //===API================================================================================================================
-void gfx_texture_create_immediate_dds(const char *path, GfxTexture &inOutTexture) {
+GfxUploadHandle gfx_texture_create_dds(const char *path, GfxTexture &inOutTexture) {
 #if BEET_CONVERT_ON_DEMAND
     gfx_convert_texture_dds(path);
 #endif
@@ -150,9 +393,10 @@ void gfx_texture_create_immediate_dds(const char *path, GfxTexture &inOutTexture
         inOutTexture.imageSamplerType = TextureSamplerType::LinearRepeat;
     }
 
+    // the file is mapped rather than read, the only copy of the pixel payload on the cpu side is into the staging buffer.
     RawImage myImage{};
-    load_dds_image_alloc(path, &myImage);
-    auto rawImageData = (unsigned char *) myImage.data;
+    load_dds_image_mapped(path, &myImage);
+    snprintf(inOutTexture.sourcePath, MAX_PATH, "%s", path);
 
 #if BEET_DEBUG
     sprintf(inOutTexture.debug_name, "%s", path);
@@ -163,170 +407,228 @@ void gfx_texture_create_immediate_dds(const char *path, GfxTexture &inOutTexture
     inOutTexture.debug_depth = myImage.depth;
 #endif
 
-    const uint32_t sizeX = myImage.width;
-    const uint32_t sizeY = myImage.height;
-    const uint32 mipMapCount = myImage.mipMapCount;
-    const VkDeviceSize imageSize = myImage.dataSize;
     const VkFormat format = gfx_utils_beet_image_format_to_vk(myImage.textureFormat);
+    const bool created = gfx_texture_create_device_image(myImage, format, 0, inOutTexture);
+    ASSERT_MSG(created, "Err: out of device memory for %s", path);
+    const GfxUploadHandle upload = gfx_texture_upload_mip_range(inOutTexture.image, 0, myImage, 0, myImage.mipMapCount);
+    gfx_texture_create_view(inOutTexture, format, 0);
+
+    // the payload has already been copied into staging, the mapping isn't needed for the upload to complete.
+    unload_dds_image_mapped(&myImage);
+    return upload;
+}
 
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(g_vulkanBackend.physicalDevice, format, &formatProperties);
-
-    VkMemoryAllocateInfo memoryAllocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    VkMemoryRequirements memoryRequirements;
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-
-    VkBufferCreateInfo stagingBufInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    stagingBufInfo.size = imageSize;
-    stagingBufInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    stagingBufInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    const VkResult createStageBuffRes = vkCreateBuffer(g_vulkanBackend.device, &stagingBufInfo, nullptr, &stagingBuffer);
-    ASSERT(createStageBuffRes == VK_SUCCESS);
-
-    vkGetBufferMemoryRequirements(g_vulkanBackend.device, stagingBuffer, &memoryRequirements);
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    memoryAllocateInfo.memoryTypeIndex = gfx_utils_get_memory_type(memoryRequirements.memoryTypeBits,
-                                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                                                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    const VkResult memAllocResult = vkAllocateMemory(g_vulkanBackend.device, &memoryAllocateInfo, nullptr, &stagingMemory);
-    ASSERT(memAllocResult == VK_SUCCESS);
-
-    const VkResult memBindResult = vkBindBufferMemory(g_vulkanBackend.device, stagingBuffer, stagingMemory, 0);
-    ASSERT(memBindResult == VK_SUCCESS);
-
-    // map raw image data to staging buffer
-    uint8_t *data;
-    const VkResult mapResult(vkMapMemory(g_vulkanBackend.device, stagingMemory, 0, memoryRequirements.size, 0, (void **) &data));
-    ASSERT(mapResult == VK_SUCCESS)
-
-    memcpy(data, rawImageData, imageSize);
-    vkUnmapMemory(g_vulkanBackend.device, stagingMemory);
-
-    VkBufferImageCopy *bufferCopyRegions = (VkBufferImageCopy *) mem_zalloc(mipMapCount * sizeof(VkBufferImageCopy));
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < mipMapCount; i++) {
-        // set up a buffer image copy structure for the current mip level
-        VkBufferImageCopy bufferCopyRegion = {};
-        bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        bufferCopyRegion.imageSubresource.mipLevel = i;
-        bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-        bufferCopyRegion.imageSubresource.layerCount = 1;
-        bufferCopyRegion.imageExtent.width = myImage.width >> i;
-        bufferCopyRegion.imageExtent.height = myImage.height >> i;
-        bufferCopyRegion.imageExtent.depth = 1;
-        bufferCopyRegion.bufferOffset = offset;
-        bufferCopyRegions[i] = bufferCopyRegion;
-        offset += myImage.mipDataSizes[i];
-    }
+void gfx_texture_create_immediate_dds(const char *path, GfxTexture &inOutTexture) {
+    gfx_upload_wait(gfx_texture_create_dds(path, inOutTexture));
+}
 
-    VkImageCreateInfo imageCreateInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageCreateInfo.extent.width = sizeX;
-    imageCreateInfo.extent.height = sizeY;
-    imageCreateInfo.extent.depth = 1;
-    imageCreateInfo.mipLevels = mipMapCount;
-    imageCreateInfo.arrayLayers = 1;
-    imageCreateInfo.format = format;
-    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageCreateInfo.flags = 0;
+void gfx_texture_create_streaming_dds(const char *path, GfxTexture &inOutTexture) {
+#if BEET_CONVERT_ON_DEMAND
+    gfx_convert_texture_dds(path);
+#endif
 
-    const VkResult createImageRes = vkCreateImage(g_vulkanBackend.device, &imageCreateInfo, nullptr, &inOutTexture.image);
-    ASSERT(createImageRes == VK_SUCCESS);
+    if (inOutTexture.imageSamplerType == TextureSamplerType::Invalid) {
+        inOutTexture.imageSamplerType = TextureSamplerType::LinearRepeat;
+    }
 
-    vkGetImageMemoryRequirements(g_vulkanBackend.device, inOutTexture.image, &memoryRequirements);
+    RawImage rawImage{};
+    load_dds_image_mapped(path, &rawImage);
+    snprintf(inOutTexture.sourcePath, MAX_PATH, "%s", path);
+
+#if BEET_DEBUG
+    sprintf(inOutTexture.debug_name, "%s", path);
+    inOutTexture.debug_textureFormat = rawImage.textureFormat;
+    inOutTexture.debug_mipMapCount = rawImage.mipMapCount;
+    inOutTexture.debug_width = rawImage.width;
+    inOutTexture.debug_height = rawImage.height;
+    inOutTexture.debug_depth = rawImage.depth;
+#endif
 
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    memoryAllocateInfo.memoryTypeIndex = gfx_utils_get_memory_type(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    const VkFormat format = gfx_utils_beet_image_format_to_vk(rawImage.textureFormat);
+    const bool created = gfx_texture_create_device_image(rawImage, format, 0, inOutTexture);
+    ASSERT_MSG(created, "Err: out of device memory for %s", path);
 
-    const VkResult memAllocRes = vkAllocateMemory(g_vulkanBackend.device, &memoryAllocateInfo, nullptr, &inOutTexture.deviceMemory);
-    ASSERT(memAllocRes == VK_SUCCESS);
+    const uint32_t tailBaseMip = inOutTexture.tailBaseMip;
+    // the tail is small, waiting on it keeps the texture sampleable as soon as this returns.
+    gfx_upload_wait(gfx_texture_upload_mip_range(inOutTexture.image, 0, rawImage, tailBaseMip, rawImage.mipMapCount));
+    gfx_texture_create_view(inOutTexture, format, tailBaseMip);
 
-    const VkResult bindRes = vkBindImageMemory(g_vulkanBackend.device, inOutTexture.image, inOutTexture.deviceMemory, 0);
-    ASSERT(bindRes == VK_SUCCESS);
+    if (tailBaseMip == 0) {
+        unload_dds_image_mapped(&rawImage);
+        return;
+    }
+    ASSERT_MSG(s_gfxTextureStreaming.jobCount < MAX_DB_GFX_TEXTURES, "Err: too many textures streaming, failed to queue %s", path);
+    s_gfxTextureStreaming.jobs[s_gfxTextureStreaming.jobCount++] = {
+            .image = inOutTexture.image,
+            .format = format,
+            .rawImage = rawImage,
+            .residentBaseMip = tailBaseMip,
+            .pendingUpload = GFX_UPLOAD_INVALID_HANDLE,
+            .pendingBaseMip = tailBaseMip,
+            .restoreTextureIndex = UINT32_MAX,
+            .restoreAllocation = {},
+    };
+}
 
-    VkImageSubresourceRange subresourceRange = {};
-    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    subresourceRange.baseMipLevel = 0;
-    subresourceRange.levelCount = mipMapCount;
-    subresourceRange.layerCount = 1;
+void gfx_texture_streaming_update() {
+    BEET_PROFILE_SCOPE("gfx_texture_streaming_update");
+    gfx_texture_destroy_retired(false);
+    VkDeviceSize budget = s_gfxTextureStreaming.frameBudgetBytes;
+    uint32_t jobIndex = 0;
+    while (jobIndex < s_gfxTextureStreaming.jobCount) {
+        GfxTextureStreamJob &job = s_gfxTextureStreaming.jobs[jobIndex];
+        if (job.restoreTextureIndex != UINT32_MAX) {
+            if (!db_valid_texture(job.restoreTextureIndex)) {
+                gfx_texture_streaming_drop_restore(jobIndex);
+                continue;
+            }
+            if (!gfx_upload_is_complete(job.pendingUpload)) {
+                ++jobIndex;
+                continue;
+            }
+            gfx_texture_streaming_swap_restored(job);
+        }
+        // textures are only published once they have a db slot, their view and materials are rewritten below.
+        const uint32_t textureIndex = gfx_texture_streaming_find_db_texture(job.image);
+        if (textureIndex == UINT32_MAX) {
+            ++jobIndex;
+            continue;
+        }
+
+        if (job.pendingUpload != GFX_UPLOAD_INVALID_HANDLE) {
+            if (!gfx_upload_is_complete(job.pendingUpload)) {
+                ++jobIndex;
+                continue;
+            }
+            // a restore swapped in above has already retired the old view together with its image.
+            GfxTexture &texture = *db_get_texture(textureIndex);
+            if (texture.view != VK_NULL_HANDLE) {
+                gfx_texture_retire(texture.view, VK_NULL_HANDLE, {});
+            }
+            gfx_texture_create_view(texture, job.format, job.pendingBaseMip);
+            gfx_texture_streaming_rebind_materials(textureIndex, texture);
+            job.residentBaseMip = job.pendingBaseMip;
+            job.pendingUpload = GFX_UPLOAD_INVALID_HANDLE;
+
+            if (job.residentBaseMip == 0) {
+                gfx_texture_streaming_remove_job(jobIndex);
+                continue;
+            }
+        }
+
+        if (budget == 0) {
+            ++jobIndex;
+            continue;
+        }
+        // always take at least one mip so a mip larger than the whole budget still lands on its own frame.
+        uint32_t newBaseMip = job.residentBaseMip;
+        VkDeviceSize uploadSize = 0;
+        while (newBaseMip > 0) {
+            const VkDeviceSize mipSize = gfx_texture_align_copy_size(job.rawImage.mipDataSizes[newBaseMip - 1]) * job.rawImage.arrayLayers;
+            if (uploadSize > 0 && uploadSize + mipSize > budget) {
+                break;
+            }
+            uploadSize += mipSize;
+            newBaseMip--;
+        }
+        job.pendingUpload = gfx_texture_upload_mip_range(job.image, 0, job.rawImage, newBaseMip, job.residentBaseMip);
+        job.pendingBaseMip = newBaseMip;
+        budget = uploadSize >= budget ? 0 : budget - uploadSize;
+        ++jobIndex;
+    }
+}
 
-    gfx_command_begin_immediate_recording();
-
-    set_image_layout(
-            g_vulkanBackend.immediateCommandBuffer,
-            inOutTexture.image,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            subresourceRange,
-            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
-    );
-
-    // Copy mips from staging buffer
-    vkCmdCopyBufferToImage(
-            g_vulkanBackend.immediateCommandBuffer,
-            stagingBuffer,
-            inOutTexture.image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            static_cast<uint32_t>(mipMapCount),
-            bufferCopyRegions
-    );
-
-    set_image_layout(
-            g_vulkanBackend.immediateCommandBuffer,
-            inOutTexture.image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            subresourceRange,
-            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
-    );
+void gfx_texture_streaming_set_frame_budget(const VkDeviceSize budgetBytes) {
+    s_gfxTextureStreaming.frameBudgetBytes = budgetBytes;
+}
 
-    inOutTexture.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+uint32_t gfx_texture_streaming_pending_count() {
+    return s_gfxTextureStreaming.jobCount;
+}
 
-    gfx_command_end_immediate_recording();
+void gfx_texture_evict_mips(const uint32_t textureIndex, const uint32_t newTopMip) {
+    BEET_PROFILE_SCOPE("gfx_texture_evict_mips");
+    const GfxTexture &texture = *db_get_texture(textureIndex);
+    ASSERT_MSG(newTopMip > texture.imageBaseMip + texture.residentBaseMip && newTopMip <= texture.tailBaseMip,
+               "Err: can't evict %s down to mip %u", texture.sourcePath, newTopMip);
+
+    // mips are reloaded from the dds rather than copied out of the old image, the upload path already handles it.
+    RawImage rawImage{};
+    load_dds_image_mapped(texture.sourcePath, &rawImage);
+    const VkFormat format = gfx_utils_beet_image_format_to_vk(rawImage.textureFormat);
+
+    // the old image goes first so its memory can back the reduced one, evictions run when device memory is short.
+    GfxTexture reduced = texture;
+    gfx_texture_release_image(*db_get_texture(textureIndex));
+    const bool created = gfx_texture_create_device_image(rawImage, format, newTopMip, reduced);
+    ASSERT_MSG(created, "Err: out of device memory for the reduced %s", reduced.sourcePath);
+    gfx_upload_wait(gfx_texture_upload_mip_range(reduced.image, newTopMip, rawImage, newTopMip, rawImage.mipMapCount));
+    gfx_texture_create_view(reduced, format, 0);
+    unload_dds_image_mapped(&rawImage);
+
+    *db_get_texture(textureIndex) = reduced;
+    gfx_bindless_invalidate(textureIndex);
+    gfx_texture_streaming_rebind_materials(textureIndex, reduced);
+}
 
-    vkDestroyBuffer(g_vulkanBackend.device, stagingBuffer, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, stagingMemory, nullptr);
+bool gfx_texture_restore_mips(const uint32_t textureIndex) {
+    BEET_PROFILE_SCOPE("gfx_texture_restore_mips");
+    const GfxTexture &texture = *db_get_texture(textureIndex);
+    ASSERT(texture.imageBaseMip > 0 && !gfx_texture_restore_pending(textureIndex));
 
-    VkImageViewCreateInfo view{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-    view.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    view.format = gfx_utils_beet_image_format_to_vk(myImage.textureFormat);;
-    view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    view.subresourceRange.baseMipLevel = 0;
-    view.subresourceRange.baseArrayLayer = 0;
-    view.subresourceRange.layerCount = 1;
-    view.subresourceRange.levelCount = mipMapCount;
-    view.image = inOutTexture.image;
+    RawImage rawImage{};
+    load_dds_image_mapped(texture.sourcePath, &rawImage);
+    const VkFormat format = gfx_utils_beet_image_format_to_vk(rawImage.textureFormat);
 
-    const VkResult imageViewRes = vkCreateImageView(g_vulkanBackend.device, &view, nullptr, &inOutTexture.view);
-    ASSERT(imageViewRes == VK_SUCCESS);
+    // the evicted image keeps being sampled while the tail uploads, gfx_texture_streaming_update swaps the new one in.
+    GfxTexture restored = texture;
+    if (!gfx_texture_create_device_image(rawImage, format, 0, restored)) {
+        unload_dds_image_mapped(&rawImage);
+        return false;
+    }
+    const uint32_t tailBaseMip = restored.tailBaseMip;
+    ASSERT_MSG(s_gfxTextureStreaming.jobCount < MAX_DB_GFX_TEXTURES, "Err: too many textures streaming, failed to queue %s", texture.sourcePath);
+    s_gfxTextureStreaming.jobs[s_gfxTextureStreaming.jobCount++] = {
+            .image = restored.image,
+            .format = format,
+            .rawImage = rawImage,
+            .residentBaseMip = rawImage.mipMapCount,
+            .pendingUpload = gfx_texture_upload_mip_range(restored.image, 0, rawImage, tailBaseMip, rawImage.mipMapCount),
+            .pendingBaseMip = tailBaseMip,
+            .restoreTextureIndex = textureIndex,
+            .restoreAllocation = restored.allocation,
+    };
+    return true;
+}
 
-    inOutTexture.descriptor.imageView = inOutTexture.view;
-    inOutTexture.descriptor.sampler = gfx_samplers()->samplers[inOutTexture.imageSamplerType];
-    inOutTexture.descriptor.imageLayout = inOutTexture.layout;
-    
-    mem_free(myImage.data);
-    mem_free(bufferCopyRegions);
+bool gfx_texture_restore_pending(const uint32_t textureIndex) {
+    for (uint32_t i = 0; i < s_gfxTextureStreaming.jobCount; ++i) {
+        if (s_gfxTextureStreaming.jobs[i].restoreTextureIndex == textureIndex) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void gfx_texture_cleanup(GfxTexture &gfxTexture) {
-    vkDestroyImageView(g_vulkanBackend.device, gfxTexture.view, nullptr);
-    vkDestroyImage(g_vulkanBackend.device, gfxTexture.image, nullptr);
-    vkFreeMemory(g_vulkanBackend.device, gfxTexture.deviceMemory, nullptr);
+    gfx_texture_release_image(gfxTexture);
     gfxTexture = {};
+    // The owning db slot is released separately via db_remove_texture, which puts it back on the pool free list.
+}
+//======================================================================================================================
 
-    //TODO:GFX We don't re-add this as a free slot in the texture pool i.e.
-    //we could address this pretty simply in a few ways.
-    //create free-list for each pool and next time we try and create a new texture to check if any free list spaces are free
-    //we move the last image loaded into the newly free position and fix up and dependency, this will break any cached references.
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_cleanup_texture_streaming() {
+    vkWaitForFences(g_vulkanBackend.device, BEET_BUFFER_COUNT, g_vulkanBackend.frameFences, true, UINT64_MAX);
+    gfx_texture_destroy_retired(true);
+    while (s_gfxTextureStreaming.jobCount > 0) {
+        const uint32_t jobIndex = s_gfxTextureStreaming.jobCount - 1;
+        if (s_gfxTextureStreaming.jobs[jobIndex].restoreTextureIndex != UINT32_MAX) {
+            gfx_texture_streaming_drop_restore(jobIndex);
+            continue;
+        }
+        gfx_texture_streaming_remove_job(jobIndex);
+    }
+    s_gfxTextureStreaming = {};
 }
 //======================================================================================================================
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include <beet_gfx/gfx_timestamps.h>
+#include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_interface.h>
+
+#include <beet_shared/assert.h>
+#include <beet_shared/log.h>
+#include <beet_shared/memory.h>
+
+//===INTERNAL_STRUCTS===================================================================================================
+constexpr uint32_t GFX_TIMESTAMP_QUERY_COUNT = GFX_GPU_PASS_COUNT * 2;
+
+static struct VulkanTimestamps {
+    bool supported = {false};
+    double nsPerTick = {1.0};
+    uint64_t validBitsMask = {UINT64_MAX};
+
+    VkQueryPool queryPools[BEET_BUFFER_COUNT] = {VK_NULL_HANDLE};
+    // bit per pass with both queries written since the pool was last reset, only these are safe to read back.
+    uint32_t writtenPassMasks[BEET_BUFFER_COUNT] = {};
+    uint32_t currentPool = {0};
+
+    GfxGpuPassTiming passTimings[GFX_GPU_PASS_COUNT] = {};
+} s_gfxTimestamps;
+
+static_assert(GFX_GPU_PASS_COUNT <= 32, "writtenPassMasks stores a bit per pass");
+
+extern VulkanBackend g_vulkanBackend;
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static void gfx_timestamps_add_sample(GfxGpuPassTiming &timing, const float ms) {
+    timing.history[timing.historyHead] = ms;
+    timing.historyHead = (timing.historyHead + 1) % GFX_GPU_TIMING_HISTORY_SIZE;
+    timing.sampleCount = timing.sampleCount < GFX_GPU_TIMING_HISTORY_SIZE ? timing.sampleCount + 1 : GFX_GPU_TIMING_HISTORY_SIZE;
+
+    float sum = 0.0f;
+    float max = 0.0f;
+    for (uint32_t i = 0; i < timing.sampleCount; ++i) {
+        sum += timing.history[i];
+        max = timing.history[i] > max ? timing.history[i] : max;
+    }
+    timing.lastMs = ms;
+    timing.averageMs = sum / (float) timing.sampleCount;
+    timing.maxMs = max;
+}
+
+static void gfx_timestamps_read_pool(const uint32_t poolIndex) {
+    const uint32_t writtenMask = s_gfxTimestamps.writtenPassMasks[poolIndex];
+    for (uint32_t pass = 0; pass < GFX_GPU_PASS_COUNT; ++pass) {
+        if ((writtenMask & (1u << pass)) == 0) {
+            continue;
+        }
+        // [begin, beginAvailable, end, endAvailable], no WAIT flag so this returns immediately with VK_NOT_READY if pending.
+        uint64_t results[4] = {};
+        vkGetQueryPoolResults(
+                g_vulkanBackend.device,
+                s_gfxTimestamps.queryPools[poolIndex],
+                pass * 2, 2,
+                sizeof(results), results,
+                sizeof(uint64_t) * 2,
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+        if (results[1] == 0 || results[3] == 0) {
+            continue;
+        }
+        const uint64_t begin = results[0] & s_gfxTimestamps.validBitsMask;
+        const uint64_t end = results[2] & s_gfxTimestamps.validBitsMask;
+        const uint64_t ticks = (end - begin) & s_gfxTimestamps.validBitsMask;
+        gfx_timestamps_add_sample(s_gfxTimestamps.passTimings[pass], (float) ((double) ticks * s_gfxTimestamps.nsPerTick / 1000000.0));
+    }
+    s_gfxTimestamps.writtenPassMasks[poolIndex] = 0;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void gfx_timestamps_begin_frame(VkCommandBuffer &cmdBuffer) {
+    if (!s_gfxTimestamps.supported) {
+        return;
+    }
+    s_gfxTimestamps.currentPool = gfx_buffer_index();
+    gfx_timestamps_read_pool(s_gfxTimestamps.currentPool);
+    vkCmdResetQueryPool(cmdBuffer, s_gfxTimestamps.queryPools[s_gfxTimestamps.currentPool], 0, GFX_TIMESTAMP_QUERY_COUNT);
+}
+
+void gfx_timestamps_write_begin(VkCommandBuffer &cmdBuffer, const GFX_GPU_PASS pass) {
+    if (!s_gfxTimestamps.supported) {
+        return;
+    }
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, s_gfxTimestamps.queryPools[s_gfxTimestamps.currentPool], pass * 2);
+}
+
+void gfx_timestamps_write_end(VkCommandBuffer &cmdBuffer, const GFX_GPU_PASS pass) {
+    if (!s_gfxTimestamps.supported) {
+        return;
+    }
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, s_gfxTimestamps.queryPools[s_gfxTimestamps.currentPool], pass * 2 + 1);
+    s_gfxTimestamps.writtenPassMasks[s_gfxTimestamps.currentPool] |= (1u << pass);
+}
+
+bool gfx_timestamps_supported() {
+    return s_gfxTimestamps.supported;
+}
+
+const GfxGpuPassTiming &gfx_timestamps_get_pass_timing(const GFX_GPU_PASS pass) {
+    ASSERT(pass < GFX_GPU_PASS_COUNT);
+    return s_gfxTimestamps.passTimings[pass];
+}
+
+const char *gfx_timestamps_pass_name(const GFX_GPU_PASS pass) {
+    switch (pass) {
+        case GFX_GPU_PASS_FRAME:
+            return "frame";
+        case GFX_GPU_PASS_RESOLVE_DEPTH:
+            return "resolve depth";
+        case GFX_GPU_PASS_SKY:
+            return "sky";
+        case GFX_GPU_PASS_LIT:
+            return "lit";
+        case GFX_GPU_PASS_TRIANGLE_STRIP:
+            return "triangle strip";
+        case GFX_GPU_PASS_LINE:
+            return "line";
+        case GFX_GPU_PASS_IMGUI:
+            return "imgui";
+        case GFX_GPU_PASS_RESOLVE_COLOR:
+            return "resolve color";
+        case GFX_GPU_PASS_CULL:
+            return "cull";
+        case GFX_GPU_PASS_COUNT:
+            break;
+    }
+    return "unknown";
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_timestamps() {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(g_vulkanBackend.physicalDevice, &queueFamilyCount, nullptr);
+    VkQueueFamilyProperties *queueFamilies = (VkQueueFamilyProperties *) mem_zalloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount, MSG_GFX);
+    vkGetPhysicalDeviceQueueFamilyProperties(g_vulkanBackend.physicalDevice, &queueFamilyCount, queueFamilies);
+    const uint32_t validBits = queueFamilies[g_vulkanBackend.queueFamilyIndices.graphics].timestampValidBits;
+    mem_free(queueFamilies);
+
+    const float timestampPeriod = g_vulkanBackend.deviceProperties.limits.timestampPeriod;
+    s_gfxTimestamps.supported = validBits != 0 && timestampPeriod > 0.0f;
+    if (!s_gfxTimestamps.supported) {
+        log_warning(MSG_GFX, "gpu timestamps are not supported on the graphics queue, pass timings are disabled\n");
+        return;
+    }
+    s_gfxTimestamps.validBitsMask = validBits >= 64 ? UINT64_MAX : ((1ull << validBits) - 1);
+    s_gfxTimestamps.nsPerTick = (double) timestampPeriod;
+
+    const VkQueryPoolCreateInfo queryPoolInfo = {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = GFX_TIMESTAMP_QUERY_COUNT,
+    };
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        const VkResult queryPoolRes = vkCreateQueryPool(g_vulkanBackend.device, &queryPoolInfo, nullptr, &s_gfxTimestamps.queryPools[i]);
+        ASSERT_MSG(queryPoolRes == VK_SUCCESS, "Err: failed to create timestamp query pool");
+    }
+}
+
+void gfx_cleanup_timestamps() {
+    for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
+        if (s_gfxTimestamps.queryPools[i] != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(g_vulkanBackend.device, s_gfxTimestamps.queryPools[i], nullptr);
+        }
+    }
+    s_gfxTimestamps = {};
+}
+//======================================================================================================================
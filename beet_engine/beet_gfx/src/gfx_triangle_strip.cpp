@@ -7,6 +7,7 @@
 #include <beet_gfx/gfx_samplers.h>
 
 #include <beet_shared/assert.h>
+#include <beet_shared/profiler.h>
 
 #include <beet_math/quat.h>
 
@@ -62,17 +63,12 @@ static void gfx_create_triangle_strip_uniform_buffers() {
                 (sizeof(LinePoint3D) * MAX_POINT_SIZE),
                 nullptr);
         ASSERT(uniformResult == VK_SUCCESS);
-
-        const VkResult mapResult = vkMapMemory(g_vulkanBackend.device, s_triangleStrip.triangleStripUniformBuffers[i].memory, 0, VK_WHOLE_SIZE, 0,
-                                               &s_triangleStrip.triangleStripUniformBuffers[i].mappedData);
-        ASSERT(mapResult == VK_SUCCESS);
     }
 }
 
 static void gfx_cleanup_triangle_strip_uniform_buffers() {
     for (uint32_t i = 0; i < BEET_BUFFER_COUNT; ++i) {
-        vkDestroyBuffer(g_vulkanBackend.device, s_triangleStrip.triangleStripUniformBuffers[i].buffer, nullptr);
-        vkFreeMemory(g_vulkanBackend.device, s_triangleStrip.triangleStripUniformBuffers[i].memory, nullptr);
+        gfx_buffer_cleanup(s_triangleStrip.triangleStripUniformBuffers[i]);
     }
 }
 
@@ -207,6 +203,7 @@ static bool gfx_create_triangle_strip_pipelines(VkPipeline &outLinePipeline) {
 
 //===API================================================================================================================
 void gfx_triangle_strip_draw(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_triangle_strip_draw");
     gfx_triangle_strip_update_material_descriptor(s_triangleStrip.descriptorSets[gfx_buffer_index()]);
     vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_triangleStrip.pipeline);
     vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, s_triangleStrip.pipelineLayout, 0, 1, &s_triangleStrip.descriptorSets[gfx_buffer_index()], 0, nullptr);
@@ -214,6 +211,7 @@ void gfx_triangle_strip_draw(VkCommandBuffer &cmdBuffer) {
         const TriangleStripEntity &lineEntity = s_triangleStripEntityPool[i];
         const uint32_t numberOfPoints = (lineEntity.triangleStripRangeEnd - lineEntity.triangleStripRangeStart);
         vkCmdDraw(cmdBuffer, numberOfPoints, 1, lineEntity.triangleStripRangeStart, 0);
+        gfx_add_draw_calls(1);
     }
     s_pointCount = {0};
     s_triangleStripEntityCount = {0};
@@ -247,22 +245,22 @@ bool gfx_rebuild_triangle_strip_pipeline() {
     return false;
 }
 
-void gfx_triangle_strip_add_segment_immediate(const std::vector<LinePoint3D> &points) {
+void gfx_triangle_strip_add_segment_immediate(const LinePoint3D *points, const uint32_t pointCount) {
     // Ensure there is enough space in the entity pool
     assert(s_triangleStripEntityCount < MAX_TRIANGLE_STRIP_ENTITY_SIZE);
 
     // Ensure there is enough space for the points
-    assert(s_pointCount + points.size() < MAX_POINT_SIZE);
+    assert(s_pointCount + pointCount < MAX_POINT_SIZE);
 
     // Add the triangle strip segment to the entity pool
     s_triangleStripEntityPool[s_triangleStripEntityCount] = {
             .triangleStripRangeStart = s_pointCount,
-            .triangleStripRangeEnd = s_pointCount + static_cast<uint32_t>(points.size()),
+            .triangleStripRangeEnd = s_pointCount + pointCount,
     };
 
     // Add each point to the buffer
-    for (const auto &point: points) {
-        add_point(point);
+    for (uint32_t i = 0; i < pointCount; ++i) {
+        add_point(points[i]);
     }
 
     s_triangleStripEntityCount += 1;
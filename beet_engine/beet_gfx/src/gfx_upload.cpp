@@ -0,0 +1,511 @@
+#include <beet_gfx/gfx_upload.h>
+#include <beet_gfx/gfx_types.h>
+#include <beet_gfx/gfx_utils.h>
+
+#include <beet_shared/assert.h>
+#include <beet_shared/profiler.h>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstring>
+
+//===INTERNAL_STRUCTS===================================================================================================
+struct GfxUploadBatch {
+    uint64_t timelineValue = {GFX_UPLOAD_INVALID_HANDLE}; // value signalled once this batch's copies have landed
+    bool recording = {false};
+
+    VkCommandBuffer transferCmd = {VK_NULL_HANDLE};
+    VkCommandBuffer acquireCmd = {VK_NULL_HANDLE}; // graphics family, only recorded when ownership has to move
+    VkFence acquireFence = {VK_NULL_HANDLE};
+    bool acquirePending = {false};
+
+    uint64_t ringEnd = {0}; // ring position after this batch's last reservation, becomes the tail once it retires
+
+    VkBufferMemoryBarrier bufferAcquires[GFX_UPLOAD_MAX_BARRIERS_PER_BATCH] = {};
+    uint32_t bufferAcquireCount = {0};
+    VkImageMemoryBarrier imageAcquires[GFX_UPLOAD_MAX_BARRIERS_PER_BATCH] = {};
+    uint32_t imageAcquireCount = {0};
+};
+
+// positions only ever grow, the offset into the buffer is position % size.
+struct GfxUploadStagingRing {
+    VkBuffer buffer = {VK_NULL_HANDLE};
+    VkDeviceMemory memory = {VK_NULL_HANDLE};
+    uint8_t *mapped = {nullptr};
+    VkDeviceSize size = {0};
+    uint64_t head = {0};
+    uint64_t tail = {0};
+};
+
+static struct GfxUpload {
+    VkCommandPool transferPool = {VK_NULL_HANDLE};
+    VkCommandPool acquirePool = {VK_NULL_HANDLE};
+    VkSemaphore timeline = {VK_NULL_HANDLE};
+    bool ownershipTransfer = {false}; // transfer and graphics queues belong to different families
+
+    uint64_t submittedValue = {0};
+    uint64_t retiredValue = {0};
+    GfxUploadBatch batches[GFX_UPLOAD_BATCHES_IN_FLIGHT] = {};
+    GfxUploadStagingRing ring = {};
+} s_gfxUpload;
+
+extern VulkanBackend g_vulkanBackend;
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static VkDeviceSize gfx_upload_align(const VkDeviceSize size) {
+    return (size + GFX_UPLOAD_STAGING_ALIGNMENT - 1) & ~(GFX_UPLOAD_STAGING_ALIGNMENT - 1);
+}
+
+// batch values are handed out in order, so the slot a value lives in can be derived from the value itself.
+static GfxUploadBatch &gfx_upload_batch_for_value(const uint64_t value) {
+    return s_gfxUpload.batches[(value - 1) % GFX_UPLOAD_BATCHES_IN_FLIGHT];
+}
+
+static void gfx_upload_create_ring(const VkDeviceSize size) {
+    GfxUploadStagingRing &ring = s_gfxUpload.ring;
+    ASSERT(ring.buffer == VK_NULL_HANDLE);
+    ASSERT_MSG(size % GFX_UPLOAD_STAGING_ALIGNMENT == 0, "Err: staging ring size must be a multiple of %llu", (unsigned long long) GFX_UPLOAD_STAGING_ALIGNMENT);
+
+    VkBufferCreateInfo stagingBufInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    stagingBufInfo.size = size;
+    stagingBufInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    stagingBufInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    const VkResult createStageBuffRes = vkCreateBuffer(g_vulkanBackend.device, &stagingBufInfo, nullptr, &ring.buffer);
+    ASSERT(createStageBuffRes == VK_SUCCESS);
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(g_vulkanBackend.device, ring.buffer, &memoryRequirements);
+    VkMemoryAllocateInfo memoryAllocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    memoryAllocateInfo.allocationSize = memoryRequirements.size;
+    memoryAllocateInfo.memoryTypeIndex = gfx_utils_get_memory_type(memoryRequirements.memoryTypeBits,
+                                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    const VkResult memAllocResult = vkAllocateMemory(g_vulkanBackend.device, &memoryAllocateInfo, nullptr, &ring.memory);
+    ASSERT(memAllocResult == VK_SUCCESS);
+    const VkResult memBindResult = vkBindBufferMemory(g_vulkanBackend.device, ring.buffer, ring.memory, 0);
+    ASSERT(memBindResult == VK_SUCCESS);
+    const VkResult mapResult = vkMapMemory(g_vulkanBackend.device, ring.memory, 0, VK_WHOLE_SIZE, 0, (void **) &ring.mapped);
+    ASSERT(mapResult == VK_SUCCESS);
+    ring.size = size;
+    ring.head = 0;
+    ring.tail = 0;
+}
+
+static void gfx_upload_cleanup_ring() {
+    GfxUploadStagingRing &ring = s_gfxUpload.ring;
+    if (ring.buffer == VK_NULL_HANDLE) {
+        return;
+    }
+    vkUnmapMemory(g_vulkanBackend.device, ring.memory);
+    vkDestroyBuffer(g_vulkanBackend.device, ring.buffer, nullptr);
+    vkFreeMemory(g_vulkanBackend.device, ring.memory, nullptr);
+    ring = {};
+}
+
+// reservations never straddle the end of the buffer, one that would is moved to the start and the gap is skipped.
+static uint64_t gfx_upload_ring_position(const VkDeviceSize size) {
+    const GfxUploadStagingRing &ring = s_gfxUpload.ring;
+    const uint64_t position = gfx_upload_align(ring.head);
+    if ((position % ring.size) + size > ring.size) {
+        return position + (ring.size - position % ring.size);
+    }
+    return position;
+}
+
+static bool gfx_upload_ring_fits(const VkDeviceSize size) {
+    const GfxUploadStagingRing &ring = s_gfxUpload.ring;
+    return gfx_upload_ring_position(size) + size - ring.tail <= ring.size;
+}
+
+// the wait on the timeline is already satisfied by the time a batch retires, it only orders the graphics queue after
+// the transfer and makes the copies visible to it. Every later graphics submission inherits that ordering.
+static void gfx_upload_submit_acquire(GfxUploadBatch &batch) {
+    if (batch.acquirePending) {
+        vkWaitForFences(g_vulkanBackend.device, 1, &batch.acquireFence, VK_TRUE, UINT64_MAX);
+        vkResetFences(g_vulkanBackend.device, 1, &batch.acquireFence);
+    }
+
+    const bool recordAcquire = batch.bufferAcquireCount > 0 || batch.imageAcquireCount > 0;
+    if (recordAcquire) {
+        vkResetCommandBuffer(batch.acquireCmd, 0);
+        VkCommandBufferBeginInfo cmdBufBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        cmdBufBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.acquireCmd, &cmdBufBeginInfo);
+        vkCmdPipelineBarrier(
+                batch.acquireCmd,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                0, nullptr,
+                batch.bufferAcquireCount, batch.bufferAcquires,
+                batch.imageAcquireCount, batch.imageAcquires);
+        vkEndCommandBuffer(batch.acquireCmd);
+    }
+
+    const VkTimelineSemaphoreSubmitInfo timelineInfo = {
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .waitSemaphoreValueCount = 1,
+            .pWaitSemaphoreValues = &batch.timelineValue,
+    };
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &s_gfxUpload.timeline;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = recordAcquire ? 1 : 0;
+    submitInfo.pCommandBuffers = &batch.acquireCmd;
+    const VkResult submitRes = vkQueueSubmit(g_vulkanBackend.queue, 1, &submitInfo, batch.acquireFence);
+    ASSERT_MSG(submitRes == VK_SUCCESS, "Err: failed to submit upload acquire");
+    batch.acquirePending = true;
+    batch.bufferAcquireCount = 0;
+    batch.imageAcquireCount = 0;
+}
+
+static void gfx_upload_retire(const uint64_t completedValue) {
+    while (s_gfxUpload.retiredValue < completedValue && s_gfxUpload.retiredValue < s_gfxUpload.submittedValue) {
+        const uint64_t value = s_gfxUpload.retiredValue + 1;
+        GfxUploadBatch &batch = gfx_upload_batch_for_value(value);
+        gfx_upload_submit_acquire(batch);
+        // the acquire only touches the destination resources, the copies out of the ring are done once the value lands.
+        s_gfxUpload.ring.tail = batch.ringEnd;
+        s_gfxUpload.retiredValue = value;
+    }
+}
+
+static void gfx_upload_poll() {
+    uint64_t counterValue = 0;
+    const VkResult counterRes = vkGetSemaphoreCounterValue(g_vulkanBackend.device, s_gfxUpload.timeline, &counterValue);
+    ASSERT(counterRes == VK_SUCCESS);
+    gfx_upload_retire(counterValue);
+}
+
+static void gfx_upload_wait_value(const uint64_t value) {
+    const VkSemaphoreWaitInfo waitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &s_gfxUpload.timeline,
+            .pValues = &value,
+    };
+    const VkResult waitRes = vkWaitSemaphores(g_vulkanBackend.device, &waitInfo, UINT64_MAX);
+    ASSERT(waitRes == VK_SUCCESS);
+    gfx_upload_retire(value);
+}
+
+static void gfx_upload_submit_open_batch() {
+    GfxUploadBatch &batch = gfx_upload_batch_for_value(s_gfxUpload.submittedValue + 1);
+    if (!batch.recording) {
+        return;
+    }
+    vkEndCommandBuffer(batch.transferCmd);
+
+    const VkTimelineSemaphoreSubmitInfo timelineInfo = {
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .signalSemaphoreValueCount = 1,
+            .pSignalSemaphoreValues = &batch.timelineValue,
+    };
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.transferCmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &s_gfxUpload.timeline;
+    const VkResult submitRes = vkQueueSubmit(g_vulkanBackend.queueTransfer, 1, &submitInfo, VK_NULL_HANDLE);
+    ASSERT_MSG(submitRes == VK_SUCCESS, "Err: failed to submit upload batch");
+
+    batch.recording = false;
+    batch.ringEnd = s_gfxUpload.ring.head;
+    s_gfxUpload.submittedValue = batch.timelineValue;
+}
+
+// returns the open batch with room for one more barrier, submitting the current batch first if it is full. Reusing a
+// slot blocks until the batch it last held has retired.
+static GfxUploadBatch &gfx_upload_open_batch() {
+    GfxUploadBatch *batch = &gfx_upload_batch_for_value(s_gfxUpload.submittedValue + 1);
+    if (batch->recording) {
+        if (batch->bufferAcquireCount < GFX_UPLOAD_MAX_BARRIERS_PER_BATCH && batch->imageAcquireCount < GFX_UPLOAD_MAX_BARRIERS_PER_BATCH) {
+            return *batch;
+        }
+        gfx_upload_submit_open_batch();
+        batch = &gfx_upload_batch_for_value(s_gfxUpload.submittedValue + 1);
+    }
+
+    if (batch->timelineValue != GFX_UPLOAD_INVALID_HANDLE && batch->timelineValue > s_gfxUpload.retiredValue) {
+        BEET_PROFILE_SCOPE("gfx_upload_wait_for_slot");
+        gfx_upload_wait_value(batch->timelineValue);
+    }
+    batch->timelineValue = s_gfxUpload.submittedValue + 1;
+
+    vkResetCommandBuffer(batch->transferCmd, 0);
+    VkCommandBufferBeginInfo cmdBufBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    cmdBufBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(batch->transferCmd, &cmdBufBeginInfo);
+    batch->recording = true;
+    return *batch;
+}
+
+// takes ring space for the open batch, reclaiming from retired batches first. Only when nothing else is in flight is the
+// open batch itself submitted to free up the space it holds.
+static GfxUploadStaging gfx_upload_take_staging(const VkDeviceSize size) {
+    ASSERT_MSG(size <= gfx_upload_max_staging_size(), "Err: upload of %llu bytes is larger than the staging ring allows", (unsigned long long) size);
+    GfxUploadBatch *batch = &gfx_upload_open_batch();
+    if (!gfx_upload_ring_fits(size)) {
+        BEET_PROFILE_SCOPE("gfx_upload_wait_for_staging");
+        gfx_upload_poll();
+        while (!gfx_upload_ring_fits(size)) {
+            if (s_gfxUpload.retiredValue < s_gfxUpload.submittedValue) {
+                gfx_upload_wait_value(s_gfxUpload.retiredValue + 1);
+                continue;
+            }
+            gfx_upload_submit_open_batch();
+            batch = &gfx_upload_open_batch();
+        }
+    }
+
+    GfxUploadStagingRing &ring = s_gfxUpload.ring;
+    const uint64_t position = gfx_upload_ring_position(size);
+    ring.head = position + size;
+    const VkDeviceSize offset = position % ring.size;
+    return {
+            .mapped = ring.mapped + offset,
+            .offset = offset,
+            .size = size,
+            .handle = batch->timelineValue,
+    };
+}
+
+static uint32_t gfx_upload_src_family() {
+    return s_gfxUpload.ownershipTransfer ? g_vulkanBackend.queueFamilyIndices.transfer : VK_QUEUE_FAMILY_IGNORED;
+}
+
+static uint32_t gfx_upload_dst_family() {
+    return s_gfxUpload.ownershipTransfer ? g_vulkanBackend.queueFamilyIndices.graphics : VK_QUEUE_FAMILY_IGNORED;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+GfxUploadHandle gfx_upload_buffer(const VkBuffer dstBuffer, const VkDeviceSize dstOffset, const void *data, const VkDeviceSize size) {
+    ASSERT(size > 0);
+    const VkDeviceSize chunkSize = gfx_upload_max_staging_size();
+    GfxUploadHandle handle = GFX_UPLOAD_INVALID_HANDLE;
+    for (VkDeviceSize chunkOffset = 0; chunkOffset < size; chunkOffset += chunkSize) {
+        const VkDeviceSize copySize = size - chunkOffset < chunkSize ? size - chunkOffset : chunkSize;
+        const GfxUploadStaging staging = gfx_upload_take_staging(copySize);
+        GfxUploadBatch &batch = gfx_upload_batch_for_value(staging.handle);
+        memcpy(staging.mapped, (const uint8_t *) data + chunkOffset, copySize);
+
+        const VkBufferCopy copyRegion = {
+                .srcOffset = staging.offset,
+                .dstOffset = dstOffset + chunkOffset,
+                .size = copySize,
+        };
+        vkCmdCopyBuffer(batch.transferCmd, s_gfxUpload.ring.buffer, dstBuffer, 1, &copyRegion);
+
+        // visibility on the graphics side comes from the timeline wait, this only releases ownership when families differ.
+        const VkBufferMemoryBarrier release = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = 0,
+                .srcQueueFamilyIndex = gfx_upload_src_family(),
+                .dstQueueFamilyIndex = gfx_upload_dst_family(),
+                .buffer = dstBuffer,
+                .offset = dstOffset + chunkOffset,
+                .size = copySize,
+        };
+        vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0, nullptr);
+
+        if (s_gfxUpload.ownershipTransfer) {
+            VkBufferMemoryBarrier &acquire = batch.bufferAcquires[batch.bufferAcquireCount++];
+            acquire = release;
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        }
+        handle = staging.handle;
+    }
+    return handle;
+}
+
+GfxUploadStaging gfx_upload_reserve_staging(const VkDeviceSize size) {
+    ASSERT(size > 0);
+    return gfx_upload_take_staging(size);
+}
+
+// half the ring, so one reservation can be filled while the batch holding the previous one is still in flight.
+VkDeviceSize gfx_upload_max_staging_size() {
+    return s_gfxUpload.ring.size / 2;
+}
+
+GfxUploadHandle gfx_upload_image(const VkImage dstImage,
+                                 const VkImageSubresourceRange &subresourceRange,
+                                 const GfxUploadStaging &staging,
+                                 VkBufferImageCopy *regions,
+                                 const uint32_t regionCount,
+                                 const uint8_t flags) {
+    GfxUploadBatch &batch = gfx_upload_batch_for_value(s_gfxUpload.submittedValue + 1);
+    ASSERT_MSG(batch.recording && staging.handle == batch.timelineValue, "Err: staging was not reserved from the open upload batch");
+
+    for (uint32_t i = 0; i < regionCount; ++i) {
+        ASSERT(regions[i].bufferOffset < staging.size);
+        regions[i].bufferOffset += staging.offset;
+    }
+
+    if (flags & GFX_UPLOAD_IMAGE_BEGIN) {
+        const VkImageMemoryBarrier toTransfer = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = dstImage,
+                .subresourceRange = subresourceRange,
+        };
+        vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+    }
+    // bands of the same range may land in later batches, those are submitted to the same queue after the transition.
+    vkCmdCopyBufferToImage(batch.transferCmd, s_gfxUpload.ring.buffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, regions);
+    if (!(flags & GFX_UPLOAD_IMAGE_END)) {
+        return batch.timelineValue;
+    }
+
+    // the layout transition rides along with the release, the matching acquire has to repeat it exactly.
+    const VkImageMemoryBarrier release = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = 0,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = gfx_upload_src_family(),
+            .dstQueueFamilyIndex = gfx_upload_dst_family(),
+            .image = dstImage,
+            .subresourceRange = subresourceRange,
+    };
+    vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &release);
+
+    if (s_gfxUpload.ownershipTransfer) {
+        VkImageMemoryBarrier &acquire = batch.imageAcquires[batch.imageAcquireCount++];
+        acquire = release;
+        acquire.srcAccessMask = 0;
+        acquire.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    }
+    return batch.timelineValue;
+}
+
+void gfx_upload_flush() {
+    gfx_upload_submit_open_batch();
+}
+
+bool gfx_upload_is_complete(const GfxUploadHandle handle) {
+    if (handle <= s_gfxUpload.retiredValue) {
+        return true;
+    }
+    if (handle > s_gfxUpload.submittedValue) {
+        return false;
+    }
+    gfx_upload_poll();
+    return handle <= s_gfxUpload.retiredValue;
+}
+
+void gfx_upload_wait(const GfxUploadHandle handle) {
+    if (handle <= s_gfxUpload.retiredValue) {
+        return;
+    }
+    BEET_PROFILE_SCOPE("gfx_upload_wait");
+    if (handle > s_gfxUpload.submittedValue) {
+        gfx_upload_submit_open_batch();
+    }
+    ASSERT(handle <= s_gfxUpload.submittedValue);
+    gfx_upload_wait_value(handle);
+}
+
+void gfx_upload_update() {
+    BEET_PROFILE_SCOPE("gfx_upload_update");
+    gfx_upload_submit_open_batch();
+    gfx_upload_poll();
+}
+
+void gfx_upload_set_staging_ring_size(const VkDeviceSize size) {
+    if (size == s_gfxUpload.ring.size) {
+        return;
+    }
+    gfx_upload_submit_open_batch();
+    if (s_gfxUpload.submittedValue > s_gfxUpload.retiredValue) {
+        gfx_upload_wait_value(s_gfxUpload.submittedValue);
+    }
+    gfx_upload_cleanup_ring();
+    gfx_upload_create_ring(size);
+}
+//======================================================================================================================
+
+//===INIT_&_SHUTDOWN====================================================================================================
+void gfx_create_upload() {
+    s_gfxUpload.ownershipTransfer = g_vulkanBackend.queueFamilyIndices.transfer != g_vulkanBackend.queueFamilyIndices.graphics;
+
+    VkCommandPoolCreateInfo commandPoolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    commandPoolInfo.queueFamilyIndex = g_vulkanBackend.queueFamilyIndices.transfer;
+    const VkResult transferPoolRes = vkCreateCommandPool(g_vulkanBackend.device, &commandPoolInfo, nullptr, &s_gfxUpload.transferPool);
+    ASSERT_MSG(transferPoolRes == VK_SUCCESS, "Err: failed to create transfer command pool");
+
+    commandPoolInfo.queueFamilyIndex = g_vulkanBackend.queueFamilyIndices.graphics;
+    const VkResult acquirePoolRes = vkCreateCommandPool(g_vulkanBackend.device, &commandPoolInfo, nullptr, &s_gfxUpload.acquirePool);
+    ASSERT_MSG(acquirePoolRes == VK_SUCCESS, "Err: failed to create upload acquire command pool");
+
+    VkSemaphoreTypeCreateInfo timelineCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0,
+    };
+    const VkSemaphoreCreateInfo semaphoreCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &timelineCreateInfo,
+    };
+    const VkResult semaphoreRes = vkCreateSemaphore(g_vulkanBackend.device, &semaphoreCreateInfo, nullptr, &s_gfxUpload.timeline);
+    ASSERT_MSG(semaphoreRes == VK_SUCCESS, "Err: failed to create upload timeline semaphore");
+
+    gfx_upload_create_ring(GFX_UPLOAD_STAGING_RING_DEFAULT_SIZE);
+
+    const VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    for (GfxUploadBatch &batch: s_gfxUpload.batches) {
+        const VkCommandBufferAllocateInfo transferCmdInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = s_gfxUpload.transferPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1,
+        };
+        const VkResult transferCmdRes = vkAllocateCommandBuffers(g_vulkanBackend.device, &transferCmdInfo, &batch.transferCmd);
+        ASSERT_MSG(transferCmdRes == VK_SUCCESS, "Err: failed to create transfer command buffer");
+
+        const VkCommandBufferAllocateInfo acquireCmdInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = s_gfxUpload.acquirePool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1,
+        };
+        const VkResult acquireCmdRes = vkAllocateCommandBuffers(g_vulkanBackend.device, &acquireCmdInfo, &batch.acquireCmd);
+        ASSERT_MSG(acquireCmdRes == VK_SUCCESS, "Err: failed to create upload acquire command buffer");
+
+        const VkResult fenceRes = vkCreateFence(g_vulkanBackend.device, &fenceCreateInfo, nullptr, &batch.acquireFence);
+        ASSERT_MSG(fenceRes == VK_SUCCESS, "Err: failed to create upload acquire fence");
+    }
+}
+
+void gfx_cleanup_upload() {
+    // anything still recording is dropped, anything in flight has to land before its staging can be freed.
+    if (s_gfxUpload.submittedValue > s_gfxUpload.retiredValue) {
+        gfx_upload_wait_value(s_gfxUpload.submittedValue);
+    }
+    vkQueueWaitIdle(g_vulkanBackend.queue);
+
+    for (GfxUploadBatch &batch: s_gfxUpload.batches) {
+        vkDestroyFence(g_vulkanBackend.device, batch.acquireFence, nullptr);
+    }
+    gfx_upload_cleanup_ring();
+    vkDestroySemaphore(g_vulkanBackend.device, s_gfxUpload.timeline, nullptr);
+    vkDestroyCommandPool(g_vulkanBackend.device, s_gfxUpload.acquirePool, nullptr);
+    vkDestroyCommandPool(g_vulkanBackend.device, s_gfxUpload.transferPool, nullptr);
+    s_gfxUpload = {};
+}
+//======================================================================================================================
@@ -0,0 +1,145 @@
+#include <beet_shared/memory.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Replays the allocation pattern of gltf_parse_json against the system allocator and the TLSF heap.
+// Per file: the json text buffer, rapidjson pool chunks and the decoded binary buffer stay alive for the whole file.
+// Per primitive: 5 accessor copies, a vertex buffer and a push_back grown index buffer are allocated then released.
+
+//===INTERNAL_STRUCTS===================================================================================================
+constexpr uint32_t BENCH_FILE_COUNT = 64;
+constexpr uint32_t BENCH_MAX_PRIMITIVES = 48;
+constexpr uint32_t BENCH_MAX_JSON_CHUNKS = 32;
+constexpr size_t BENCH_JSON_CHUNK_SIZE = 64 * 1024;
+constexpr size_t BENCH_GFX_VERTEX_SIZE = 48;
+constexpr size_t BENCH_TLSF_COMMIT_SIZE = 128 * 1024 * 1024;
+
+struct BenchAllocator {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*free)(void *block);
+    void (*maintain)();
+};
+
+struct BenchResult {
+    double totalMs;
+    double worstAllocUs;
+    uint64_t allocCount;
+};
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static MemTlsf s_benchTlsf = {};
+
+static void *bench_system_alloc(const size_t size) { return malloc(size); }
+static void bench_system_free(void *block) { free(block); }
+static void *bench_tlsf_alloc(const size_t size) { return mem_tlsf_alloc(s_benchTlsf, size); }
+static void bench_tlsf_free(void *block) { mem_tlsf_free(s_benchTlsf, block); }
+static void bench_tlsf_maintain() { mem_tlsf_grow_if_low(s_benchTlsf, MEM_TLSF_DEFAULT_LOW_WATER_SIZE); }
+
+static uint32_t bench_rand(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void *bench_timed_alloc(const BenchAllocator &allocator, const size_t size, BenchResult &result) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    void *out = allocator.alloc(size);
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double us = std::chrono::duration<double, std::micro>(end - start).count();
+    result.worstAllocUs = us > result.worstAllocUs ? us : result.worstAllocUs;
+    result.allocCount++;
+    if (out == nullptr) {
+        printf("%s failed to allocate %zu Bytes\n", allocator.name, size);
+        exit(1);
+    }
+    // touch the first byte so lazily committed pages are charged to the allocation that asked for them.
+    memset(out, 0, size < 64 ? size : 64);
+    return out;
+}
+
+static BenchResult bench_run(const BenchAllocator &allocator) {
+    BenchResult result = {};
+    uint32_t rng = 0xBEE7;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t file = 0; file < BENCH_FILE_COUNT; ++file) {
+        // the per frame low water check, it runs between files and is not charged to any single allocation.
+        if (allocator.maintain) {
+            allocator.maintain();
+        }
+        void *jsonText = bench_timed_alloc(allocator, 16 * 1024 + (bench_rand(rng) % (2 * 1024 * 1024)), result);
+        void *jsonChunks[BENCH_MAX_JSON_CHUNKS] = {};
+        const uint32_t jsonChunkCount = 1 + bench_rand(rng) % BENCH_MAX_JSON_CHUNKS;
+        for (uint32_t i = 0; i < jsonChunkCount; ++i) {
+            jsonChunks[i] = bench_timed_alloc(allocator, BENCH_JSON_CHUNK_SIZE, result);
+        }
+        void *binaryData = bench_timed_alloc(allocator, 256 * 1024 + (bench_rand(rng) % (32 * 1024 * 1024)), result);
+
+        const uint32_t primitiveCount = 1 + bench_rand(rng) % BENCH_MAX_PRIMITIVES;
+        for (uint32_t prim = 0; prim < primitiveCount; ++prim) {
+            const size_t vertCount = 24 + bench_rand(rng) % 65536;
+            const size_t indexCount = vertCount * 3;
+            void *indices = bench_timed_alloc(allocator, indexCount * sizeof(uint16_t), result);
+            void *tangents = bench_timed_alloc(allocator, vertCount * 16, result);
+            void *normals = bench_timed_alloc(allocator, vertCount * 12, result);
+            void *uvs = bench_timed_alloc(allocator, vertCount * 8, result);
+            void *positions = bench_timed_alloc(allocator, vertCount * 12, result);
+            void *verts = bench_timed_alloc(allocator, vertCount * BENCH_GFX_VERTEX_SIZE, result);
+
+            // std::vector<uint32_t>::emplace_back growth, each step allocates the new buffer before freeing the old one.
+            void *rawIndices = nullptr;
+            for (size_t capacity = 1; capacity < indexCount; capacity *= 2) {
+                void *grown = bench_timed_alloc(allocator, capacity * 2 * sizeof(uint32_t), result);
+                if (rawIndices) {
+                    allocator.free(rawIndices);
+                }
+                rawIndices = grown;
+            }
+
+            allocator.free(rawIndices);
+            allocator.free(verts);
+            allocator.free(positions);
+            allocator.free(uvs);
+            allocator.free(normals);
+            allocator.free(tangents);
+            allocator.free(indices);
+        }
+
+        allocator.free(binaryData);
+        for (uint32_t i = 0; i < jsonChunkCount; ++i) {
+            allocator.free(jsonChunks[i]);
+        }
+        allocator.free(jsonText);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    result.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+//======================================================================================================================
+
+int main() {
+    mem_tlsf_create(s_benchTlsf, MEM_TLSF_DEFAULT_RESERVE_SIZE, BENCH_TLSF_COMMIT_SIZE);
+
+    const BenchAllocator allocators[] = {
+            {"system", bench_system_alloc, bench_system_free, nullptr},
+            {"tlsf", bench_tlsf_alloc, bench_tlsf_free, bench_tlsf_maintain},
+    };
+    for (const BenchAllocator &allocator: allocators) {
+        const BenchResult result = bench_run(allocator);
+        printf("%-8s total: %8.3f ms, allocs: %8llu, avg: %6.3f us, worst: %8.3f us\n",
+               allocator.name,
+               result.totalMs,
+               (unsigned long long) result.allocCount,
+               (result.totalMs * 1000.0) / (double) result.allocCount,
+               result.worstAllocUs);
+    }
+
+    const MemTlsfStats stats = mem_tlsf_stats(s_benchTlsf);
+    printf("tlsf committed: %zu Bytes, grown: %u times, largest free: %zu Bytes, fragmentation: %.3f\n",
+           stats.committedSize, stats.growCount, stats.largestFreeBlock, stats.fragmentation);
+    mem_tlsf_cleanup(s_benchTlsf);
+    return 0;
+}
@@ -38,8 +38,7 @@ struct Camera {
 };
 
 struct LitMaterial {
-    uint32_t descriptorSetIndex{0};
-    uint32_t albedoIndex{0};
+    uint32_t albedoIndex{0}; // db texture index, doubles as the slot in the bindless texture array
     //TODO:GFX
     //uint32_t normalIndex{0};
     //uint32_t metallicIndex{0};
@@ -1,6 +1,7 @@
 #ifndef BEETROOT_DDS_LOADER_H
 #define BEETROOT_DDS_LOADER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <beet_shared//texture_formats.h>
 //INFO: .dds file format spec
@@ -10,7 +11,13 @@
 // https://learn.microsoft.com/en-us/windows/uwp/gaming/complete-code-for-ddstextureloader
 
 //===API================================================================================================================
+// copies the pixel payload into a MSG_DDS allocation, release with mem_free(outRawImage->data).
 void load_dds_image_alloc(const char *path, RawImage *outRawImage);
+
+// zero copy variant, data views straight into a read only mapping of the file.
+// the image must be released with unload_dds_image_mapped, data must not be written to or mem_free'd.
+void load_dds_image_mapped(const char *path, RawImage *outRawImage);
+void unload_dds_image_mapped(RawImage *rawImage);
 //======================================================================================================================
 
 #endif //BEETROOT_DDS_LOADER_H
@@ -1,8 +1,11 @@
 #ifndef BEETROOT_LOG_H
 #define BEETROOT_LOG_H
 
+#include <atomic>
 #include <cstdio>
-#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <beet_shared/os_time.h>
 
 //===INTERNAL_STRUCTS===================================================================================================
@@ -13,6 +16,7 @@ enum MSG_LEVEL : uint8_t {
     MSG_WARNING = 3u,
     MSG_ERROR = 4u,
     MSG_CRITICAL = 5u,
+    MSG_LEVEL_COUNT = 6u,
 };
 
 enum MSG_CHANNEL : uint32_t {
@@ -26,78 +30,211 @@ enum MSG_CHANNEL : uint32_t {
     MSG_GFX = 1u << 6u,
     MSG_MATH = 1u << 7u,
     MSG_DDS = 1u << 8u,
+    MSG_DB = 1u << 9u,
+    MSG_GLTF = 1u << 10u,
 
     MSG_DBG = 1u << 31u,
     MSG_ALL = UINT32_MAX,
 };
 
+// Start up filter values, both can be changed at runtime via log_set_channel_mask / log_set_min_level.
+// Release builds only keep warning and above when compiled with BEET_LOG_RELEASE, see the macros below.
+#if BEET_DEBUG
 #define MSG_MIN_WARNING_LEVEL MSG_VERBOSE
+#else
+#define MSG_MIN_WARNING_LEVEL MSG_WARNING
+#endif
+// every individually selectable channel, used by the filter parsing and the runtime log widget.
+inline constexpr MSG_CHANNEL LOG_NAMED_CHANNELS[] = {
+        MSG_RUNTIME, MSG_SERVER, MSG_PIPELINE, MSG_CONVERTER, MSG_MEMORY,
+        MSG_GFX, MSG_MATH, MSG_DDS, MSG_DB, MSG_GLTF,
+        MSG_DBG,
+};
+
 #define MSG_ACTIVE_CHANNELS ((MSG_ALL) & ~MSG_DBG)
 //#define MSG_ACTIVE_CHANNELS MSG_DBG
-//======================================================================================================================
 
-//===API================================================================================================================
-#if BEET_DEBUG
-const char *log_channel_name_lookup(const MSG_CHANNEL &channel);
+#ifndef BEET_LOG_RELEASE
+#define BEET_LOG_RELEASE 0
+#endif
+
+// Per level channel masks, levels below the minimum hold 0 so a log call tests a single word.
+extern std::atomic<uint32_t> g_logLevelChannelMasks[MSG_LEVEL_COUNT];
 
-#define log_verbose(channel, ...){                              \
-    if(channel & MSG_ACTIVE_CHANNELS){                          \
-        beet_log(MSG_VERBOSE, channel,"[verbose]", __VA_ARGS__) \
-    }                                                           \
+// what producers do when their ring buffer is full because the sink thread has fallen behind.
+enum LOG_QUEUE_POLICY : uint8_t {
+    LOG_QUEUE_POLICY_DROP = 0u,
+    LOG_QUEUE_POLICY_BLOCK = 1u,
+};
+
+struct LogConfig {
+    bool writeToStdout = {true};
+    const char *filePath = {nullptr}; // nullptr disables file output
+    LOG_QUEUE_POLICY queuePolicy = {LOG_QUEUE_POLICY_BLOCK};
+};
+
+constexpr uint32_t LOG_MAX_ARGS = 16;
+constexpr uint32_t LOG_RECORD_STRING_SIZE = 768;
+
+enum LOG_ARG_TYPE : uint8_t {
+    LOG_ARG_INT = 0u,
+    LOG_ARG_UINT = 1u,
+    LOG_ARG_DOUBLE = 2u,
+    LOG_ARG_POINTER = 3u,
+    LOG_ARG_STRING = 4u,
+};
+
+// An arg tag packs the LOG_ARG_TYPE into the low bits and the argument's byte width after integer promotion into the
+// high bits. Integers are stored widened to 64 bits, the sink truncates back so "%u" with -1 prints 4294967295.
+constexpr uint8_t LOG_ARG_TYPE_MASK = 0x0fu;
+constexpr uint8_t LOG_ARG_WIDTH_SHIFT = 4u;
+
+constexpr uint8_t log_arg_tag(const LOG_ARG_TYPE type, const size_t width) {
+    return (uint8_t) (type | (width << LOG_ARG_WIDTH_SHIFT));
 }
 
-#define log_info(channel, ...){                             \
-    if(channel & MSG_ACTIVE_CHANNELS){                      \
-        beet_log(MSG_INFO, channel,"[info]", __VA_ARGS__)   \
-    }                                                       \
+constexpr LOG_ARG_TYPE log_arg_type(const uint8_t tag) {
+    return (LOG_ARG_TYPE) (tag & LOG_ARG_TYPE_MASK);
 }
 
-#define log_debug(channel, ...){                            \
-    if(channel & MSG_ACTIVE_CHANNELS){                      \
-        beet_log(MSG_DEBUG, channel,"[debug]",__VA_ARGS__)  \
-    }                                                       \
+constexpr uint32_t log_arg_width(const uint8_t tag) {
+    return tag >> LOG_ARG_WIDTH_SHIFT;
 }
 
-#define log_warning(channel, ...){                              \
-    if(channel & MSG_ACTIVE_CHANNELS){                          \
-        beet_log(MSG_WARNING, channel,"[warning]", __VA_ARGS__) \
-    }                                                           \
+// The format string is stored by pointer so it must outlive the record, every call site passes a literal.
+// String arguments are copied into stringData as the caller's buffer may be gone by the time the sink runs.
+// Records are built on the caller's stack, only the used args and string bytes are copied into the log ring.
+struct LogRecord {
+    const char *format;
+    int64_t timestampNs;
+    MSG_CHANNEL channel;
+    MSG_LEVEL level;
+    uint8_t argCount;
+    uint16_t stringSize;
+    uint8_t argTags[LOG_MAX_ARGS];
+    uint64_t args[LOG_MAX_ARGS];
+    char stringData[LOG_RECORD_STRING_SIZE];
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+const char *log_channel_name_lookup(const MSG_CHANNEL &channel);
+const char *log_level_name_lookup(const MSG_LEVEL &level);
+
+inline bool log_is_enabled(const MSG_LEVEL level, const uint32_t channel) {
+    return (g_logLevelChannelMasks[level].load(std::memory_order_relaxed) & channel) != 0;
 }
 
-#define log_error(channel, ...){                            \
-    if(channel & MSG_ACTIVE_CHANNELS){                      \
-        beet_log(MSG_ERROR, channel,"[error]", __VA_ARGS__) \
-    }                                                       \
+void log_set_channel_mask(uint32_t channelMask);
+uint32_t log_get_channel_mask();
+void log_set_min_level(MSG_LEVEL level);
+MSG_LEVEL log_get_min_level();
+
+// accepts a comma separated list of channel names without brackets, e.g. "gfx,memory", or "all" / "none".
+// prefixing a name with '-' removes it from the mask, e.g. "all,-dbg".
+bool log_parse_channel_mask(const char *channels, uint32_t &outChannelMask);
+bool log_parse_level(const char *level, MSG_LEVEL &outLevel);
+
+// reads BEET_LOG_CHANNELS and BEET_LOG_LEVEL.
+void log_configure_from_env();
+// reads -logChannels=<channels> and -logLevel=<level>, applied after the environment so the command line wins.
+void log_configure_from_args(int32_t argc, char **argv);
+
+// until log_create is called, or after log_cleanup, records are formatted and written on the calling thread.
+void log_create(const LogConfig &config);
+void log_flush();
+void log_cleanup();
+
+void log_record_begin(LogRecord &record, MSG_LEVEL level, MSG_CHANNEL channel, const char *format);
+void log_record_push_string(LogRecord &record, const char *string);
+void log_record_submit(const LogRecord &record);
+size_t log_record_format(const LogRecord &record, char *outBuffer, size_t bufferSize);
+
+template<typename T>
+void log_record_push_arg(LogRecord &record, const T &arg) {
+    if constexpr (std::is_array_v<T> || std::is_same_v<std::decay_t<T>, char *> || std::is_same_v<std::decay_t<T>, const char *>) {
+        log_record_push_string(record, arg);
+        return;
+    } else {
+        const uint8_t index = record.argCount;
+        record.argCount++;
+        if constexpr (std::is_floating_point_v<T>) {
+            record.argTags[index] = log_arg_tag(LOG_ARG_DOUBLE, sizeof(double));
+            const double value = (double) arg;
+            static_assert(sizeof(double) == sizeof(uint64_t));
+            memcpy(&record.args[index], &value, sizeof(double));
+        } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+            record.argTags[index] = log_arg_tag(LOG_ARG_POINTER, sizeof(void *));
+            record.args[index] = (uint64_t) (uintptr_t) arg;
+        } else if constexpr (std::is_enum_v<T>) {
+            using Underlying = std::underlying_type_t<T>;
+            const size_t width = sizeof(Underlying) < sizeof(int) ? sizeof(int) : sizeof(Underlying);
+            record.argTags[index] = log_arg_tag(std::is_signed_v<Underlying> ? LOG_ARG_INT : LOG_ARG_UINT, width);
+            record.args[index] = std::is_signed_v<Underlying> ? (uint64_t) (int64_t) arg : (uint64_t) arg;
+        } else {
+            static_assert(std::is_integral_v<T>, "log arguments must be integral, floating point, pointer or c string");
+            // narrow types are promoted to int as they would be when passed through printf's varargs.
+            const size_t width = sizeof(T) < sizeof(int) ? sizeof(int) : sizeof(T);
+            record.argTags[index] = log_arg_tag(std::is_signed_v<T> || sizeof(T) < sizeof(int) ? LOG_ARG_INT : LOG_ARG_UINT, width);
+            record.args[index] = std::is_signed_v<T> ? (uint64_t) (int64_t) arg : (uint64_t) arg;
+        }
+    }
 }
 
-#define log_critical(channel, ...){                                 \
-    if(channel & MSG_ACTIVE_CHANNELS){                              \
-        beet_log(MSG_CRITICAL, channel,"[critical]",  __VA_ARGS__)  \
-    }                                                               \
+template<typename... Args>
+void log_push(const MSG_LEVEL level, const MSG_CHANNEL channel, const char *format, const Args &... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments, see LOG_MAX_ARGS");
+    LogRecord record;
+    log_record_begin(record, level, channel, format);
+    (log_record_push_arg(record, args), ...);
+    log_record_submit(record);
 }
 
+// log_push takes its arguments through a template, which loses the compiler's printf format checking.
+// Debug builds also pass them to log_format_check inside sizeof, unevaluated so nothing is emitted, to get -Wformat back.
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT(formatIndex, firstArgIndex) __attribute__((format(printf, formatIndex, firstArgIndex)))
+#else
+#define LOG_PRINTF_FORMAT(formatIndex, firstArgIndex)
+#endif
+
+int log_format_check(const char *format, ...) LOG_PRINTF_FORMAT(1, 2);
+
+#if BEET_DEBUG
+#define LOG_FORMAT_CHECK(...) (void) sizeof(log_format_check(__VA_ARGS__))
+#else
+#define LOG_FORMAT_CHECK(...)
+#endif
+
+#if BEET_DEBUG || BEET_LOG_RELEASE
+// levelName is kept for call site compatibility, the sink looks the name up from the level.
 #define beet_log(level, channel, levelName, ...){                       \
-    time_t t = time(nullptr);                                           \
-    struct tm buf{};                                                    \
-    os_localtime(buf, t);                                               \
-    if(level >= MSG_MIN_WARNING_LEVEL){                                 \
-        printf("[%i:%i:%i]", buf.tm_hour, buf.tm_min, buf.tm_sec);      \
-        printf("%s", levelName);                                        \
-        const char* channelName = log_channel_name_lookup(channel);     \
-        printf("%s : ", channelName);                                   \
-        printf(__VA_ARGS__);                                            \
+    LOG_FORMAT_CHECK(__VA_ARGS__);                                      \
+    if(log_is_enabled(level, (uint32_t)(channel))){                     \
+        log_push(level, (MSG_CHANNEL)(channel), __VA_ARGS__);           \
     }                                                                   \
 }
+
+#define log_warning(channel, ...) beet_log(MSG_WARNING, channel, "[warning]", __VA_ARGS__)
+#define log_error(channel, ...) beet_log(MSG_ERROR, channel, "[error]", __VA_ARGS__)
+#define log_critical(channel, ...) beet_log(MSG_CRITICAL, channel, "[critical]", __VA_ARGS__)
 #else
-#define log_verbose(channel, ...){}
-#define log_info(channel, ...){}
-#define log_debug(channel, ...){}
+#define beet_log(level, channel, levelName, ...){}
+
 #define log_warning(channel, ...){}
 #define log_error(channel, ...){}
 #define log_critical(channel, ...){}
+#endif
 
-#define beet_log(level, channel, levelName, ...){}
+#if BEET_DEBUG
+#define log_verbose(channel, ...) beet_log(MSG_VERBOSE, channel, "[verbose]", __VA_ARGS__)
+#define log_info(channel, ...) beet_log(MSG_INFO, channel, "[info]", __VA_ARGS__)
+#define log_debug(channel, ...) beet_log(MSG_DEBUG, channel, "[debug]", __VA_ARGS__)
+#else
+#define log_verbose(channel, ...){}
+#define log_info(channel, ...){}
+#define log_debug(channel, ...){}
 #endif
 //======================================================================================================================
 
-#endif //BEETROOT_LOG_H
\ No newline at end of file
+#endif //BEETROOT_LOG_H
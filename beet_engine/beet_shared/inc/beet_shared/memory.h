@@ -2,19 +2,185 @@
 #define BEETROOT_MEMORY_H
 
 #include <cstddef>
+#include <cstdint>
+#include <beet_shared/log.h>
 
 #define BEET_MEMORY_DEBUG BEET_DEBUG
 
+// set via the BEET_MEMORY_TLSF cmake option, routes mem_malloc / mem_zalloc / mem_free through a TLSF heap.
+#ifndef BEET_MEMORY_TLSF
+#define BEET_MEMORY_TLSF 0
+#endif
+
+// set via the BEET_MEMORY_TLSF_COMMIT_MB cmake cache variable, size of the TLSF heap committed at start up.
+#ifndef BEET_MEMORY_TLSF_COMMIT_MB
+#define BEET_MEMORY_TLSF_COMMIT_MB 256
+#endif
+
 //===API================================================================================================================
-void *mem_zalloc(size_t size);
-void *mem_malloc(size_t size);
+// every allocation is charged to a single MSG_CHANNEL tag, see mem_set_budget / mem_get_tag_stats.
+// MSG_NONE is accepted and charged to a shared untagged counter.
+void *mem_zalloc(size_t size, MSG_CHANNEL tag);
+void *mem_malloc(size_t size, MSG_CHANNEL tag);
 
 void mem_free(void *block);
 
+// alignment must be a power of two, blocks must be released with mem_aligned_free.
+constexpr size_t MEM_SIMD_ALIGNMENT = 32;
+constexpr size_t MEM_CACHE_LINE_SIZE = 64;
+
+void *mem_aligned_alloc(size_t size, size_t alignment, MSG_CHANNEL tag);
+void *mem_aligned_zalloc(size_t size, size_t alignment, MSG_CHANNEL tag);
+void mem_aligned_free(void *block);
+
+template<typename T>
+T *mem_alloc_array(const size_t count, const MSG_CHANNEL tag, const size_t alignment = alignof(T)) {
+    return (T *) mem_aligned_alloc(sizeof(T) * count, alignment < alignof(T) ? alignof(T) : alignment, tag);
+}
+
 #if BEET_MEMORY_DEBUG
 void mem_dump_memory_info();
 void mem_validate_empty();
 #endif //BEET_MEMORY_DEBUG
 //======================================================================================================================
 
+//===BUDGETS============================================================================================================
+// Per tag byte counters are kept in all builds so budgets can be enforced on shipping SKUs.
+// Arenas charge their committed pages to their tag rather than each individual allocation.
+enum MEM_BUDGET_POLICY : uint8_t {
+    MEM_BUDGET_POLICY_WARN = 0u,
+    MEM_BUDGET_POLICY_ASSERT = 1u,
+};
+
+struct MemTagStats {
+    size_t currentBytes;
+    size_t highWatermark;
+    size_t budgetBytes; // 0 when no budget is set
+    uint32_t liveAllocations;
+    uint64_t totalAllocations; // heap allocations made under the tag since start up, arena pushes are not counted
+};
+
+void mem_set_budget(MSG_CHANNEL tag, size_t budgetBytes, MEM_BUDGET_POLICY policy);
+MemTagStats mem_get_tag_stats(MSG_CHANNEL tag);
+void mem_dump_tag_stats();
+//======================================================================================================================
+
+//===ARENA==============================================================================================================
+// Linear allocator over a single reserved virtual range, pages are committed on demand as the offset grows.
+// Individual allocations are never freed, instead the whole arena is reset or rewound to a previous mark.
+constexpr size_t MEM_ARENA_DEFAULT_ALIGNMENT = 16;
+constexpr size_t MEM_ARENA_COMMIT_SIZE = 64 * 1024;
+
+struct MemArena {
+    uint8_t *base = {nullptr};
+    size_t reserved = {0};
+    size_t committed = {0};
+    size_t offset = {0};
+    size_t highWatermark = {0};
+    MSG_CHANNEL tag = {MSG_MEMORY}; // replaced by mem_arena_create
+};
+
+void *mem_arena_alloc(MemArena &arena, size_t size, size_t alignment = MEM_ARENA_DEFAULT_ALIGNMENT);
+void *mem_arena_zalloc(MemArena &arena, size_t size, size_t alignment = MEM_ARENA_DEFAULT_ALIGNMENT);
+void mem_arena_reset(MemArena &arena);
+
+size_t mem_arena_mark(const MemArena &arena);
+void mem_arena_rewind(MemArena &arena, size_t mark);
+
+void mem_arena_create(MemArena &arena, size_t reserveSize, MSG_CHANNEL tag);
+void mem_arena_cleanup(MemArena &arena);
+
+// rewinds the arena to the point the scope was opened, used for nested temporaries.
+struct MemArenaScope {
+    MemArena &arena;
+    size_t mark;
+    MemArenaScope(MemArena &inArena) : arena(inArena), mark(mem_arena_mark(inArena)) {}
+    ~MemArenaScope() { mem_arena_rewind(arena, mark); }
+
+    MemArenaScope(MemArenaScope &&) = delete;
+    void operator=(MemArenaScope &&) = delete;
+};
+//======================================================================================================================
+
+//===POOL===============================================================================================================
+// Fixed size block allocator, freed blocks store the index of the next free block in their first 4 bytes.
+// Block indices are stable for the lifetime of an allocation so they can be used as handles.
+constexpr uint32_t MEM_POOL_INVALID_INDEX = UINT32_MAX;
+
+struct MemPool {
+    uint8_t *start = {nullptr};
+    uint8_t *aliveFlags = {nullptr};
+    size_t blockSize = {0};
+    uint32_t capacity = {0};
+    uint32_t freeHead = {MEM_POOL_INVALID_INDEX};
+    uint32_t usedCount = {0};
+    uint32_t highWatermark = {0}; // blocks [0..highWatermark) have been handed out at least once
+};
+
+uint32_t mem_pool_alloc_index(MemPool &pool);
+void mem_pool_free_index(MemPool &pool, uint32_t index);
+
+void *mem_pool_get(const MemPool &pool, uint32_t index);
+bool mem_pool_is_alive(const MemPool &pool, uint32_t index);
+
+void mem_pool_create(MemPool &pool, size_t blockSize, uint32_t capacity, MSG_CHANNEL tag);
+void mem_pool_cleanup(MemPool &pool);
+//======================================================================================================================
+
+//===TLSF===============================================================================================================
+// Two level segregated fit heap over a single reserved virtual range, alloc and free are O(1).
+// mem_tlsf_create commits and faults in the initial heap, mem_tlsf_alloc never calls into the OS and returns nullptr
+// when no free block fits. The heap only grows, in MEM_TLSF_COMMIT_SIZE steps, through mem_tlsf_grow / mem_tlsf_grow_if_low.
+constexpr uint32_t MEM_TLSF_SL_COUNT_LOG2 = 5;
+constexpr uint32_t MEM_TLSF_SL_COUNT = 1 << MEM_TLSF_SL_COUNT_LOG2;
+constexpr uint32_t MEM_TLSF_FL_COUNT = 24; // largest block is just under 4GB
+constexpr size_t MEM_TLSF_ALIGNMENT = 16;
+constexpr size_t MEM_TLSF_COMMIT_SIZE = 1024 * 1024;
+constexpr size_t MEM_TLSF_DEFAULT_RESERVE_SIZE = (size_t) 4 * 1024 * 1024 * 1024;
+constexpr size_t MEM_TLSF_DEFAULT_LOW_WATER_SIZE = 32 * 1024 * 1024;
+
+struct MemTlsfBlock;
+
+struct MemTlsf {
+    uint8_t *base = {nullptr};
+    size_t reserved = {0};
+    size_t committed = {0};
+    uint32_t growCount = {0};
+    uint32_t flBitmap = {0};
+    uint32_t slBitmap[MEM_TLSF_FL_COUNT] = {};
+    MemTlsfBlock *freeLists[MEM_TLSF_FL_COUNT][MEM_TLSF_SL_COUNT] = {};
+};
+
+struct MemTlsfStats {
+    size_t committedSize;
+    size_t usedSize;
+    size_t freeSize;
+    size_t largestFreeBlock;
+    uint32_t usedBlockCount;
+    uint32_t freeBlockCount;
+    uint32_t growCount; // commits made after mem_tlsf_create, non zero means the initial commit was too small
+    float fragmentation; // 1 - largestFreeBlock / freeSize, 0 when all free space is one block
+};
+
+void *mem_tlsf_alloc(MemTlsf &tlsf, size_t size);
+void mem_tlsf_free(MemTlsf &tlsf, void *block);
+
+// commits and faults in enough pages for a free block of at least size Bytes, returns false once the reservation is full.
+bool mem_tlsf_grow(MemTlsf &tlsf, size_t size);
+// grows only when no single free block of lowWaterSize Bytes is left, cheap enough to call once per frame.
+bool mem_tlsf_grow_if_low(MemTlsf &tlsf, size_t lowWaterSize);
+
+// walks every block in the heap, intended for debug ui and benchmarks rather than per frame use.
+MemTlsfStats mem_tlsf_stats(const MemTlsf &tlsf);
+
+void mem_tlsf_create(MemTlsf &tlsf, size_t reserveSize, size_t initialCommitSize);
+void mem_tlsf_cleanup(MemTlsf &tlsf);
+
+#if BEET_MEMORY_TLSF
+MemTlsfStats mem_heap_stats();
+// low water check for the mem_malloc heap, call outside of any latency sensitive section e.g. once per frame.
+void mem_heap_grow_if_low();
+#endif //BEET_MEMORY_TLSF
+//======================================================================================================================
+
 #endif //BEETROOT_MEMORY_H
@@ -0,0 +1,23 @@
+#ifndef BEETROOT_OS_MEMORY_H
+#define BEETROOT_OS_MEMORY_H
+
+#include <cstddef>
+
+//===API================================================================================================================
+size_t os_page_size();
+
+void *os_virtual_reserve(size_t size);
+bool os_virtual_commit(void *address, size_t size);
+void os_virtual_decommit(void *address, size_t size);
+void os_virtual_release(void *address, size_t size);
+
+void *os_aligned_alloc(size_t size, size_t alignment);
+void os_aligned_free(void *block);
+
+// maps the whole file read only, returns nullptr if the file can not be opened or is empty.
+// pages are faulted in from the page cache on first touch, writing through the mapping is undefined.
+const void *os_file_map_readonly(const char *path, size_t &outSize);
+void os_file_unmap(const void *address, size_t size);
+//======================================================================================================================
+
+#endif //BEETROOT_OS_MEMORY_H
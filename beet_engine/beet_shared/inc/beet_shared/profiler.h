@@ -0,0 +1,58 @@
+#ifndef BEETROOT_PROFILER_H
+#define BEETROOT_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+
+#ifndef BEET_PROFILE
+#define BEET_PROFILE 0
+#endif
+
+//===PUBLIC_STRUCTS=====================================================================================================
+// Zones are written into a per thread ring once they close, the oldest zones are overwritten when a ring wraps.
+constexpr uint32_t PROFILER_ZONE_RING_CAPACITY = 64 * 1024;
+constexpr uint32_t PROFILER_MAX_THREADS = 32; // threads alive at once, a ring is handed to the next new thread on exit
+constexpr uint32_t PROFILER_THREAD_NAME_SIZE = 32;
+
+// name is stored by pointer, zones are expected to be named with string literals.
+struct ProfilerZone {
+    const char *name;
+    int64_t beginNs;
+    int64_t endNs;
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+inline int64_t profiler_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profiler_submit_zone(const char *name, int64_t beginNs, int64_t endNs);
+void profiler_set_thread_name(const char *name);
+
+// writes every zone still held in the rings as Chrome trace event json, loadable in chrome://tracing and Perfetto.
+// intended to be called between frames, zones being written on other threads at the wrap point may be torn.
+bool profiler_export_chrome_trace(const char *path);
+void profiler_cleanup();
+
+struct ProfilerScope {
+    const char *name;
+    int64_t beginNs;
+
+    explicit ProfilerScope(const char *zoneName) : name(zoneName), beginNs(profiler_now_ns()) {}
+    ~ProfilerScope() { profiler_submit_zone(name, beginNs, profiler_now_ns()); }
+    ProfilerScope(const ProfilerScope &) = delete;
+    ProfilerScope &operator=(const ProfilerScope &) = delete;
+};
+
+#define BEET_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define BEET_PROFILE_CONCAT(a, b) BEET_PROFILE_CONCAT_INTERNAL(a, b)
+
+#if BEET_PROFILE
+#define BEET_PROFILE_SCOPE(name) const ProfilerScope BEET_PROFILE_CONCAT(profilerScope_, __LINE__)(name)
+#else
+#define BEET_PROFILE_SCOPE(name)
+#endif
+//======================================================================================================================
+
+#endif //BEETROOT_PROFILER_H
@@ -0,0 +1,13 @@
+#ifndef BEETROOT_RADIX_SORT_H
+#define BEETROOT_RADIX_SORT_H
+
+#include <cstdint>
+
+//===API================================================================================================================
+// stable lsd radix sort, one pass per key byte. Bytes every key shares are skipped, so keys that only use their low or
+// high bits cost fewer passes. Values move with their keys, the scratch arrays hold count elements each and the result
+// always ends up back in keys and values.
+void radix_sort_u64(uint64_t *keys, uint32_t *values, uint64_t *scratchKeys, uint32_t *scratchValues, uint32_t count);
+//======================================================================================================================
+
+#endif //BEETROOT_RADIX_SORT_H
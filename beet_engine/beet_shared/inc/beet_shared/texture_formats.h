@@ -1,6 +1,7 @@
 #ifndef BEETROOT_TEXTURE_FORMATS_H
 #define BEETROOT_TEXTURE_FORMATS_H
 
+#include <cstddef>
 #include <cstdint>
 
 //===PUBLIC_STRUCTS=====================================================================================================
@@ -21,17 +22,36 @@ enum class TextureFormat : uint32_t {
     INVALID_FORMAT
 };
 
+enum class TextureDimension : uint32_t {
+    TEXTURE_2D,     // arrayLayers > 1 for a 2D array
+    TEXTURE_3D,     // depth slices are stored inside each mip, arrayLayers is always 1
+    TEXTURE_CUBE,   // arrayLayers is 6 * cube count, faces are ordered +x -x +y -y +z -z
+};
+
+// data is layer major, each layer holds its full mip chain: [layer 0: mip 0 .. mip n][layer 1: mip 0 .. mip n]..
 struct RawImage {
     TextureFormat textureFormat;
+    TextureDimension dimension;
     uint32_t mipMapCount;
     uint32_t width;
     uint32_t height;
     uint32_t depth;
+    uint32_t arrayLayers;
 
     uint32_t dataSize;
-    uint32_t mipDataSizes[BEET_MAX_MIP_COUNT];
+    uint32_t layerDataSize;
+    uint32_t mipDataSizes[BEET_MAX_MIP_COUNT]; // size of a single layer's mip, including every depth slice for 3D
+    uint32_t mipOffsets[BEET_MAX_MIP_COUNT];   // offset of each mip from the start of its layer
     void *data;
+
+    // only set for images from load_dds_image_mapped, data then points into this read only file mapping.
+    const void *mappedFile;
+    size_t mappedFileSize;
 };
+
+inline const void *raw_image_subresource_data(const RawImage &rawImage, const uint32_t layer, const uint32_t mip) {
+    return (const unsigned char *) rawImage.data + (size_t) layer * rawImage.layerDataSize + rawImage.mipOffsets[mip];
+}
 //======================================================================================================================
 
 #endif //BEETROOT_TEXTURE_FORMATS_H
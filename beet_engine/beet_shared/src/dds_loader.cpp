@@ -3,7 +3,9 @@
 #include <beet_shared/assert.h>
 #include <beet_shared/texture_formats.h>
 #include <beet_shared/memory.h>
+#include <beet_shared/os_memory.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cstring>
@@ -45,6 +47,9 @@ struct HeaderDDSDXT10 {
     uint32_t miscFlags2;            // Contains additional metadata. The lower 3 bits indicate the alpha mode
 };
 
+constexpr uint32_t DDS_DIMENSION_TEXTURE3D = 4;               // HeaderDDSDXT10::resourceDimension
+constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;       // HeaderDDSDXT10::miscFlag
+
 enum class TextureFormatDXGI : uint32_t {
     DXGI_FORMAT_UNKNOWN = 0,
     DXGI_FORMAT_R32G32B32A32_TYPELESS = 1,
@@ -417,63 +422,107 @@ static void get_image_info(
 }
 //======================================================================================================================
 
-//===API================================================================================================================
-void load_dds_image_alloc(const char *path, RawImage *outRawImage) {
-    log_verbose(MSG_DDS, "loading dds image : %s \n", path);
-
-    std::ifstream file{path, std::ios::ate | std::ios::binary};
-    ASSERT_MSG(file.is_open(), "Err: failed to find path: %s \n", path);
-    const size_t fileSize = file.tellg();
-
-    char *rawFileData = (char *) mem_zalloc(fileSize);
-    char ext[4] = {};
-    file.seekg(0);
-    file.read(ext, sizeof(uint32_t));
-    file.read(rawFileData, fileSize - sizeof(uint32_t));
+// fills every field of outRawImage except data, returns the start of the pixel payload within fileData.
+static const unsigned char *dds_parse_image(const unsigned char *fileData, const size_t fileSize, const char *path, RawImage *outRawImage) {
+    constexpr size_t magicSize = sizeof(uint32_t);
+    ASSERT_MSG(fileSize >= magicSize + sizeof(HeaderDDS), "Err: file too small to be a dds image: %s \n", path);
     const char expectedHeaderFmt[4] = {'D', 'D', 'S', ' '};
-    ASSERT_MSG(memcmp(ext, expectedHeaderFmt, sizeof(char) * 4) == 0,
-               "Err: input header did not match [D][D][S][] received [%c][%c][%c][%c] for path : %s \n", ext[0], ext[1], ext[2], ext[3], path);
-    file.close();
+    ASSERT_MSG(memcmp(fileData, expectedHeaderFmt, sizeof(char) * 4) == 0,
+               "Err: input header did not match [D][D][S][] received [%c][%c][%c][%c] for path : %s \n", fileData[0], fileData[1], fileData[2], fileData[3], path);
 
-    const HeaderDDS *header = reinterpret_cast<const HeaderDDS *> (rawFileData);
+    const HeaderDDS *header = reinterpret_cast<const HeaderDDS *> (fileData + magicSize);
+    const HeaderDDSDXT10 *d3d10ext = reinterpret_cast<const HeaderDDSDXT10 *>((const char *) header + sizeof(HeaderDDS));
+    // legacy FourCC / pixel mask headers carry no DXGI format, so neither their format nor their mip sizes are known.
+    const bool hasDX10Header = constexpr_make_four_cc('D', 'X', '1', '0') == header->ddspf.dwFourCC;
+    ASSERT_MSG(hasDX10Header, "Err: only dds files with a DX10 header are supported, re-export with a DXGI format: %s \n", path);
+    ASSERT_MSG(fileSize >= magicSize + sizeof(HeaderDDS) + sizeof(HeaderDDSDXT10), "Err: dds DX10 header is truncated: %s \n", path);
 
     const uint32_t width = header->dwWidth;
     const uint32_t height = header->dwHeight;
-    const uint32_t depth = header->dwDepth;
     uint32_t mipCount = header->dwMipMapCount;
-    TextureFormatDXGI format{};
 
     ASSERT_MSG(mipCount < BEET_MAX_MIP_COUNT, "Err: mip count exceeded max supported mip count of %u", BEET_MAX_MIP_COUNT)
     if (mipCount == 0) {
         mipCount = 1;
     }
 
-    const HeaderDDSDXT10 *d3d10ext = reinterpret_cast<const HeaderDDSDXT10 *>((const char *) header + sizeof(HeaderDDS));
+    const TextureFormatDXGI format = (TextureFormatDXGI) d3d10ext->dxgiFormat;
+    TextureDimension dimension = TextureDimension::TEXTURE_2D;
+    uint32_t arrayLayers = d3d10ext->arraySize == 0 ? 1 : d3d10ext->arraySize;
+    if (d3d10ext->resourceDimension == DDS_DIMENSION_TEXTURE3D) {
+        dimension = TextureDimension::TEXTURE_3D;
+        ASSERT_MSG(arrayLayers == 1, "Err: 3D texture arrays are not supported: %s \n", path);
+    } else if (d3d10ext->miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) {
+        dimension = TextureDimension::TEXTURE_CUBE;
+        arrayLayers *= 6;
+    }
+    const uint32_t depth = dimension == TextureDimension::TEXTURE_3D && header->dwDepth > 0 ? header->dwDepth : 1;
 
     uint32_t outNumBytes{};
     uint32_t outRowBytes{};
     uint32_t outNumRows{};
-    size_t sumOfMipData = 0;
-    for (int i = 0; i < mipCount; ++i) {
-        if (constexpr_make_four_cc('D', 'X', '1', '0') == header->ddspf.dwFourCC) {
-            format = (TextureFormatDXGI) d3d10ext->dxgiFormat;
-            get_image_info(width >> i, height >> i, format, &outNumBytes, &outRowBytes, &outNumRows);
-            outRawImage->mipDataSizes[i] = outNumBytes;
-            sumOfMipData += outNumBytes;
-        }
+    size_t layerDataSize = 0;
+    for (uint32_t i = 0; i < mipCount; ++i) {
+        get_image_info(std::max(1u, width >> i), std::max(1u, height >> i), format, &outNumBytes, &outRowBytes, &outNumRows);
+        outRawImage->mipDataSizes[i] = outNumBytes * std::max(1u, depth >> i);
+        outRawImage->mipOffsets[i] = layerDataSize;
+        layerDataSize += outRawImage->mipDataSizes[i];
     }
+    const size_t dataSize = layerDataSize * arrayLayers;
+
+    const size_t imageStartOffset = magicSize + sizeof(HeaderDDS) + sizeof(HeaderDDSDXT10);
+    ASSERT_MSG(dataSize <= UINT32_MAX, "Err: dds image exceeds 4GB: %s \n", path);
+    ASSERT_MSG(imageStartOffset + dataSize <= fileSize, "Err: dds image is truncated, expected %zu bytes of image data: %s \n", dataSize, path);
 
-    const void *imageStartPos = (unsigned char *) header + sizeof(HeaderDDS) + sizeof(HeaderDDSDXT10);
     outRawImage->textureFormat = internal_dxgi_to_beet_texture_format(format);
+    outRawImage->dimension = dimension;
     outRawImage->mipMapCount = mipCount;
     outRawImage->width = width;
     outRawImage->height = height;
     outRawImage->depth = depth;
-    outRawImage->dataSize = sumOfMipData;
+    outRawImage->arrayLayers = arrayLayers;
+    outRawImage->layerDataSize = layerDataSize;
+    outRawImage->dataSize = dataSize;
+    return fileData + imageStartOffset;
+}
+//======================================================================================================================
 
-    outRawImage->data = (unsigned char *) mem_zalloc(outRawImage->dataSize);
+//===API================================================================================================================
+void load_dds_image_alloc(const char *path, RawImage *outRawImage) {
+    log_verbose(MSG_DDS, "loading dds image : %s \n", path);
+
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    ASSERT_MSG(file.is_open(), "Err: failed to find path: %s \n", path);
+    const size_t fileSize = file.tellg();
+
+    unsigned char *rawFileData = (unsigned char *) mem_malloc(fileSize, MSG_DDS);
+    file.seekg(0);
+    file.read((char *) rawFileData, fileSize);
+    file.close();
+
+    const unsigned char *imageStartPos = dds_parse_image(rawFileData, fileSize, path, outRawImage);
+    outRawImage->data = mem_malloc(outRawImage->dataSize, MSG_DDS);
     memcpy(outRawImage->data, imageStartPos, outRawImage->dataSize);
 
     mem_free(rawFileData);
 }
+
+void load_dds_image_mapped(const char *path, RawImage *outRawImage) {
+    log_verbose(MSG_DDS, "mapping dds image : %s \n", path);
+
+    size_t fileSize = 0;
+    const void *mappedFile = os_file_map_readonly(path, fileSize);
+    ASSERT_MSG(mappedFile != nullptr, "Err: failed to map path: %s \n", path);
+
+    const unsigned char *imageStartPos = dds_parse_image((const unsigned char *) mappedFile, fileSize, path, outRawImage);
+    outRawImage->data = const_cast<unsigned char *>(imageStartPos);
+    outRawImage->mappedFile = mappedFile;
+    outRawImage->mappedFileSize = fileSize;
+}
+
+void unload_dds_image_mapped(RawImage *rawImage) {
+    ASSERT_MSG(rawImage->mappedFile != nullptr, "Err: image was not loaded with load_dds_image_mapped");
+    os_file_unmap(rawImage->mappedFile, rawImage->mappedFileSize);
+    *rawImage = {};
+}
 //======================================================================================================================
\ No newline at end of file
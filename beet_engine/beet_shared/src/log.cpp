@@ -1,5 +1,368 @@
 #include <beet_shared/log.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+//===INTERNAL_STRUCTS===================================================================================================
+// Each producer thread owns a single producer / single consumer ring, the sink thread is the only consumer.
+// Rings hold variable sized packed records so a one line message costs its header rather than a whole LogRecord.
+constexpr uint32_t LOG_RING_SIZE = 64 * 1024;
+constexpr uint32_t LOG_MAX_PRODUCER_THREADS = 32;
+constexpr uint32_t LOG_LINE_SIZE = 2048;
+constexpr uint32_t LOG_PACKED_ALIGNMENT = 8;
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "ring size must be a power of two");
+
+// header of a record in a ring, followed by argCount args, argCount arg types and stringSize bytes of strings.
+// packedSize comes first so a wrap marker only needs the 8 bytes every record is aligned to.
+struct LogPackedRecord {
+    uint32_t packedSize; // header and payload rounded up to LOG_PACKED_ALIGNMENT, 0 pads out the end of the ring
+    MSG_CHANNEL channel;
+    const char *format;
+    int64_t timestampNs;
+    MSG_LEVEL level;
+    uint8_t argCount;
+    uint16_t stringSize;
+    uint32_t unused_0;
+};
+static_assert(sizeof(LogPackedRecord) % LOG_PACKED_ALIGNMENT == 0);
+static_assert(sizeof(LogPackedRecord) + (sizeof(uint64_t) + 1) * LOG_MAX_ARGS + LOG_RECORD_STRING_SIZE < LOG_RING_SIZE);
+
+struct LogRing {
+    std::atomic<uint32_t> head; // byte offsets, wrap at LOG_RING_SIZE when indexing
+    std::atomic<uint32_t> tail;
+    std::atomic<bool> owned; // cleared when the producer thread exits, the next new thread takes the ring over
+    uint8_t data[LOG_RING_SIZE];
+};
+
+// releases the calling thread's ring on thread exit so short lived threads don't use up LOG_MAX_PRODUCER_THREADS.
+struct LogThreadRing {
+    LogRing *ring = {nullptr};
+    uint32_t generation = {0};
+    ~LogThreadRing();
+};
+
+static struct LogState {
+    LogConfig config = {};
+    FILE *file = {nullptr};
+    std::thread sinkThread = {};
+    std::atomic<bool> running = {false};
+    std::atomic<uint32_t> generation = {0};
+
+    std::atomic<LogRing *> rings[LOG_MAX_PRODUCER_THREADS] = {};
+    std::atomic<uint32_t> ringCount = {0};
+    std::atomic<uint64_t> droppedCount = {0};
+
+    std::mutex syncWriteMutex;
+} s_logState;
+
+static constexpr uint32_t log_level_channel_mask(const uint32_t level) {
+    return level >= MSG_MIN_WARNING_LEVEL ? (uint32_t) (MSG_ACTIVE_CHANNELS) : 0u;
+}
+
+std::atomic<uint32_t> g_logLevelChannelMasks[MSG_LEVEL_COUNT] = {
+        log_level_channel_mask(MSG_VERBOSE),
+        log_level_channel_mask(MSG_INFO),
+        log_level_channel_mask(MSG_DEBUG),
+        log_level_channel_mask(MSG_WARNING),
+        log_level_channel_mask(MSG_ERROR),
+        log_level_channel_mask(MSG_CRITICAL),
+};
+
+static struct LogFilterState {
+    std::mutex mutex;
+    uint32_t channelMask = {MSG_ACTIVE_CHANNELS};
+    MSG_LEVEL minLevel = {MSG_MIN_WARNING_LEVEL};
+} s_logFilterState;
+
+static thread_local LogThreadRing t_logRing = {};
+
+LogThreadRing::~LogThreadRing() {
+    // rings from an older log_create have already been freed by log_cleanup.
+    if (ring != nullptr && generation == s_logState.generation.load(std::memory_order_acquire)) {
+        ring->owned.store(false, std::memory_order_release);
+    }
+}
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static int64_t log_timestamp_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void log_write_line(const char *line, const size_t lineSize) {
+    if (s_logState.config.writeToStdout) {
+        fwrite(line, 1, lineSize, stdout);
+    }
+    if (s_logState.file) {
+        fwrite(line, 1, lineSize, s_logState.file);
+    }
+}
+
+static void log_write_record(const LogRecord &record) {
+    char line[LOG_LINE_SIZE];
+    const size_t lineSize = log_record_format(record, line, LOG_LINE_SIZE);
+    log_write_line(line, lineSize);
+}
+
+static uint32_t log_packed_size(const LogRecord &record) {
+    const uint32_t size = (uint32_t) sizeof(LogPackedRecord) + (sizeof(uint64_t) + sizeof(uint8_t)) * record.argCount + record.stringSize;
+    return (size + LOG_PACKED_ALIGNMENT - 1) & ~(LOG_PACKED_ALIGNMENT - 1);
+}
+
+static void log_pack_record(const LogRecord &record, const uint32_t packedSize, uint8_t *outData) {
+    const LogPackedRecord header = {
+            .packedSize = packedSize,
+            .channel = record.channel,
+            .format = record.format,
+            .timestampNs = record.timestampNs,
+            .level = record.level,
+            .argCount = record.argCount,
+            .stringSize = record.stringSize,
+            .unused_0 = 0,
+    };
+    memcpy(outData, &header, sizeof(LogPackedRecord));
+    uint8_t *payload = outData + sizeof(LogPackedRecord);
+    memcpy(payload, record.args, sizeof(uint64_t) * record.argCount);
+    payload += sizeof(uint64_t) * record.argCount;
+    memcpy(payload, record.argTags, sizeof(uint8_t) * record.argCount);
+    payload += sizeof(uint8_t) * record.argCount;
+    memcpy(payload, record.stringData, record.stringSize);
+}
+
+static void log_unpack_record(const uint8_t *data, LogRecord &outRecord) {
+    LogPackedRecord header;
+    memcpy(&header, data, sizeof(LogPackedRecord));
+    outRecord.format = header.format;
+    outRecord.timestampNs = header.timestampNs;
+    outRecord.channel = header.channel;
+    outRecord.level = header.level;
+    outRecord.argCount = header.argCount;
+    outRecord.stringSize = header.stringSize;
+    const uint8_t *payload = data + sizeof(LogPackedRecord);
+    memcpy(outRecord.args, payload, sizeof(uint64_t) * header.argCount);
+    payload += sizeof(uint64_t) * header.argCount;
+    memcpy(outRecord.argTags, payload, sizeof(uint8_t) * header.argCount);
+    payload += sizeof(uint8_t) * header.argCount;
+    memcpy(outRecord.stringData, payload, header.stringSize);
+}
+
+// ring storage is taken from calloc rather than mem_zalloc, the memory lib logs and would otherwise recurse into us.
+static LogRing *log_acquire_thread_ring() {
+    const uint32_t generation = s_logState.generation.load(std::memory_order_acquire);
+    if (t_logRing.ring != nullptr && t_logRing.generation == generation) {
+        return t_logRing.ring;
+    }
+
+    // a ring left behind by an exited thread is taken over as is, records it still holds keep their order.
+    const uint32_t ringCount = s_logState.ringCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < ringCount && i < LOG_MAX_PRODUCER_THREADS; ++i) {
+        LogRing *ring = s_logState.rings[i].load(std::memory_order_acquire);
+        bool expected = false;
+        if (ring && ring->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            t_logRing.ring = ring;
+            t_logRing.generation = generation;
+            return ring;
+        }
+    }
+
+    const uint32_t ringIndex = s_logState.ringCount.fetch_add(1, std::memory_order_acq_rel);
+    if (ringIndex >= LOG_MAX_PRODUCER_THREADS) {
+        s_logState.ringCount.fetch_sub(1, std::memory_order_acq_rel);
+        return nullptr;
+    }
+    LogRing *ring = (LogRing *) calloc(1, sizeof(LogRing));
+    ring->owned.store(true, std::memory_order_relaxed);
+    s_logState.rings[ringIndex].store(ring, std::memory_order_release);
+    t_logRing.ring = ring;
+    t_logRing.generation = generation;
+    return ring;
+}
+
+static bool log_drain_ring(LogRing &ring) {
+    const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    const uint32_t head = ring.head.load(std::memory_order_acquire);
+    LogRecord record;
+    for (uint32_t position = tail; position != head;) {
+        const uint32_t offset = position & (LOG_RING_SIZE - 1);
+        uint32_t packedSize;
+        memcpy(&packedSize, ring.data + offset, sizeof(uint32_t));
+        if (packedSize == 0) {
+            position += LOG_RING_SIZE - offset;
+            continue;
+        }
+        log_unpack_record(ring.data + offset, record);
+        log_write_record(record);
+        position += packedSize;
+    }
+    // tail only moves once the records are written so log_flush can treat an empty ring as written out.
+    ring.tail.store(head, std::memory_order_release);
+    return tail != head;
+}
+
+static bool log_drain_all_rings() {
+    bool wroteRecords = false;
+    const uint32_t ringCount = s_logState.ringCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < ringCount && i < LOG_MAX_PRODUCER_THREADS; ++i) {
+        LogRing *ring = s_logState.rings[i].load(std::memory_order_acquire);
+        if (ring) {
+            wroteRecords |= log_drain_ring(*ring);
+        }
+    }
+
+    const uint64_t droppedCount = s_logState.droppedCount.exchange(0, std::memory_order_relaxed);
+    if (droppedCount > 0) {
+        char line[128];
+        const int lineSize = snprintf(line, sizeof(line), "[log] : dropped [%llu] records, producers outran the sink\n", (unsigned long long) droppedCount);
+        log_write_line(line, (size_t) lineSize);
+    }
+    return wroteRecords;
+}
+
+static void log_sink_thread_main() {
+    while (s_logState.running.load(std::memory_order_acquire)) {
+        if (log_drain_all_rings()) {
+            fflush(stdout);
+            if (s_logState.file) {
+                fflush(s_logState.file);
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    log_drain_all_rings();
+}
+
+static bool log_all_rings_empty() {
+    const uint32_t ringCount = s_logState.ringCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < ringCount && i < LOG_MAX_PRODUCER_THREADS; ++i) {
+        LogRing *ring = s_logState.rings[i].load(std::memory_order_acquire);
+        if (ring && ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void log_filter_publish() {
+    for (uint32_t level = 0; level < MSG_LEVEL_COUNT; ++level) {
+        const uint32_t mask = level >= s_logFilterState.minLevel ? s_logFilterState.channelMask : 0u;
+        g_logLevelChannelMasks[level].store(mask, std::memory_order_relaxed);
+    }
+}
+
+// compares a bare name against a looked up "[name]".
+static bool log_name_matches(const char *name, const size_t nameSize, const char *bracketedName) {
+    const size_t bracketedSize = strlen(bracketedName);
+    return bracketedSize == nameSize + 2 && strncmp(bracketedName + 1, name, nameSize) == 0;
+}
+
+static size_t log_append(const size_t bufferSize, size_t offset, const int written) {
+    if (written > 0) {
+        offset += (size_t) written;
+    }
+    return offset < bufferSize ? offset : bufferSize - 1;
+}
+
+// Re-expands a conversion spec against the packed argument, length modifiers are replaced to match the stored width.
+// Integers are cut back to the width the caller passed, or narrower for h / hh, as printf would read them.
+static size_t log_format_arg(const LogRecord &record, const char *spec, const size_t specSize, const char conversion, uint32_t &argIndex, char *outBuffer, size_t bufferSize) {
+    char fmt[32] = {};
+    size_t fmtSize = 0;
+    uint32_t modifierWidth = 0;
+    for (size_t i = 0; i < specSize && fmtSize < sizeof(fmt) - 4; ++i) {
+        const char c = spec[i];
+        if (c == 'h') {
+            modifierWidth = modifierWidth == sizeof(short) ? sizeof(char) : sizeof(short);
+            continue;
+        }
+        if (c == 'l' || c == 'j' || c == 'z' || c == 't' || c == 'L' || c == 'q') {
+            continue;
+        }
+        if (c == '*') {
+            const uint32_t index = argIndex++;
+            const int64_t value = index < record.argCount ? (int64_t) record.args[index] : 0;
+            fmtSize += snprintf(fmt + fmtSize, sizeof(fmt) - fmtSize, "%lld", (long long) value);
+            continue;
+        }
+        fmt[fmtSize++] = c;
+    }
+
+    if (argIndex >= record.argCount) {
+        return (size_t) snprintf(outBuffer, bufferSize, "<missing>");
+    }
+    const uint32_t index = argIndex++;
+    const uint64_t raw = record.args[index];
+    const LOG_ARG_TYPE type = log_arg_type(record.argTags[index]);
+    double asDouble = 0.0;
+    if (type == LOG_ARG_DOUBLE) {
+        memcpy(&asDouble, &raw, sizeof(double));
+    }
+    uint32_t width = log_arg_width(record.argTags[index]);
+    if (width == 0 || width > sizeof(uint64_t)) {
+        width = sizeof(uint64_t);
+    }
+    if (modifierWidth != 0 && modifierWidth < width) {
+        width = modifierWidth;
+    }
+    const uint32_t unusedBits = (uint32_t) (sizeof(uint64_t) - width) * 8;
+    const uint64_t asUnsigned = (raw << unusedBits) >> unusedBits;
+    const int64_t asSigned = (int64_t) (raw << unusedBits) >> unusedBits;
+
+    int written = 0;
+    switch (conversion) {
+        case 'd':
+        case 'i': {
+            memcpy(fmt + fmtSize, "lld", 4);
+            written = snprintf(outBuffer, bufferSize, fmt, type == LOG_ARG_DOUBLE ? (long long) asDouble : (long long) asSigned);
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X': {
+            fmt[fmtSize++] = 'l';
+            fmt[fmtSize++] = 'l';
+            fmt[fmtSize++] = conversion;
+            written = snprintf(outBuffer, bufferSize, fmt, type == LOG_ARG_DOUBLE ? (unsigned long long) asDouble : (unsigned long long) asUnsigned);
+            break;
+        }
+        case 'c': {
+            fmt[fmtSize++] = 'c';
+            written = snprintf(outBuffer, bufferSize, fmt, (int) raw);
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            fmt[fmtSize++] = conversion;
+            written = snprintf(outBuffer, bufferSize, fmt, type == LOG_ARG_DOUBLE ? asDouble : (double) asSigned);
+            break;
+        }
+        case 's': {
+            fmt[fmtSize++] = 's';
+            written = snprintf(outBuffer, bufferSize, fmt, type == LOG_ARG_STRING ? record.stringData + raw : "(null)");
+            break;
+        }
+        case 'p': {
+            fmt[fmtSize++] = 'p';
+            written = snprintf(outBuffer, bufferSize, fmt, (void *) (uintptr_t) raw);
+            break;
+        }
+        default:
+            break;
+    }
+    return written > 0 ? (size_t) written : 0;
+}
+//======================================================================================================================
+
 //===API================================================================================================================
 const char *log_channel_name_lookup(const MSG_CHANNEL &channel) {
     switch (channel) {
@@ -20,6 +383,10 @@ const char *log_channel_name_lookup(const MSG_CHANNEL &channel) {
             return "[math]";
         case MSG_DDS:
             return "[dds]";
+        case MSG_DB:
+            return "[db]";
+        case MSG_GLTF:
+            return "[gltf]";
 
         case MSG_DBG:
             return "[debugging]";
@@ -32,4 +399,272 @@ const char *log_channel_name_lookup(const MSG_CHANNEL &channel) {
     }
     return "[unknown]";
 }
-//======================================================================================================================
\ No newline at end of file
+
+const char *log_level_name_lookup(const MSG_LEVEL &level) {
+    switch (level) {
+        case MSG_VERBOSE:
+            return "[verbose]";
+        case MSG_INFO:
+            return "[info]";
+        case MSG_DEBUG:
+            return "[debug]";
+        case MSG_WARNING:
+            return "[warning]";
+        case MSG_ERROR:
+            return "[error]";
+        case MSG_CRITICAL:
+            return "[critical]";
+        case MSG_LEVEL_COUNT:
+            break;
+    }
+    return "[unknown]";
+}
+
+void log_set_channel_mask(const uint32_t channelMask) {
+    std::lock_guard<std::mutex> lock(s_logFilterState.mutex);
+    s_logFilterState.channelMask = channelMask;
+    log_filter_publish();
+}
+
+uint32_t log_get_channel_mask() {
+    std::lock_guard<std::mutex> lock(s_logFilterState.mutex);
+    return s_logFilterState.channelMask;
+}
+
+void log_set_min_level(const MSG_LEVEL level) {
+    std::lock_guard<std::mutex> lock(s_logFilterState.mutex);
+    s_logFilterState.minLevel = level < MSG_LEVEL_COUNT ? level : MSG_CRITICAL;
+    log_filter_publish();
+}
+
+MSG_LEVEL log_get_min_level() {
+    std::lock_guard<std::mutex> lock(s_logFilterState.mutex);
+    return s_logFilterState.minLevel;
+}
+
+bool log_parse_channel_mask(const char *channels, uint32_t &outChannelMask) {
+    uint32_t mask = 0;
+    const char *token = channels;
+    while (token && *token != '\0') {
+        const char *tokenEnd = strchr(token, ',');
+        size_t tokenSize = tokenEnd ? (size_t) (tokenEnd - token) : strlen(token);
+        const bool remove = tokenSize > 0 && token[0] == '-';
+        const char *name = remove ? token + 1 : token;
+        const size_t nameSize = remove ? tokenSize - 1 : tokenSize;
+
+        uint32_t channel = MSG_NONE;
+        if (nameSize == 3 && strncmp(name, "all", 3) == 0) {
+            channel = MSG_ALL;
+        } else if (nameSize == 4 && strncmp(name, "none", 4) == 0) {
+            channel = MSG_NONE;
+        } else {
+            bool found = false;
+            for (const MSG_CHANNEL namedChannel: LOG_NAMED_CHANNELS) {
+                if (log_name_matches(name, nameSize, log_channel_name_lookup(namedChannel))) {
+                    channel = namedChannel;
+                    found = true;
+                    break;
+                }
+            }
+            // "dbg" reads better on a command line than the "[debugging]" display name.
+            if (!found && nameSize == 3 && strncmp(name, "dbg", 3) == 0) {
+                channel = MSG_DBG;
+                found = true;
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        mask = remove ? (mask & ~channel) : (mask | channel);
+        token = tokenEnd ? tokenEnd + 1 : nullptr;
+    }
+    outChannelMask = mask;
+    return true;
+}
+
+bool log_parse_level(const char *level, MSG_LEVEL &outLevel) {
+    for (uint32_t i = 0; i < MSG_LEVEL_COUNT; ++i) {
+        if (log_name_matches(level, strlen(level), log_level_name_lookup((MSG_LEVEL) i))) {
+            outLevel = (MSG_LEVEL) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void log_configure_from_env() {
+    uint32_t channelMask = 0;
+    MSG_LEVEL level = MSG_VERBOSE;
+    const char *channels = getenv("BEET_LOG_CHANNELS");
+    if (channels && log_parse_channel_mask(channels, channelMask)) {
+        log_set_channel_mask(channelMask);
+    }
+    const char *levelName = getenv("BEET_LOG_LEVEL");
+    if (levelName && log_parse_level(levelName, level)) {
+        log_set_min_level(level);
+    }
+}
+
+void log_configure_from_args(const int32_t argc, char **argv) {
+    constexpr const char *CHANNELS_ARG = "-logChannels=";
+    constexpr const char *LEVEL_ARG = "-logLevel=";
+    for (int32_t i = 1; i < argc; ++i) {
+        uint32_t channelMask = 0;
+        MSG_LEVEL level = MSG_VERBOSE;
+        if (strncmp(argv[i], CHANNELS_ARG, strlen(CHANNELS_ARG)) == 0) {
+            if (log_parse_channel_mask(argv[i] + strlen(CHANNELS_ARG), channelMask)) {
+                log_set_channel_mask(channelMask);
+            } else {
+                fprintf(stderr, "unknown log channel in \"%s\"\n", argv[i]);
+            }
+        } else if (strncmp(argv[i], LEVEL_ARG, strlen(LEVEL_ARG)) == 0) {
+            if (log_parse_level(argv[i] + strlen(LEVEL_ARG), level)) {
+                log_set_min_level(level);
+            } else {
+                fprintf(stderr, "unknown log level in \"%s\"\n", argv[i]);
+            }
+        }
+    }
+}
+
+void log_record_begin(LogRecord &record, const MSG_LEVEL level, const MSG_CHANNEL channel, const char *format) {
+    record.format = format;
+    record.timestampNs = log_timestamp_now();
+    record.channel = channel;
+    record.level = level;
+    record.argCount = 0;
+    record.stringSize = 0;
+}
+
+void log_record_push_string(LogRecord &record, const char *string) {
+    const uint8_t index = record.argCount;
+    record.argCount++;
+    record.argTags[index] = log_arg_tag(LOG_ARG_STRING, 0);
+    record.args[index] = record.stringSize;
+    if (record.stringSize >= LOG_RECORD_STRING_SIZE) {
+        // out of string space, point at the last terminator written.
+        record.args[index] = LOG_RECORD_STRING_SIZE - 1;
+        return;
+    }
+    const char *source = string ? string : "(null)";
+    const size_t available = LOG_RECORD_STRING_SIZE - record.stringSize - 1;
+    size_t length = strlen(source);
+    length = length < available ? length : available;
+    memcpy(record.stringData + record.stringSize, source, length);
+    record.stringData[record.stringSize + length] = '\0';
+    record.stringSize += (uint16_t) (length + 1);
+}
+
+void log_record_submit(const LogRecord &record) {
+    LogRing *ring = s_logState.running.load(std::memory_order_acquire) ? log_acquire_thread_ring() : nullptr;
+    if (ring == nullptr) {
+        std::lock_guard<std::mutex> lock(s_logState.syncWriteMutex);
+        log_write_record(record);
+        return;
+    }
+
+    // records never wrap, when one doesn't fit before the end of the ring the rest is padded and it starts at 0.
+    const uint32_t packedSize = log_packed_size(record);
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    const uint32_t contiguous = LOG_RING_SIZE - (head & (LOG_RING_SIZE - 1));
+    const uint32_t padding = contiguous < packedSize ? contiguous : 0;
+    while (head + padding + packedSize - ring->tail.load(std::memory_order_acquire) > LOG_RING_SIZE) {
+        if (s_logState.config.queuePolicy == LOG_QUEUE_POLICY_DROP) {
+            s_logState.droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+    if (padding != 0) {
+        const uint32_t wrapMarker = 0;
+        memcpy(ring->data + (head & (LOG_RING_SIZE - 1)), &wrapMarker, sizeof(uint32_t));
+        head += padding;
+    }
+    log_pack_record(record, packedSize, ring->data + (head & (LOG_RING_SIZE - 1)));
+    ring->head.store(head + packedSize, std::memory_order_release);
+}
+
+size_t log_record_format(const LogRecord &record, char *outBuffer, const size_t bufferSize) {
+    time_t seconds = (time_t) (record.timestampNs / 1000000000);
+    struct tm buf{};
+    os_localtime(buf, seconds);
+    size_t offset = 0;
+    offset = log_append(bufferSize, offset, snprintf(outBuffer, bufferSize, "[%i:%i:%i]%s%s : ", buf.tm_hour, buf.tm_min, buf.tm_sec, log_level_name_lookup(record.level), log_channel_name_lookup(record.channel)));
+
+    uint32_t argIndex = 0;
+    for (const char *c = record.format; *c != '\0' && offset < bufferSize - 1; ++c) {
+        if (*c != '%') {
+            outBuffer[offset++] = *c;
+            continue;
+        }
+        if (*(c + 1) == '%') {
+            outBuffer[offset++] = '%';
+            ++c;
+            continue;
+        }
+        const char *spec = c;
+        ++c;
+        while (*c != '\0' && strchr("diuoxXcfFeEgGaAspn", *c) == nullptr) {
+            ++c;
+        }
+        if (*c == '\0') {
+            break;
+        }
+        if (*c == 'n') {
+            continue;
+        }
+        const size_t written = log_format_arg(record, spec, (size_t) (c - spec), *c, argIndex, outBuffer + offset, bufferSize - offset);
+        offset = log_append(bufferSize, offset, (int) written);
+    }
+    outBuffer[offset] = '\0';
+    return offset;
+}
+
+void log_create(const LogConfig &config) {
+    if (s_logState.running.load(std::memory_order_acquire)) {
+        return;
+    }
+    s_logState.config = config;
+    if (config.filePath) {
+        s_logState.file = fopen(config.filePath, "wb");
+    }
+    s_logState.generation.fetch_add(1, std::memory_order_acq_rel);
+    s_logState.running.store(true, std::memory_order_release);
+    s_logState.sinkThread = std::thread(log_sink_thread_main);
+}
+
+void log_flush() {
+    if (!s_logState.running.load(std::memory_order_acquire)) {
+        fflush(stdout);
+        return;
+    }
+    while (!log_all_rings_empty()) {
+        std::this_thread::yield();
+    }
+    fflush(stdout);
+    if (s_logState.file) {
+        fflush(s_logState.file);
+    }
+}
+
+void log_cleanup() {
+    if (!s_logState.running.load(std::memory_order_acquire)) {
+        return;
+    }
+    s_logState.running.store(false, std::memory_order_release);
+    s_logState.sinkThread.join();
+    // threads still holding a ring see a new generation and neither use nor release the freed storage.
+    s_logState.generation.fetch_add(1, std::memory_order_acq_rel);
+
+    const uint32_t ringCount = s_logState.ringCount.exchange(0, std::memory_order_acq_rel);
+    for (uint32_t i = 0; i < ringCount && i < LOG_MAX_PRODUCER_THREADS; ++i) {
+        free(s_logState.rings[i].exchange(nullptr, std::memory_order_acq_rel));
+    }
+    if (s_logState.file) {
+        fclose(s_logState.file);
+        s_logState.file = nullptr;
+    }
+    fflush(stdout);
+    s_logState.config = {};
+}
+//======================================================================================================================
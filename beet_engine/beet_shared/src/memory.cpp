@@ -1,113 +1,545 @@
 #include <beet_shared/memory.h>
 #include <beet_shared/assert.h>
+#include <beet_shared/os_memory.h>
+#include <beet_shared/log.h>
 
 #include <cstring>
 #include <cstdlib>
+#include <atomic>
+#include <bit>
 
-#if BEET_MEMORY_DEBUG
+#if BEET_MEMORY_TLSF
 
-#include <cstdint>
-#include <beet_shared/log.h>
+#include <mutex>
 
-#endif //BEET_MEMORY_DEBUG
+#endif //BEET_MEMORY_TLSF
 
 //===INTERNAL_STRUCTS===================================================================================================
+// sits directly in front of every block handed out by mem_malloc / mem_aligned_alloc.
+struct MemBlockHeader {
+    uint64_t size;
+    uint32_t tag;
+    uint16_t offset; // distance from the start of the backend allocation to the user pointer
+    uint16_t aligned;
+};
+constexpr size_t MEM_BLOCK_HEADER_SIZE = 16;
+static_assert(sizeof(MemBlockHeader) == MEM_BLOCK_HEADER_SIZE);
+
+constexpr uint32_t MEM_TAG_COUNT = 32;
+// bit 0 is not a MSG_CHANNEL, its slot collects MSG_NONE and anything else that isn't a single channel.
+constexpr uint32_t MEM_TAG_UNTAGGED_INDEX = 0;
+
+struct MemTagState {
+    std::atomic<size_t> currentBytes;
+    std::atomic<size_t> highWatermark;
+    std::atomic<uint32_t> liveAllocations;
+    std::atomic<uint64_t> totalAllocations;
+    std::atomic<bool> overBudget;
+    size_t budgetBytes;
+    MEM_BUDGET_POLICY policy;
+};
+
+static MemTagState s_memTags[MEM_TAG_COUNT] = {};
+
 #if BEET_MEMORY_DEBUG
-#define MAX_ACTIVE_DYNAMIC_ALLOCATIONS 128
+// open addressing table keyed by pointer, storage is taken from raw malloc so the tracker never tracks itself.
+constexpr uint32_t MEM_TRACK_INITIAL_CAPACITY = 1024;
+constexpr uint32_t MEM_TRACK_MAX_LOAD_PERCENT = 70;
+constexpr uint32_t MEM_TRACK_SIZE_CLASS_COUNT = 32;
+static void *const MEM_TRACK_TOMBSTONE = (void *) UINTPTR_MAX;
 
 struct MemoryInfo {
     void *ptrLocation;
     size_t allocSize;
+    size_t alignment; // 0 for blocks from mem_malloc / mem_zalloc
+};
+
+struct MemSizeClass {
+    uint32_t liveCount;
+    uint32_t totalCount;
 };
 
 static struct MemView {
-    MemoryInfo info[MAX_ACTIVE_DYNAMIC_ALLOCATIONS] = {};
-    uint32_t infoCount = 0;
+    MemoryInfo *info = {nullptr};
+    uint32_t capacity = {0};
+    uint32_t infoCount = {0};
+    uint32_t tombstoneCount = {0};
 
     uint32_t totalAllocations = {};
     uint32_t totalFrees = {};
+
+    size_t liveBytes = {};
+    size_t peakLiveBytes = {};
+    MemSizeClass sizeClasses[MEM_TRACK_SIZE_CLASS_COUNT] = {};
 } s_memView;
 #endif //BEET_MEMORY_DEBUG
 //======================================================================================================================
 
 //===INTERNAL_FUNCTIONS=================================================================================================
 #if BEET_MEMORY_DEBUG
+inline static uint32_t mem_track_hash(const void *ptrLocation) {
+    // fibonacci hashing, low bits of heap pointers are mostly alignment so fold them away first.
+    const uint64_t key = (uint64_t) (uintptr_t) ptrLocation >> 4;
+    return (uint32_t) ((key * 11400714819323198485ull) >> 32);
+}
+
+inline static uint32_t mem_track_size_class(size_t allocSize) {
+    // class N holds allocations in (2^(N-1), 2^N] Bytes, the last class takes everything larger.
+    uint32_t sizeClass = 0;
+    while (sizeClass < MEM_TRACK_SIZE_CLASS_COUNT - 1 && ((size_t) 1 << sizeClass) < allocSize) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+static void mem_track_insert(const MemoryInfo info) {
+    const uint32_t mask = s_memView.capacity - 1;
+    uint32_t slot = mem_track_hash(info.ptrLocation) & mask;
+    while (s_memView.info[slot].ptrLocation != nullptr && s_memView.info[slot].ptrLocation != MEM_TRACK_TOMBSTONE) {
+        ASSERT_MSG(s_memView.info[slot].ptrLocation != info.ptrLocation, "Err: allocation [%p] is already tracked\n", info.ptrLocation);
+        slot = (slot + 1) & mask;
+    }
+    if (s_memView.info[slot].ptrLocation == MEM_TRACK_TOMBSTONE) {
+        s_memView.tombstoneCount--;
+    }
+    s_memView.info[slot] = info;
+    s_memView.infoCount++;
+}
+
+static void mem_track_rehash(const uint32_t newCapacity) {
+    MemoryInfo *oldInfo = s_memView.info;
+    const uint32_t oldCapacity = s_memView.capacity;
+
+    s_memView.info = (MemoryInfo *) calloc(newCapacity, sizeof(MemoryInfo));
+    ASSERT_MSG(s_memView.info, "Err: failed to grow allocation tracker to [%u] entries\n", newCapacity);
+    s_memView.capacity = newCapacity;
+    s_memView.infoCount = 0;
+    s_memView.tombstoneCount = 0;
+
+    for (uint32_t i = 0; i < oldCapacity; ++i) {
+        if (oldInfo[i].ptrLocation != nullptr && oldInfo[i].ptrLocation != MEM_TRACK_TOMBSTONE) {
+            mem_track_insert(oldInfo[i]);
+        }
+    }
+    free(oldInfo);
+}
+
 inline static void mem_track_allocation(const MemoryInfo info) {
     if (info.ptrLocation) {
-        ASSERT(s_memView.infoCount < MAX_ACTIVE_DYNAMIC_ALLOCATIONS);
-        s_memView.info[s_memView.infoCount] = info;
-        s_memView.infoCount++;
+        const uint64_t usedSlots = (uint64_t) s_memView.infoCount + s_memView.tombstoneCount + 1;
+        if (usedSlots * 100 > (uint64_t) s_memView.capacity * MEM_TRACK_MAX_LOAD_PERCENT) {
+            // only grow when live entries drive the load, otherwise a same size rehash clears out tombstones.
+            const bool liveHeavy = ((uint64_t) s_memView.infoCount + 1) * 200 > (uint64_t) s_memView.capacity * MEM_TRACK_MAX_LOAD_PERCENT;
+            const uint32_t newCapacity = s_memView.capacity == 0 ? MEM_TRACK_INITIAL_CAPACITY : liveHeavy ? s_memView.capacity * 2 : s_memView.capacity;
+            mem_track_rehash(newCapacity);
+        }
+        mem_track_insert(info);
         s_memView.totalAllocations++;
+
+        MemSizeClass &sizeClass = s_memView.sizeClasses[mem_track_size_class(info.allocSize)];
+        sizeClass.liveCount++;
+        sizeClass.totalCount++;
+        s_memView.liveBytes += info.allocSize;
+        if (s_memView.liveBytes > s_memView.peakLiveBytes) {
+            s_memView.peakLiveBytes = s_memView.liveBytes;
+        }
     }
 }
 
-inline static void mem_track_free(const void *ptrLocation) {
+inline static void mem_track_free(const void *ptrLocation, const bool aligned) {
     bool foundBlock = false;
-    for (int i = 0; i < s_memView.infoCount; ++i) {
-        MemoryInfo &info = s_memView.info[i];
-        if (info.ptrLocation == ptrLocation) {
-            info = s_memView.info[s_memView.infoCount - 1];
-            s_memView.info[s_memView.infoCount - 1] = {};
-            s_memView.infoCount--;
-            foundBlock = true;
+    if (s_memView.capacity != 0) {
+        const uint32_t mask = s_memView.capacity - 1;
+        uint32_t slot = mem_track_hash(ptrLocation) & mask;
+        while (s_memView.info[slot].ptrLocation != nullptr) {
+            MemoryInfo &info = s_memView.info[slot];
+            if (info.ptrLocation == ptrLocation) {
+                ASSERT_MSG((info.alignment != 0) == aligned, "Err: block [%p] freed with the wrong free function, use %s\n", ptrLocation, info.alignment != 0 ? "mem_aligned_free" : "mem_free");
+                s_memView.sizeClasses[mem_track_size_class(info.allocSize)].liveCount--;
+                s_memView.liveBytes -= info.allocSize;
+                info = {.ptrLocation = MEM_TRACK_TOMBSTONE, .allocSize = 0, .alignment = 0};
+                s_memView.infoCount--;
+                s_memView.tombstoneCount++;
+                foundBlock = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
         }
     }
     ASSERT_MSG(foundBlock, "Err: Provided memory block was not found, potential leak or freeing allocation not from memory lib\n");
     s_memView.totalFrees++;
 }
+
+inline static bool mem_track_is_live(const MemoryInfo &info) {
+    return info.ptrLocation != nullptr && info.ptrLocation != MEM_TRACK_TOMBSTONE;
+}
 #endif //BEET_MEMORY_DEBUG
+
+static uint32_t mem_tag_index(const MSG_CHANNEL tag) {
+    if (tag == MSG_NONE) {
+        return MEM_TAG_UNTAGGED_INDEX;
+    }
+    ASSERT_MSG(std::has_single_bit((uint32_t) tag), "Err: allocation tag [%u] must be a single MSG_CHANNEL\n", (uint32_t) tag);
+    // ASSERT doesn't stop every build, never index with a combined mask.
+    return std::has_single_bit((uint32_t) tag) ? std::countr_zero((uint32_t) tag) : MEM_TAG_UNTAGGED_INDEX;
+}
+
+static const char *mem_tag_name(const uint32_t tagIndex) {
+    return tagIndex == MEM_TAG_UNTAGGED_INDEX ? "untagged" : log_channel_name_lookup((MSG_CHANNEL) (1u << tagIndex));
+}
+
+static void mem_tag_charge(const MSG_CHANNEL tag, const size_t bytes) {
+    MemTagState &state = s_memTags[mem_tag_index(tag)];
+    const size_t current = state.currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t highWatermark = state.highWatermark.load(std::memory_order_relaxed);
+    while (current > highWatermark && !state.highWatermark.compare_exchange_weak(highWatermark, current, std::memory_order_relaxed)) {}
+
+    if (state.budgetBytes != 0 && current > state.budgetBytes) {
+        if (state.policy == MEM_BUDGET_POLICY_ASSERT) {
+            ASSERT_MSG(false, "Err: %s exceeded its memory budget, [%zu] of [%zu] Bytes\n", mem_tag_name(mem_tag_index(tag)), current, state.budgetBytes);
+        } else if (!state.overBudget.exchange(true, std::memory_order_relaxed)) {
+            log_warning(MSG_MEMORY, "%s exceeded its memory budget, [%zu] of [%zu] Bytes\n", mem_tag_name(mem_tag_index(tag)), current, state.budgetBytes);
+        }
+    }
+}
+
+static void mem_tag_release(const MSG_CHANNEL tag, const size_t bytes) {
+    MemTagState &state = s_memTags[mem_tag_index(tag)];
+    const size_t current = state.currentBytes.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+    if (state.budgetBytes != 0 && current <= state.budgetBytes) {
+        state.overBudget.store(false, std::memory_order_relaxed);
+    }
+}
+
+static MemBlockHeader *mem_block_header(void *block) {
+    return (MemBlockHeader *) ((uint8_t *) block - MEM_BLOCK_HEADER_SIZE);
+}
+
+static void *mem_block_init(void *backendBlock, const size_t offset, const size_t size, const MSG_CHANNEL tag, const bool aligned) {
+    void *out = (uint8_t *) backendBlock + offset;
+    MemBlockHeader *header = mem_block_header(out);
+    header->size = size;
+    header->tag = (uint32_t) tag;
+    header->offset = (uint16_t) offset;
+    header->aligned = aligned ? 1 : 0;
+
+    mem_tag_charge(tag, size);
+    s_memTags[mem_tag_index(tag)].liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_memTags[mem_tag_index(tag)].totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    return out;
+}
+
+static void *mem_block_release(void *block, const bool aligned) {
+    const MemBlockHeader *header = mem_block_header(block);
+    ASSERT_MSG((header->aligned != 0) == aligned, "Err: block [%p] freed with the wrong free function\n", block);
+    const MSG_CHANNEL tag = (MSG_CHANNEL) header->tag;
+    mem_tag_release(tag, header->size);
+    s_memTags[mem_tag_index(tag)].liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    return (uint8_t *) block - header->offset;
+}
+
+#if BEET_MEMORY_TLSF
+static MemTlsf s_tlsfHeap = {};
+static std::mutex s_tlsfMutex;
+
+static constexpr size_t MEM_HEAP_COMMIT_SIZE = (size_t) BEET_MEMORY_TLSF_COMMIT_MB * 1024 * 1024;
+
+// the heap is created on first use as allocations can happen during static initialisation.
+static void *mem_backend_malloc(const size_t size) {
+    std::lock_guard<std::mutex> lock(s_tlsfMutex);
+    if (s_tlsfHeap.base == nullptr) {
+        mem_tlsf_create(s_tlsfHeap, MEM_TLSF_DEFAULT_RESERVE_SIZE, MEM_HEAP_COMMIT_SIZE);
+    }
+    void *out = mem_tlsf_alloc(s_tlsfHeap, size);
+    if (out == nullptr) {
+        // slow path, the low water check in mem_heap_grow_if_low did not keep up or BEET_MEMORY_TLSF_COMMIT_MB is too small.
+        log_warning(MSG_MEMORY, "tlsf heap has no free block for [%zu] Bytes, growing on the allocation path\n", size);
+        if (mem_tlsf_grow(s_tlsfHeap, size)) {
+            out = mem_tlsf_alloc(s_tlsfHeap, size);
+        }
+    }
+    ASSERT_MSG(out != nullptr, "Err: tlsf heap failed to allocate [%zu] Bytes\n", size);
+    return out;
+}
+
+static void mem_backend_free(void *block) {
+    std::lock_guard<std::mutex> lock(s_tlsfMutex);
+    mem_tlsf_free(s_tlsfHeap, block);
+}
+#else
+static void *mem_backend_malloc(const size_t size) {
+    return malloc(size);
+}
+
+static void mem_backend_free(void *block) {
+    free(block);
+}
+#endif //BEET_MEMORY_TLSF
 //======================================================================================================================
 
 //===API================================================================================================================
-void *mem_zalloc(const size_t size) {
-    void *out = memset(malloc(size), 0, size);
+void *mem_zalloc(const size_t size, const MSG_CHANNEL tag) {
+    return memset(mem_malloc(size, tag), 0, size);
+}
+
+void *mem_malloc(const size_t size, const MSG_CHANNEL tag) {
+    void *backendBlock = mem_backend_malloc(size + MEM_BLOCK_HEADER_SIZE);
+    ASSERT_MSG(backendBlock != nullptr, "Err: failed to allocate [%zu] Bytes\n", size);
+    void *out = mem_block_init(backendBlock, MEM_BLOCK_HEADER_SIZE, size, tag, false);
 #if BEET_MEMORY_DEBUG
-    mem_track_allocation({.ptrLocation = out, .allocSize = size});
+    mem_track_allocation({.ptrLocation = out, .allocSize = size, .alignment = 0});
 #endif //BEET_MEMORY_DEBUG
     return out;
 }
 
-void *mem_malloc(const size_t size) {
-    void *out = malloc(size);
+void mem_free(void *block) {
+    ASSERT_MSG(block != nullptr, "Err: trying to invalidate nullptr");
 #if BEET_MEMORY_DEBUG
-    mem_track_allocation({.ptrLocation = out, .allocSize = size});
+    mem_track_free(block, false);
+#endif //BEET_MEMORY_DEBUG
+    mem_backend_free(mem_block_release(block, false));
+    block = nullptr;
+}
+
+void *mem_aligned_alloc(const size_t size, const size_t alignment, const MSG_CHANNEL tag) {
+    ASSERT_MSG(alignment != 0 && (alignment & (alignment - 1)) == 0, "Err: alignment [%zu] must be a power of two\n", alignment);
+    ASSERT_MSG(alignment <= UINT16_MAX, "Err: alignment [%zu] is too large\n", alignment);
+    // the block header takes a full alignment step in front of the user pointer, this also covers posix_memalign's pointer alignment minimum.
+    const size_t osAlignment = alignment < MEM_BLOCK_HEADER_SIZE ? MEM_BLOCK_HEADER_SIZE : alignment;
+    void *backendBlock = os_aligned_alloc(size + osAlignment, osAlignment);
+    ASSERT_MSG(backendBlock != nullptr, "Err: failed to allocate [%zu] Bytes aligned to [%zu]\n", size, alignment);
+    void *out = mem_block_init(backendBlock, osAlignment, size, tag, true);
+#if BEET_MEMORY_DEBUG
+    mem_track_allocation({.ptrLocation = out, .allocSize = size, .alignment = osAlignment});
 #endif //BEET_MEMORY_DEBUG
     return out;
 }
 
-void mem_free(void *block) {
+void *mem_aligned_zalloc(const size_t size, const size_t alignment, const MSG_CHANNEL tag) {
+    return memset(mem_aligned_alloc(size, alignment, tag), 0, size);
+}
+
+void mem_aligned_free(void *block) {
     ASSERT_MSG(block != nullptr, "Err: trying to invalidate nullptr");
 #if BEET_MEMORY_DEBUG
-    mem_track_free(block);
+    mem_track_free(block, true);
 #endif //BEET_MEMORY_DEBUG
-    free(block);
-    block = nullptr;
+    os_aligned_free(mem_block_release(block, true));
 }
 
 #if BEET_MEMORY_DEBUG
 void mem_dump_memory_info() {
     size_t inUseMemory = {};
     log_info(MSG_MEMORY, "===MEM_INFO_DUMP========\n");
-    for (int i = 0; i < s_memView.infoCount; ++i) {
+    for (uint32_t i = 0; i < s_memView.capacity; ++i) {
+        if (!mem_track_is_live(s_memView.info[i])) {
+            continue;
+        }
         const void *location = s_memView.info[i].ptrLocation;
         const size_t allocSize = s_memView.info[i].allocSize;
-        log_info(MSG_MEMORY, "[%p], [%zu] Bytes\n", location, allocSize);
+        const size_t alignment = s_memView.info[i].alignment;
+        if (alignment != 0) {
+            log_info(MSG_MEMORY, "[%p], [%zu] Bytes, aligned [%zu]\n", location, allocSize, alignment);
+        } else {
+            log_info(MSG_MEMORY, "[%p], [%zu] Bytes\n", location, allocSize);
+        }
         inUseMemory += allocSize;
     }
     log_info(MSG_MEMORY, "In use Memory: [%zu] Bytes\n", inUseMemory);
+    log_info(MSG_MEMORY, "Peak Memory  : [%zu] Bytes\n", s_memView.peakLiveBytes);
     log_info(MSG_MEMORY, "Total allocs : [%u]\n", s_memView.totalAllocations);
     log_info(MSG_MEMORY, "Total frees  : [%u]\n", s_memView.totalFrees);
+    log_info(MSG_MEMORY, "===SIZE_CLASSES=========\n");
+    for (uint32_t i = 0; i < MEM_TRACK_SIZE_CLASS_COUNT; ++i) {
+        const MemSizeClass &sizeClass = s_memView.sizeClasses[i];
+        if (sizeClass.totalCount == 0) {
+            continue;
+        }
+        log_info(MSG_MEMORY, "<= [%zu] Bytes: live [%u] total [%u]\n", (size_t) 1 << i, sizeClass.liveCount, sizeClass.totalCount);
+    }
+#if BEET_MEMORY_TLSF
+    const MemTlsfStats heapStats = mem_heap_stats();
+    log_info(MSG_MEMORY, "===TLSF_HEAP============\n");
+    log_info(MSG_MEMORY, "Committed    : [%zu] Bytes, grown [%u] times\n", heapStats.committedSize, heapStats.growCount);
+    log_info(MSG_MEMORY, "Used         : [%zu] Bytes in [%u] blocks\n", heapStats.usedSize, heapStats.usedBlockCount);
+    log_info(MSG_MEMORY, "Free         : [%zu] Bytes in [%u] blocks\n", heapStats.freeSize, heapStats.freeBlockCount);
+    log_info(MSG_MEMORY, "Largest free : [%zu] Bytes\n", heapStats.largestFreeBlock);
+    log_info(MSG_MEMORY, "Fragmentation: [%.3f]\n", heapStats.fragmentation);
+#endif //BEET_MEMORY_TLSF
     log_info(MSG_MEMORY, "========================\n");
+    mem_dump_tag_stats();
 }
 
 void mem_validate_empty() {
-    size_t inUseMemory = {};
-    for (int i = 0; i < s_memView.infoCount; ++i) {
-        inUseMemory += s_memView.info[i].allocSize;
-    }
-    ASSERT(inUseMemory == 0);
+    ASSERT(s_memView.liveBytes == 0);
     ASSERT(s_memView.totalAllocations == s_memView.totalFrees);
     ASSERT(s_memView.infoCount == 0);
 }
 #endif //BEET_MEMORY_DEBUG
+
+void mem_set_budget(const MSG_CHANNEL tag, const size_t budgetBytes, const MEM_BUDGET_POLICY policy) {
+    MemTagState &state = s_memTags[mem_tag_index(tag)];
+    state.budgetBytes = budgetBytes;
+    state.policy = policy;
+    state.overBudget.store(false, std::memory_order_relaxed);
+}
+
+MemTagStats mem_get_tag_stats(const MSG_CHANNEL tag) {
+    const MemTagState &state = s_memTags[mem_tag_index(tag)];
+    return {
+            .currentBytes = state.currentBytes.load(std::memory_order_relaxed),
+            .highWatermark = state.highWatermark.load(std::memory_order_relaxed),
+            .budgetBytes = state.budgetBytes,
+            .liveAllocations = state.liveAllocations.load(std::memory_order_relaxed),
+            .totalAllocations = state.totalAllocations.load(std::memory_order_relaxed),
+    };
+}
+
+void mem_dump_tag_stats() {
+    log_info(MSG_MEMORY, "===MEM_TAG_DUMP=========\n");
+    for (uint32_t i = 0; i < MEM_TAG_COUNT; ++i) {
+        const MSG_CHANNEL tag = i == MEM_TAG_UNTAGGED_INDEX ? MSG_NONE : (MSG_CHANNEL) (1u << i);
+        const MemTagStats stats = mem_get_tag_stats(tag);
+        if (stats.highWatermark == 0 && stats.budgetBytes == 0) {
+            continue;
+        }
+        log_info(MSG_MEMORY, "%s current [%zu] Bytes, peak [%zu] Bytes, budget [%zu] Bytes, live allocs [%u]\n",
+                 mem_tag_name(i), stats.currentBytes, stats.highWatermark, stats.budgetBytes, stats.liveAllocations);
+    }
+    log_info(MSG_MEMORY, "========================\n");
+}
+
+#if BEET_MEMORY_TLSF
+MemTlsfStats mem_heap_stats() {
+    std::lock_guard<std::mutex> lock(s_tlsfMutex);
+    return mem_tlsf_stats(s_tlsfHeap);
+}
+
+void mem_heap_grow_if_low() {
+    std::lock_guard<std::mutex> lock(s_tlsfMutex);
+    if (s_tlsfHeap.base == nullptr) {
+        return;
+    }
+    mem_tlsf_grow_if_low(s_tlsfHeap, MEM_TLSF_DEFAULT_LOW_WATER_SIZE);
+}
+#endif //BEET_MEMORY_TLSF
+//======================================================================================================================
+
+//===ARENA==============================================================================================================
+static size_t mem_arena_align_up(const size_t value, const size_t alignment) {
+    ASSERT_MSG((alignment & (alignment - 1)) == 0, "Err: arena alignment must be a power of two");
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void *mem_arena_alloc(MemArena &arena, const size_t size, const size_t alignment) {
+    ASSERT_MSG(arena.base != nullptr, "Err: arena has not been created");
+    const size_t start = mem_arena_align_up(arena.offset, alignment);
+    const size_t end = start + size;
+    ASSERT_MSG(end <= arena.reserved, "Err: arena out of reserved memory, requested [%zu] Bytes with [%zu] Bytes reserved\n", end, arena.reserved);
+
+    if (end > arena.committed) {
+        const size_t alignedCommitEnd = mem_arena_align_up(end, MEM_ARENA_COMMIT_SIZE);
+        const size_t commitEnd = alignedCommitEnd < arena.reserved ? alignedCommitEnd : arena.reserved;
+        const bool commitRes = os_virtual_commit(arena.base + arena.committed, commitEnd - arena.committed);
+        ASSERT_MSG(commitRes, "Err: arena failed to commit [%zu] Bytes\n", commitEnd - arena.committed);
+        mem_tag_charge(arena.tag, commitEnd - arena.committed);
+        arena.committed = commitEnd;
+    }
+
+    arena.offset = end;
+    if (end > arena.highWatermark) {
+        arena.highWatermark = end;
+    }
+    return arena.base + start;
+}
+
+void *mem_arena_zalloc(MemArena &arena, const size_t size, const size_t alignment) {
+    return memset(mem_arena_alloc(arena, size, alignment), 0, size);
+}
+
+void mem_arena_reset(MemArena &arena) {
+    // committed pages are kept so steady state frames never touch the OS.
+    arena.offset = 0;
+}
+
+size_t mem_arena_mark(const MemArena &arena) {
+    return arena.offset;
+}
+
+void mem_arena_rewind(MemArena &arena, const size_t mark) {
+    ASSERT_MSG(mark <= arena.offset, "Err: arena rewind mark is ahead of the current offset");
+    arena.offset = mark;
+}
+
+void mem_arena_create(MemArena &arena, const size_t reserveSize, const MSG_CHANNEL tag) {
+    ASSERT_MSG(arena.base == nullptr, "Err: arena has already been created");
+    arena.reserved = mem_arena_align_up(reserveSize, os_page_size());
+    arena.base = (uint8_t *) os_virtual_reserve(arena.reserved);
+    ASSERT_MSG(arena.base, "Err: failed to reserve [%zu] Bytes for arena\n", arena.reserved);
+    arena.committed = 0;
+    arena.offset = 0;
+    arena.highWatermark = 0;
+    arena.tag = tag;
+}
+
+void mem_arena_cleanup(MemArena &arena) {
+    ASSERT_MSG(arena.base != nullptr, "Err: arena has already been destroyed");
+    os_virtual_release(arena.base, arena.reserved);
+    mem_tag_release(arena.tag, arena.committed);
+    arena = {};
+}
+//======================================================================================================================
+
+//===POOL===============================================================================================================
+uint32_t mem_pool_alloc_index(MemPool &pool) {
+    ASSERT_MSG(pool.start != nullptr, "Err: pool has not been created");
+    uint32_t index = MEM_POOL_INVALID_INDEX;
+    if (pool.freeHead != MEM_POOL_INVALID_INDEX) {
+        index = pool.freeHead;
+        memcpy(&pool.freeHead, pool.start + (index * pool.blockSize), sizeof(uint32_t));
+    } else {
+        ASSERT_MSG(pool.highWatermark < pool.capacity, "Err: pool exceeded capacity of [%u] blocks\n", pool.capacity);
+        index = pool.highWatermark;
+        pool.highWatermark++;
+    }
+    pool.aliveFlags[index] = 1;
+    pool.usedCount++;
+    return index;
+}
+
+void mem_pool_free_index(MemPool &pool, const uint32_t index) {
+    ASSERT_MSG(mem_pool_is_alive(pool, index), "Err: freeing pool block [%u] that is not allocated\n", index);
+    memcpy(pool.start + (index * pool.blockSize), &pool.freeHead, sizeof(uint32_t));
+    pool.freeHead = index;
+    pool.aliveFlags[index] = 0;
+    pool.usedCount--;
+}
+
+void *mem_pool_get(const MemPool &pool, const uint32_t index) {
+    ASSERT(index < pool.capacity);
+    return pool.start + (index * pool.blockSize);
+}
+
+bool mem_pool_is_alive(const MemPool &pool, const uint32_t index) {
+    return index < pool.highWatermark && pool.aliveFlags[index] != 0;
+}
+
+void mem_pool_create(MemPool &pool, const size_t blockSize, const uint32_t capacity, const MSG_CHANNEL tag) {
+    ASSERT_MSG(pool.start == nullptr, "Err: pool has already been created");
+    ASSERT_MSG(blockSize >= sizeof(uint32_t), "Err: pool block size must be large enough to hold a free list index");
+    pool.start = (uint8_t *) mem_zalloc(blockSize * capacity, tag);
+    pool.aliveFlags = (uint8_t *) mem_zalloc(capacity, tag);
+    pool.blockSize = blockSize;
+    pool.capacity = capacity;
+    pool.freeHead = MEM_POOL_INVALID_INDEX;
+    pool.usedCount = 0;
+    pool.highWatermark = 0;
+}
+
+void mem_pool_cleanup(MemPool &pool) {
+    ASSERT_MSG(pool.start != nullptr, "Err: pool has already been destroyed");
+    mem_free(pool.start);
+    mem_free(pool.aliveFlags);
+    pool = {};
+}
 //======================================================================================================================
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include <beet_shared/memory.h>
+#include <beet_shared/assert.h>
+#include <beet_shared/os_memory.h>
+
+#include <bit>
+
+//===INTERNAL_STRUCTS===================================================================================================
+// Physical layout of the heap is [block][block]...[sentinel], each header is followed by its payload.
+// prevPhys is only valid while the previous block is free, nextFree / prevFree overlap the payload of free blocks.
+struct MemTlsfBlock {
+    MemTlsfBlock *prevPhys;
+    size_t sizeAndFlags;
+    MemTlsfBlock *nextFree;
+    MemTlsfBlock *prevFree;
+};
+
+constexpr size_t TLSF_BLOCK_FREE_BIT = 1 << 0;
+constexpr size_t TLSF_PREV_FREE_BIT = 1 << 1;
+constexpr size_t TLSF_FLAG_MASK = TLSF_BLOCK_FREE_BIT | TLSF_PREV_FREE_BIT;
+
+constexpr size_t TLSF_HEADER_SIZE = offsetof(MemTlsfBlock, nextFree);
+constexpr size_t TLSF_MIN_BLOCK_SIZE = sizeof(MemTlsfBlock) - TLSF_HEADER_SIZE;
+
+constexpr uint32_t TLSF_ALIGNMENT_LOG2 = 4;
+constexpr uint32_t TLSF_FL_SHIFT = MEM_TLSF_SL_COUNT_LOG2 + TLSF_ALIGNMENT_LOG2;
+constexpr size_t TLSF_SMALL_BLOCK_SIZE = (size_t) 1 << TLSF_FL_SHIFT;
+constexpr size_t TLSF_MAX_BLOCK_SIZE = (size_t) 1 << (MEM_TLSF_FL_COUNT + TLSF_FL_SHIFT - 1);
+
+static_assert(MEM_TLSF_ALIGNMENT == ((size_t) 1 << TLSF_ALIGNMENT_LOG2));
+static_assert(TLSF_HEADER_SIZE % MEM_TLSF_ALIGNMENT == 0);
+static_assert(MEM_TLSF_COMMIT_SIZE % MEM_TLSF_ALIGNMENT == 0);
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static size_t tlsf_align_up(const size_t value, const size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint32_t tlsf_fls(const size_t value) {
+    return 63 - std::countl_zero((uint64_t) value);
+}
+
+static uint32_t tlsf_ffs(const uint32_t value) {
+    return std::countr_zero(value);
+}
+
+static size_t tlsf_block_size(const MemTlsfBlock *block) {
+    return block->sizeAndFlags & ~TLSF_FLAG_MASK;
+}
+
+static void tlsf_block_set_size(MemTlsfBlock *block, const size_t size) {
+    block->sizeAndFlags = size | (block->sizeAndFlags & TLSF_FLAG_MASK);
+}
+
+static bool tlsf_block_is_free(const MemTlsfBlock *block) {
+    return (block->sizeAndFlags & TLSF_BLOCK_FREE_BIT) != 0;
+}
+
+static bool tlsf_block_is_prev_free(const MemTlsfBlock *block) {
+    return (block->sizeAndFlags & TLSF_PREV_FREE_BIT) != 0;
+}
+
+static void tlsf_block_set_flag(MemTlsfBlock *block, const size_t flag, const bool enabled) {
+    block->sizeAndFlags = enabled ? (block->sizeAndFlags | flag) : (block->sizeAndFlags & ~flag);
+}
+
+static void *tlsf_block_payload(MemTlsfBlock *block) {
+    return (uint8_t *) block + TLSF_HEADER_SIZE;
+}
+
+static MemTlsfBlock *tlsf_block_from_payload(void *payload) {
+    return (MemTlsfBlock *) ((uint8_t *) payload - TLSF_HEADER_SIZE);
+}
+
+static MemTlsfBlock *tlsf_block_next_phys(MemTlsfBlock *block) {
+    return (MemTlsfBlock *) ((uint8_t *) tlsf_block_payload(block) + tlsf_block_size(block));
+}
+
+static void tlsf_mapping_insert(const size_t size, uint32_t &outFl, uint32_t &outSl) {
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        outFl = 0;
+        outSl = (uint32_t) (size / (TLSF_SMALL_BLOCK_SIZE / MEM_TLSF_SL_COUNT));
+    } else {
+        const uint32_t fl = tlsf_fls(size);
+        outSl = (uint32_t) (size >> (fl - MEM_TLSF_SL_COUNT_LOG2)) ^ MEM_TLSF_SL_COUNT;
+        outFl = fl - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// rounds the request up to the next list boundary so any block found in the resulting list is large enough.
+static size_t tlsf_mapping_search_size(const size_t size) {
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        return size;
+    }
+    const size_t round = ((size_t) 1 << (tlsf_fls(size) - MEM_TLSF_SL_COUNT_LOG2)) - 1;
+    return (size + round) & ~round;
+}
+
+static MemTlsfBlock *tlsf_find_suitable_block(MemTlsf &tlsf, uint32_t fl, uint32_t sl) {
+    uint32_t slMap = tlsf.slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+        const uint32_t flMap = tlsf.flBitmap & (~0u << (fl + 1));
+        if (flMap == 0) {
+            return nullptr;
+        }
+        fl = tlsf_ffs(flMap);
+        slMap = tlsf.slBitmap[fl];
+    }
+    sl = tlsf_ffs(slMap);
+    return tlsf.freeLists[fl][sl];
+}
+
+static void tlsf_remove_free_block(MemTlsf &tlsf, MemTlsfBlock *block) {
+    uint32_t fl, sl;
+    tlsf_mapping_insert(tlsf_block_size(block), fl, sl);
+
+    MemTlsfBlock *prev = block->prevFree;
+    MemTlsfBlock *next = block->nextFree;
+    if (next) {
+        next->prevFree = prev;
+    }
+    if (prev) {
+        prev->nextFree = next;
+    }
+    if (tlsf.freeLists[fl][sl] == block) {
+        tlsf.freeLists[fl][sl] = next;
+        if (next == nullptr) {
+            tlsf.slBitmap[fl] &= ~(1u << sl);
+            if (tlsf.slBitmap[fl] == 0) {
+                tlsf.flBitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+static void tlsf_insert_free_block(MemTlsf &tlsf, MemTlsfBlock *block) {
+    uint32_t fl, sl;
+    tlsf_mapping_insert(tlsf_block_size(block), fl, sl);
+
+    MemTlsfBlock *head = tlsf.freeLists[fl][sl];
+    block->nextFree = head;
+    block->prevFree = nullptr;
+    if (head) {
+        head->prevFree = block;
+    }
+    tlsf.freeLists[fl][sl] = block;
+    tlsf.flBitmap |= (1u << fl);
+    tlsf.slBitmap[fl] |= (1u << sl);
+}
+
+// touches one byte per page so the kernel backs the range now instead of on the first allocation that lands in it.
+static void tlsf_prefault(uint8_t *address, const size_t size) {
+    const size_t pageSize = os_page_size();
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t *) address)[offset] = 0;
+    }
+}
+
+// turns the old sentinel into a new free block spanning the freshly committed pages.
+static bool tlsf_commit_more(MemTlsf &tlsf, const size_t size) {
+    const size_t growSize = tlsf_align_up(size + TLSF_HEADER_SIZE, MEM_TLSF_COMMIT_SIZE);
+    if (tlsf.committed + growSize > tlsf.reserved) {
+        return false;
+    }
+    if (!os_virtual_commit(tlsf.base + tlsf.committed, growSize)) {
+        return false;
+    }
+    tlsf_prefault(tlsf.base + tlsf.committed, growSize);
+
+    MemTlsfBlock *block = (MemTlsfBlock *) (tlsf.base + tlsf.committed - TLSF_HEADER_SIZE);
+    tlsf.committed += growSize;
+    tlsf.growCount++;
+
+    block->sizeAndFlags = (growSize - TLSF_HEADER_SIZE) | TLSF_BLOCK_FREE_BIT | (block->sizeAndFlags & TLSF_PREV_FREE_BIT);
+    if (tlsf_block_is_prev_free(block)) {
+        MemTlsfBlock *prev = block->prevPhys;
+        tlsf_remove_free_block(tlsf, prev);
+        tlsf_block_set_size(prev, tlsf_block_size(prev) + TLSF_HEADER_SIZE + tlsf_block_size(block));
+        block = prev;
+    }
+
+    MemTlsfBlock *sentinel = tlsf_block_next_phys(block);
+    sentinel->prevPhys = block;
+    sentinel->sizeAndFlags = TLSF_PREV_FREE_BIT;
+    tlsf_insert_free_block(tlsf, block);
+    return true;
+}
+
+static bool tlsf_has_free_block(MemTlsf &tlsf, const size_t size) {
+    const size_t searchSize = tlsf_mapping_search_size(tlsf_align_up(size, MEM_TLSF_ALIGNMENT));
+    if (searchSize >= TLSF_MAX_BLOCK_SIZE) {
+        return false;
+    }
+    uint32_t fl, sl;
+    tlsf_mapping_insert(searchSize, fl, sl);
+    return tlsf_find_suitable_block(tlsf, fl, sl) != nullptr;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void *mem_tlsf_alloc(MemTlsf &tlsf, const size_t size) {
+    ASSERT_MSG(tlsf.base != nullptr, "Err: tlsf heap has not been created");
+    const size_t alignedSize = tlsf_align_up(size < TLSF_MIN_BLOCK_SIZE ? TLSF_MIN_BLOCK_SIZE : size, MEM_TLSF_ALIGNMENT);
+
+    const size_t searchSize = tlsf_mapping_search_size(alignedSize);
+    if (searchSize >= TLSF_MAX_BLOCK_SIZE) {
+        return nullptr;
+    }
+    uint32_t fl, sl;
+    tlsf_mapping_insert(searchSize, fl, sl);
+    MemTlsfBlock *block = tlsf_find_suitable_block(tlsf, fl, sl);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    tlsf_remove_free_block(tlsf, block);
+
+    const size_t blockSize = tlsf_block_size(block);
+    if (blockSize >= alignedSize + TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE) {
+        MemTlsfBlock *remainder = (MemTlsfBlock *) ((uint8_t *) tlsf_block_payload(block) + alignedSize);
+        remainder->sizeAndFlags = (blockSize - alignedSize - TLSF_HEADER_SIZE) | TLSF_BLOCK_FREE_BIT;
+        remainder->prevPhys = block;
+        tlsf_block_next_phys(remainder)->prevPhys = remainder;
+        tlsf_block_set_size(block, alignedSize);
+        tlsf_insert_free_block(tlsf, remainder);
+    } else {
+        tlsf_block_set_flag(tlsf_block_next_phys(block), TLSF_PREV_FREE_BIT, false);
+    }
+    tlsf_block_set_flag(block, TLSF_BLOCK_FREE_BIT, false);
+    return tlsf_block_payload(block);
+}
+
+void mem_tlsf_free(MemTlsf &tlsf, void *block) {
+    ASSERT_MSG(block != nullptr, "Err: trying to invalidate nullptr");
+    MemTlsfBlock *current = tlsf_block_from_payload(block);
+    ASSERT_MSG(!tlsf_block_is_free(current), "Err: tlsf block [%p] has already been freed\n", block);
+    tlsf_block_set_flag(current, TLSF_BLOCK_FREE_BIT, true);
+
+    if (tlsf_block_is_prev_free(current)) {
+        MemTlsfBlock *prev = current->prevPhys;
+        tlsf_remove_free_block(tlsf, prev);
+        tlsf_block_set_size(prev, tlsf_block_size(prev) + TLSF_HEADER_SIZE + tlsf_block_size(current));
+        current = prev;
+    }
+    MemTlsfBlock *next = tlsf_block_next_phys(current);
+    if (tlsf_block_is_free(next)) {
+        tlsf_remove_free_block(tlsf, next);
+        tlsf_block_set_size(current, tlsf_block_size(current) + TLSF_HEADER_SIZE + tlsf_block_size(next));
+        next = tlsf_block_next_phys(current);
+    }
+    next->prevPhys = current;
+    tlsf_block_set_flag(next, TLSF_PREV_FREE_BIT, true);
+    tlsf_insert_free_block(tlsf, current);
+}
+
+bool mem_tlsf_grow(MemTlsf &tlsf, const size_t size) {
+    ASSERT_MSG(tlsf.base != nullptr, "Err: tlsf heap has not been created");
+    return tlsf_commit_more(tlsf, tlsf_mapping_search_size(tlsf_align_up(size, MEM_TLSF_ALIGNMENT)));
+}
+
+bool mem_tlsf_grow_if_low(MemTlsf &tlsf, const size_t lowWaterSize) {
+    ASSERT_MSG(tlsf.base != nullptr, "Err: tlsf heap has not been created");
+    if (tlsf_has_free_block(tlsf, lowWaterSize)) {
+        return true;
+    }
+    return mem_tlsf_grow(tlsf, lowWaterSize);
+}
+
+MemTlsfStats mem_tlsf_stats(const MemTlsf &tlsf) {
+    MemTlsfStats stats = {};
+    stats.committedSize = tlsf.committed;
+    stats.growCount = tlsf.growCount;
+    if (tlsf.base == nullptr) {
+        return stats;
+    }
+    // the sentinel is the only block with a size of zero.
+    for (MemTlsfBlock *block = (MemTlsfBlock *) tlsf.base; tlsf_block_size(block) != 0; block = tlsf_block_next_phys(block)) {
+        const size_t blockSize = tlsf_block_size(block);
+        if (tlsf_block_is_free(block)) {
+            stats.freeSize += blockSize;
+            stats.freeBlockCount++;
+            stats.largestFreeBlock = blockSize > stats.largestFreeBlock ? blockSize : stats.largestFreeBlock;
+        } else {
+            stats.usedSize += blockSize;
+            stats.usedBlockCount++;
+        }
+    }
+    stats.fragmentation = stats.freeSize > 0 ? 1.0f - ((float) stats.largestFreeBlock / (float) stats.freeSize) : 0.0f;
+    return stats;
+}
+
+void mem_tlsf_create(MemTlsf &tlsf, const size_t reserveSize, const size_t initialCommitSize) {
+    ASSERT_MSG(tlsf.base == nullptr, "Err: tlsf heap has already been created");
+    ASSERT_MSG(initialCommitSize >= MEM_TLSF_COMMIT_SIZE, "Err: tlsf heap must commit at least [%zu] Bytes\n", MEM_TLSF_COMMIT_SIZE);
+    ASSERT_MSG(reserveSize >= initialCommitSize, "Err: tlsf heap can not commit [%zu] Bytes of a [%zu] Bytes reservation\n", initialCommitSize, reserveSize);
+    tlsf = {};
+    tlsf.reserved = tlsf_align_up(reserveSize, MEM_TLSF_COMMIT_SIZE);
+    ASSERT_MSG(tlsf.reserved <= TLSF_MAX_BLOCK_SIZE, "Err: tlsf heap can not reserve more than [%zu] Bytes\n", TLSF_MAX_BLOCK_SIZE);
+    tlsf.base = (uint8_t *) os_virtual_reserve(tlsf.reserved);
+    ASSERT_MSG(tlsf.base != nullptr, "Err: tlsf heap failed to reserve [%zu] Bytes\n", tlsf.reserved);
+    const size_t commitSize = tlsf_align_up(initialCommitSize, MEM_TLSF_COMMIT_SIZE);
+    const bool commitRes = os_virtual_commit(tlsf.base, commitSize);
+    ASSERT_MSG(commitRes, "Err: tlsf heap failed to commit [%zu] Bytes\n", commitSize);
+    tlsf_prefault(tlsf.base, commitSize);
+    tlsf.committed = commitSize;
+
+    MemTlsfBlock *block = (MemTlsfBlock *) tlsf.base;
+    block->prevPhys = nullptr;
+    block->sizeAndFlags = (commitSize - (TLSF_HEADER_SIZE * 2)) | TLSF_BLOCK_FREE_BIT;
+    MemTlsfBlock *sentinel = tlsf_block_next_phys(block);
+    sentinel->prevPhys = block;
+    sentinel->sizeAndFlags = TLSF_PREV_FREE_BIT;
+    tlsf_insert_free_block(tlsf, block);
+}
+
+void mem_tlsf_cleanup(MemTlsf &tlsf) {
+    ASSERT_MSG(tlsf.base != nullptr, "Err: tlsf heap has already been destroyed");
+    os_virtual_release(tlsf.base, tlsf.reserved);
+    tlsf = {};
+}
+//======================================================================================================================
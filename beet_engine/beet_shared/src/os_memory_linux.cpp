@@ -0,0 +1,72 @@
+#include <beet_shared/os_memory.h>
+#include <beet_shared/platform_defines.h>
+
+#if PLATFORM_LINUX
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+
+//===API================================================================================================================
+size_t os_page_size() {
+    return (size_t) sysconf(_SC_PAGESIZE);
+}
+
+void *os_virtual_reserve(const size_t size) {
+    void *address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return address == MAP_FAILED ? nullptr : address;
+}
+
+bool os_virtual_commit(void *address, const size_t size) {
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void os_virtual_decommit(void *address, const size_t size) {
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+void os_virtual_release(void *address, const size_t size) {
+    munmap(address, size);
+}
+
+void *os_aligned_alloc(const size_t size, const size_t alignment) {
+    void *out = nullptr;
+    return posix_memalign(&out, alignment, size) == 0 ? out : nullptr;
+}
+
+void os_aligned_free(void *block) {
+    free(block);
+}
+
+const void *os_file_map_readonly(const char *path, size_t &outSize) {
+    outSize = 0;
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    void *address = mmap(nullptr, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds its own reference to the file.
+    close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+    // textures are consumed front to back once, let the kernel read ahead aggressively.
+    madvise(address, (size_t) fileStat.st_size, MADV_SEQUENTIAL);
+    outSize = (size_t) fileStat.st_size;
+    return address;
+}
+
+void os_file_unmap(const void *address, const size_t size) {
+    munmap(const_cast<void *>(address), size);
+}
+//======================================================================================================================
+
+#endif
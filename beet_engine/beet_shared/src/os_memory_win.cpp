@@ -0,0 +1,71 @@
+#include <beet_shared/os_memory.h>
+#include <beet_shared/platform_defines.h>
+
+#if PLATFORM_WINDOWS
+
+#include <windows.h>
+#include <malloc.h>
+
+//===API================================================================================================================
+size_t os_page_size() {
+    SYSTEM_INFO systemInfo = {};
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+}
+
+void *os_virtual_reserve(const size_t size) {
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool os_virtual_commit(void *address, const size_t size) {
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void os_virtual_decommit(void *address, const size_t size) {
+    VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+void os_virtual_release(void *address, const size_t size) {
+    VirtualFree(address, 0, MEM_RELEASE);
+}
+
+void *os_aligned_alloc(const size_t size, const size_t alignment) {
+    return _aligned_malloc(size, alignment);
+}
+
+void os_aligned_free(void *block) {
+    _aligned_free(block);
+}
+
+const void *os_file_map_readonly(const char *path, size_t &outSize) {
+    outSize = 0;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    // the view keeps the mapping object alive until it is unmapped.
+    const void *address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (address == nullptr) {
+        return nullptr;
+    }
+    outSize = (size_t) fileSize.QuadPart;
+    return address;
+}
+
+void os_file_unmap(const void *address, const size_t size) {
+    UnmapViewOfFile(address);
+}
+//======================================================================================================================
+
+#endif
@@ -5,7 +5,7 @@
 
 //===API================================================================================================================
 void os_localtime(struct tm &buf, time_t &time) {
-    localtime_r(&t, &buf);
+    localtime_r(&time, &buf);
 }
 //======================================================================================================================
 
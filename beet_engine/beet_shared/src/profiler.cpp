@@ -0,0 +1,145 @@
+#include <beet_shared/profiler.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//===INTERNAL_STRUCTS===================================================================================================
+static_assert((PROFILER_ZONE_RING_CAPACITY & (PROFILER_ZONE_RING_CAPACITY - 1)) == 0, "ring capacity must be a power of two");
+
+struct ProfilerRing {
+    std::atomic<uint32_t> head;
+    std::atomic<bool> owned; // cleared when the owning thread exits, the next new thread takes the ring over
+    uint32_t threadIndex;
+    char threadName[PROFILER_THREAD_NAME_SIZE];
+    ProfilerZone zones[PROFILER_ZONE_RING_CAPACITY];
+};
+
+static struct ProfilerState {
+    const int64_t startNs = {profiler_now_ns()};
+    std::atomic<ProfilerRing *> rings[PROFILER_MAX_THREADS] = {};
+    std::atomic<uint32_t> ringCount = {0};
+    std::atomic<uint32_t> generation = {0};
+} s_profilerState;
+
+// releases the ring when the thread exits so threads created and destroyed by a job system don't exhaust the table.
+struct ProfilerThreadRing {
+    ProfilerRing *ring = {nullptr};
+    uint32_t generation = {0};
+    ~ProfilerThreadRing();
+};
+
+static thread_local ProfilerThreadRing t_profilerRing = {};
+
+ProfilerThreadRing::~ProfilerThreadRing() {
+    // rings from before a profiler_cleanup have already been freed.
+    if (ring != nullptr && generation == s_profilerState.generation.load(std::memory_order_acquire)) {
+        ring->owned.store(false, std::memory_order_release);
+    }
+}
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+// ring storage comes from calloc, routing it through mem_* would show up as a profiler allocation in every tag dump.
+static ProfilerRing *profiler_acquire_thread_ring() {
+    const uint32_t generation = s_profilerState.generation.load(std::memory_order_acquire);
+    if (t_profilerRing.ring != nullptr && t_profilerRing.generation == generation) {
+        return t_profilerRing.ring;
+    }
+
+    // a ring left behind by an exited thread keeps its zones and its tid, the new owner continues the same track.
+    const uint32_t ringCount = s_profilerState.ringCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < ringCount && i < PROFILER_MAX_THREADS; ++i) {
+        ProfilerRing *ring = s_profilerState.rings[i].load(std::memory_order_acquire);
+        bool expected = false;
+        if (ring && ring->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            snprintf(ring->threadName, PROFILER_THREAD_NAME_SIZE, "thread %u", ring->threadIndex);
+            t_profilerRing.ring = ring;
+            t_profilerRing.generation = generation;
+            return ring;
+        }
+    }
+
+    const uint32_t ringIndex = s_profilerState.ringCount.fetch_add(1, std::memory_order_acq_rel);
+    if (ringIndex >= PROFILER_MAX_THREADS) {
+        s_profilerState.ringCount.fetch_sub(1, std::memory_order_acq_rel);
+        return nullptr;
+    }
+    ProfilerRing *ring = (ProfilerRing *) calloc(1, sizeof(ProfilerRing));
+    ring->owned.store(true, std::memory_order_relaxed);
+    ring->threadIndex = ringIndex;
+    snprintf(ring->threadName, PROFILER_THREAD_NAME_SIZE, "thread %u", ringIndex);
+    s_profilerState.rings[ringIndex].store(ring, std::memory_order_release);
+    t_profilerRing.ring = ring;
+    t_profilerRing.generation = generation;
+    return ring;
+}
+
+static double profiler_ns_to_trace_us(const int64_t ns) {
+    return (double) (ns - s_profilerState.startNs) / 1000.0;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+void profiler_submit_zone(const char *name, const int64_t beginNs, const int64_t endNs) {
+    ProfilerRing *ring = t_profilerRing.ring;
+    if (ring == nullptr || t_profilerRing.generation != s_profilerState.generation.load(std::memory_order_relaxed)) {
+        ring = profiler_acquire_thread_ring();
+        if (ring == nullptr) {
+            return;
+        }
+    }
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    ring->zones[head & (PROFILER_ZONE_RING_CAPACITY - 1)] = {name, beginNs, endNs};
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void profiler_set_thread_name(const char *name) {
+    ProfilerRing *ring = profiler_acquire_thread_ring();
+    if (ring) {
+        snprintf(ring->threadName, PROFILER_THREAD_NAME_SIZE, "%s", name);
+    }
+}
+
+bool profiler_export_chrome_trace(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool firstEvent = true;
+    const uint32_t ringCount = s_profilerState.ringCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < ringCount && i < PROFILER_MAX_THREADS; ++i) {
+        const ProfilerRing *ring = s_profilerState.rings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                firstEvent ? "" : ",\n", ring->threadIndex, ring->threadName);
+        firstEvent = false;
+
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        const uint32_t first = head > PROFILER_ZONE_RING_CAPACITY ? head - PROFILER_ZONE_RING_CAPACITY : 0;
+        for (uint32_t z = first; z != head; ++z) {
+            const ProfilerZone &zone = ring->zones[z & (PROFILER_ZONE_RING_CAPACITY - 1)];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    zone.name,
+                    ring->threadIndex,
+                    profiler_ns_to_trace_us(zone.beginNs),
+                    (double) (zone.endNs - zone.beginNs) / 1000.0);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+void profiler_cleanup() {
+    s_profilerState.generation.fetch_add(1, std::memory_order_acq_rel);
+    const uint32_t ringCount = s_profilerState.ringCount.exchange(0, std::memory_order_acq_rel);
+    for (uint32_t i = 0; i < ringCount && i < PROFILER_MAX_THREADS; ++i) {
+        free(s_profilerState.rings[i].exchange(nullptr, std::memory_order_acq_rel));
+    }
+}
+//======================================================================================================================
@@ -0,0 +1,63 @@
+#include <beet_shared/radix_sort.h>
+
+#include <cstring>
+
+//===INTERNAL_STRUCTS===================================================================================================
+constexpr uint32_t RADIX_SORT_BITS = 8;
+constexpr uint32_t RADIX_SORT_BUCKETS = 1 << RADIX_SORT_BITS;
+constexpr uint32_t RADIX_SORT_PASSES = sizeof(uint64_t) * 8 / RADIX_SORT_BITS;
+//======================================================================================================================
+
+//===API================================================================================================================
+void radix_sort_u64(uint64_t *keys, uint32_t *values, uint64_t *scratchKeys, uint32_t *scratchValues, const uint32_t count) {
+    if (count < 2) {
+        return;
+    }
+
+    // every pass' histogram is built up front, one read of the keys instead of one per pass.
+    uint32_t histograms[RADIX_SORT_PASSES][RADIX_SORT_BUCKETS] = {};
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint64_t key = keys[i];
+        for (uint32_t pass = 0; pass < RADIX_SORT_PASSES; ++pass) {
+            histograms[pass][(key >> (pass * RADIX_SORT_BITS)) & (RADIX_SORT_BUCKETS - 1)]++;
+        }
+    }
+
+    uint64_t *srcKeys = keys;
+    uint32_t *srcValues = values;
+    uint64_t *dstKeys = scratchKeys;
+    uint32_t *dstValues = scratchValues;
+    for (uint32_t pass = 0; pass < RADIX_SORT_PASSES; ++pass) {
+        uint32_t *histogram = histograms[pass];
+        const uint32_t shift = pass * RADIX_SORT_BITS;
+        if (histogram[(srcKeys[0] >> shift) & (RADIX_SORT_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        // histogram becomes the first output slot of each bucket
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < RADIX_SORT_BUCKETS; ++bucket) {
+            const uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t slot = histogram[(srcKeys[i] >> shift) & (RADIX_SORT_BUCKETS - 1)]++;
+            dstKeys[slot] = srcKeys[i];
+            dstValues[slot] = srcValues[i];
+        }
+
+        uint64_t *swapKeys = srcKeys;
+        uint32_t *swapValues = srcValues;
+        srcKeys = dstKeys;
+        srcValues = dstValues;
+        dstKeys = swapKeys;
+        dstValues = swapValues;
+    }
+
+    if (srcKeys != keys) {
+        memcpy(keys, srcKeys, sizeof(uint64_t) * count);
+        memcpy(values, srcValues, sizeof(uint32_t) * count);
+    }
+}
+//======================================================================================================================
@@ -55,6 +55,9 @@ void convert_required_shaders() {
 
     ASSERT(convert_shader_spv("assets/shaders/triangle_strip/triangle_strip.frag"));
     ASSERT(convert_shader_spv("assets/shaders/triangle_strip/triangle_strip.vert"));
+
+    ASSERT(convert_shader_spv("assets/shaders/cull/cull_instances.comp"));
+    ASSERT(convert_shader_spv("assets/shaders/cull/cull_commands.comp"));
 }
 
 void convert_required_textures() {
@@ -64,14 +67,19 @@ void convert_required_textures() {
 }
 
 int main(int argc, char **argv) {
+    log_configure_from_env();
+    log_configure_from_args(argc, argv);
+    log_create({});
     commandline_init(argc, argv);
     if (commandline_get_arg(CLArgs::help).enabled) {
         commandline_show_commands();
+        log_cleanup();
         return 0;
     }
     converter_init(BEET_CMAKE_PIPELINE_ASSETS_DIR, BEET_CMAKE_RUNTIME_ASSETS_DIR);
     converter_option_set_ignore_cache(commandline_get_arg(CLArgs::ignoreConvertCache).enabled);
 
-//    convert_required_shaders();
+    convert_required_shaders();
     convert_required_textures();
+    log_cleanup();
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef BEETROOT_BENCHMARK_H
+#define BEETROOT_BENCHMARK_H
+
+#include <beet_math/vec2.h>
+
+#include <cstdint>
+
+//===PUBLIC_STRUCTS=====================================================================================================
+struct BenchmarkConfig {
+    bool enabled = {false};
+    uint32_t frameCount = {1000};
+    double durationSeconds = {0.0}; // when set, runs for this long instead of frameCount frames
+    uint32_t warmupFrames = {16};
+    vec2i resolution = {1280, 720};
+    const char *outputPath = {"benchmark_results.json"};
+    const char *tracePath = {nullptr}; // when set, the profiler zones of the run are written here as a Chrome trace
+    bool validateCulling = {false}; // checks every gpu culling pass against the cpu reference, mismatches fail the run
+    bool cpuCulling = {true}; // off measures the gpu culling pass on its own
+    bool directInstancing = {false}; // one vkCmdDrawIndexed per batch instead of gpu culled indirect draws
+};
+//======================================================================================================================
+
+//===API================================================================================================================
+// --benchmark [--benchmark-frames=N | --benchmark-seconds=S] [--benchmark-resolution=WxH] [--benchmark-output=path]
+//             [--benchmark-validate-culling] [--benchmark-no-cpu-culling]
+//             [--benchmark-direct-instancing] [--benchmark-trace=path | --benchmark-trace path]
+// the trace only holds zones when built with BEET_PROFILE, see beet_shared/profiler.h.
+BenchmarkConfig benchmark_parse_args(int32_t argc, char **argv);
+
+// renders headless over a scripted camera path and writes the json report, owns the whole engine lifetime.
+// returns the process exit code.
+int32_t benchmark_run(const BenchmarkConfig &config);
+//======================================================================================================================
+
+#endif //BEETROOT_BENCHMARK_H
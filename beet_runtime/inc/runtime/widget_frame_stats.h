@@ -0,0 +1,8 @@
+#ifndef BEETROOT_WIDGET_FRAME_STATS_H
+#define BEETROOT_WIDGET_FRAME_STATS_H
+
+//===API================================================================================================================
+void widget_frame_stats_update(bool &enabled);
+//======================================================================================================================
+
+#endif //BEETROOT_WIDGET_FRAME_STATS_H
@@ -0,0 +1,8 @@
+#ifndef BEETROOT_WIDGET_GPU_TIMINGS_H
+#define BEETROOT_WIDGET_GPU_TIMINGS_H
+
+//===API================================================================================================================
+void widget_gpu_timings_update(bool &enabled);
+//======================================================================================================================
+
+#endif //BEETROOT_WIDGET_GPU_TIMINGS_H
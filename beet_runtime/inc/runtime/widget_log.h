@@ -0,0 +1,8 @@
+#ifndef BEETROOT_WIDGET_LOG_H
+#define BEETROOT_WIDGET_LOG_H
+
+//===API================================================================================================================
+void widget_log_update(bool &enabled);
+//======================================================================================================================
+
+#endif //BEETROOT_WIDGET_LOG_H
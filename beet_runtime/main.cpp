@@ -4,6 +4,7 @@
 
 #include <beet_shared/log.h>
 #include <beet_shared/memory.h>
+#include <beet_shared/profiler.h>
 
 #include <beet_gfx/gfx_interface.h>
 #include <beet_gfx/gfx_imgui.h>
@@ -11,6 +12,7 @@
 
 #include <runtime/entity_builder.h>
 #include <runtime/script_camera.h>
+#include <runtime/benchmark.h>
 
 #if BEET_GFX_IMGUI
 
@@ -20,6 +22,7 @@
 
 #if BEET_GFX_IMGUI
 void imgui_update() {
+    BEET_PROFILE_SCOPE("imgui_update");
     gfx_imgui_begin();
     {
         widget_manager_update();
@@ -27,7 +30,24 @@ void imgui_update() {
 }
 #endif //BEET_GFX_IMGUI
 
-int main() {
+int main(int argc, char **argv) {
+    log_configure_from_env();
+    log_configure_from_args(argc, argv);
+    log_create({});
+    profiler_set_thread_name("main");
+
+    const BenchmarkConfig benchmarkConfig = benchmark_parse_args(argc, argv);
+    if (benchmarkConfig.enabled) {
+        const int32_t exitCode = benchmark_run(benchmarkConfig);
+#if BEET_MEMORY_DEBUG
+        mem_dump_memory_info();
+        mem_validate_empty();
+#endif //BEET_MEMORY_DEBUG
+        profiler_cleanup();
+        log_cleanup();
+        return exitCode;
+    }
+
     window_create("beetroot engine - runtime", {1024, 768});
 #if BEET_GFX_IMGUI
     window_set_procedure_callback_func(gfx_imgui_get_win32_proc_function_pointer());
@@ -38,15 +58,28 @@ int main() {
     entities_create();
     log_info(MSG_RUNTIME, "hello beetroot engine\n");
     while (window_is_open()) {
+        BEET_PROFILE_SCOPE("frame");
         time_tick();
         input_set_time(time_current());
-        window_update();
-        input_update();
-        script_update_camera();
+        {
+            BEET_PROFILE_SCOPE("window_update");
+            window_update();
+        }
+        {
+            BEET_PROFILE_SCOPE("input_update");
+            input_update();
+        }
+        {
+            BEET_PROFILE_SCOPE("script_update_camera");
+            script_update_camera();
+        }
 #if BEET_GFX_IMGUI
         imgui_update();
 #endif //BEET_GFX_IMGUI
         gfx_update(time_delta());
+#if BEET_MEMORY_TLSF
+        mem_heap_grow_if_low();
+#endif //BEET_MEMORY_TLSF
     }
     entities_cleanup();
     gfx_cleanup();
@@ -58,4 +91,6 @@ int main() {
     mem_dump_memory_info();
     mem_validate_empty();
 #endif //BEET_MEMORY_DEBUG
+    profiler_cleanup();
+    log_cleanup();
 }
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include <runtime/benchmark.h>
+#include <runtime/entity_builder.h>
+
+#include <beet_core/time.h>
+
+#include <beet_shared/log.h>
+#include <beet_shared/memory.h>
+#include <beet_shared/profiler.h>
+
+#include <beet_gfx/gfx_interface.h>
+#include <beet_gfx/gfx_timestamps.h>
+#include <beet_gfx/gfx_memory.h>
+#include <beet_gfx/gfx_indexed_indirect.h>
+#include <beet_gfx/db_asset.h>
+
+#include <beet_math/vec3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//===INTERNAL_STRUCTS===================================================================================================
+constexpr float BENCHMARK_ORBIT_RADIUS = 12.0f;
+constexpr float BENCHMARK_ORBIT_HEIGHT = 2.0f;
+constexpr float BENCHMARK_ORBIT_HEIGHT_SWAY = 1.5f;
+constexpr float BENCHMARK_ORBIT_RADIANS_PER_FRAME = 0.01f; // path is stepped per frame so every run renders the same views
+
+struct BenchmarkFrameTimes {
+    float *frameMs = {nullptr};
+    uint32_t count = {0};
+    uint32_t capacity = {0};
+};
+
+struct BenchmarkCpuStats {
+    float minMs = {0.0f};
+    float avgMs = {0.0f};
+    float p50Ms = {0.0f};
+    float p95Ms = {0.0f};
+    float p99Ms = {0.0f};
+    float maxMs = {0.0f};
+};
+//======================================================================================================================
+
+//===INTERNAL_FUNCTIONS=================================================================================================
+static bool benchmark_arg_value(const char *arg, const char *prefix, const char *&outValue) {
+    const size_t prefixLength = strlen(prefix);
+    if (strncmp(arg, prefix, prefixLength) != 0) {
+        return false;
+    }
+    outValue = arg + prefixLength;
+    return true;
+}
+
+static void benchmark_push_frame(BenchmarkFrameTimes &frameTimes, const float frameMs) {
+    if (frameTimes.count == frameTimes.capacity) {
+        const uint32_t newCapacity = frameTimes.capacity ? frameTimes.capacity * 2 : 1024;
+        float *newFrameMs = (float *) mem_malloc(sizeof(float) * newCapacity, MSG_RUNTIME);
+        if (frameTimes.frameMs) {
+            memcpy(newFrameMs, frameTimes.frameMs, sizeof(float) * frameTimes.count);
+            mem_free(frameTimes.frameMs);
+        }
+        frameTimes.frameMs = newFrameMs;
+        frameTimes.capacity = newCapacity;
+    }
+    frameTimes.frameMs[frameTimes.count++] = frameMs;
+}
+
+// nearest rank percentile, sortedFrameMs must be in ascending order.
+static float benchmark_percentile(const float *sortedFrameMs, const uint32_t count, const float percentile) {
+    const uint32_t rank = (uint32_t) ((percentile / 100.0f) * (float) count + 0.999f);
+    const uint32_t index = rank == 0 ? 0 : rank - 1;
+    return sortedFrameMs[index < count ? index : count - 1];
+}
+
+static BenchmarkCpuStats benchmark_cpu_stats(BenchmarkFrameTimes &frameTimes) {
+    BenchmarkCpuStats stats = {};
+    const uint32_t count = frameTimes.count;
+    if (count == 0) {
+        return stats;
+    }
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += frameTimes.frameMs[i];
+    }
+    std::sort(frameTimes.frameMs, frameTimes.frameMs + count);
+    stats.minMs = frameTimes.frameMs[0];
+    stats.maxMs = frameTimes.frameMs[count - 1];
+    stats.avgMs = (float) (sum / (double) count);
+    stats.p50Ms = benchmark_percentile(frameTimes.frameMs, count, 50.0f);
+    stats.p95Ms = benchmark_percentile(frameTimes.frameMs, count, 95.0f);
+    stats.p99Ms = benchmark_percentile(frameTimes.frameMs, count, 99.0f);
+    return stats;
+}
+
+static void benchmark_update_camera(const uint32_t frame) {
+    const CameraEntity *camEntity = db_get_camera_entity(0);
+    Transform *transform = db_get_transform(camEntity->transformIndex);
+
+    const float angle = (float) frame * BENCHMARK_ORBIT_RADIANS_PER_FRAME;
+    const vec3f position = {
+            sinf(angle) * BENCHMARK_ORBIT_RADIUS,
+            BENCHMARK_ORBIT_HEIGHT + sinf(angle * 3.0f) * BENCHMARK_ORBIT_HEIGHT_SWAY,
+            cosf(angle) * BENCHMARK_ORBIT_RADIUS,
+    };
+    // look back at the origin, camera forward is -z with rotation stored as euler pitch (x) and yaw (y).
+    const vec3f direction = -position / sqrtf(position.x * position.x + position.y * position.y + position.z * position.z);
+    transform->position = position;
+    transform->rotation = {asinf(direction.y), atan2f(-direction.x, -direction.z), 0.0f};
+}
+
+// writes value as a quoted json string, driver provided names may contain quotes, backslashes or control characters.
+static void benchmark_write_json_string(FILE *file, const char *value) {
+    fputc('"', file);
+    for (const char *c = value; *c != '\0'; ++c) {
+        const unsigned char ch = (unsigned char) *c;
+        if (ch == '"' || ch == '\\') {
+            fputc('\\', file);
+            fputc(ch, file);
+        } else if (ch < 0x20) {
+            fprintf(file, "\\u%04x", ch);
+        } else {
+            fputc(ch, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static bool benchmark_write_json(const BenchmarkConfig &config, const BenchmarkCpuStats &cpuStats, const uint32_t frameCount,
+                                 const double elapsedSeconds, const uint64_t drawCallTotal) {
+    FILE *file = fopen(config.outputPath, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "{\n");
+    fprintf(file, "  \"config\": {\"frames\": %u, \"warmupFrames\": %u, \"width\": %d, \"height\": %d},\n",
+            frameCount, config.warmupFrames, config.resolution.x, config.resolution.y);
+    fprintf(file, "  \"device\": ");
+    benchmark_write_json_string(file, gfx_device_name());
+    fprintf(file, ",\n");
+    fprintf(file, "  \"elapsedSeconds\": %.6f,\n", elapsedSeconds);
+    fprintf(file, "  \"cpuFrameMs\": {\"min\": %.4f, \"avg\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+            cpuStats.minMs, cpuStats.avgMs, cpuStats.p50Ms, cpuStats.p95Ms, cpuStats.p99Ms, cpuStats.maxMs);
+
+    // gpu timings only hold the most recent GFX_GPU_TIMING_HISTORY_SIZE frames, so these describe the end of the run.
+    fprintf(file, "  \"gpuPassMs\": {");
+    if (gfx_timestamps_supported()) {
+        for (uint32_t pass = 0; pass < GFX_GPU_PASS_COUNT; ++pass) {
+            const GfxGpuPassTiming &timing = gfx_timestamps_get_pass_timing((GFX_GPU_PASS) pass);
+            fprintf(file, "%s\n    \"%s\": {\"avg\": %.4f, \"max\": %.4f, \"samples\": %u}",
+                    pass == 0 ? "" : ",", gfx_timestamps_pass_name((GFX_GPU_PASS) pass), timing.averageMs, timing.maxMs, timing.sampleCount);
+        }
+        fprintf(file, "\n  },\n");
+    } else {
+        fprintf(file, "},\n");
+    }
+
+    fprintf(file, "  \"drawCalls\": {\"total\": %llu, \"perFrame\": %.2f},\n",
+            (unsigned long long) drawCallTotal, frameCount ? (double) drawCallTotal / (double) frameCount : 0.0);
+
+    fprintf(file, "  \"memory\": {");
+    bool firstTag = true;
+    for (const MSG_CHANNEL tag: LOG_NAMED_CHANNELS) {
+        const MemTagStats stats = mem_get_tag_stats(tag);
+        if (stats.highWatermark == 0 && stats.totalAllocations == 0) {
+            continue;
+        }
+        fprintf(file, "%s\n    \"%s\": {\"currentBytes\": %zu, \"peakBytes\": %zu, \"liveAllocations\": %u, \"totalAllocations\": %llu}",
+                firstTag ? "" : ",", log_channel_name_lookup(tag), stats.currentBytes, stats.highWatermark, stats.liveAllocations,
+                (unsigned long long) stats.totalAllocations);
+        firstTag = false;
+    }
+    fprintf(file, "\n  },\n");
+
+    const GfxMemoryStats gpuStats = gfx_memory_stats();
+    fprintf(file, "  \"gpuMemory\": {\"blocks\": %u, \"dedicatedBlocks\": %u, \"allocations\": %u, \"reservedBytes\": %llu, \"usedBytes\": %llu},\n",
+            gpuStats.blockCount, gpuStats.dedicatedBlockCount, gpuStats.allocationCount,
+            (unsigned long long) gpuStats.reservedBytes, (unsigned long long) gpuStats.usedBytes);
+    const GfxIndirectStats indirectStats = gfx_indexed_indirect_stats();
+    fprintf(file, "  \"culling\": {\"litEntities\": %u, \"cpuCulledInstances\": %u, \"instances\": %u, \"visibleInstances\": %u, \"commands\": %u, \"redundantBindsAvoided\": %u, \"drawCalls\": %u, \"directInstancing\": %s, \"validatedFrames\": %u, \"validationMismatches\": %u}\n",
+            indirectStats.litEntityCount, indirectStats.cpuCulledInstanceCount,
+            indirectStats.instanceCount, indirectStats.visibleInstanceCount, indirectStats.commandCount, indirectStats.redundantBindsAvoided,
+            indirectStats.drawCallCount, indirectStats.directInstancing ? "true" : "false",
+            indirectStats.validatedFrameCount, indirectStats.validationMismatchCount);
+    fprintf(file, "}\n");
+    fclose(file);
+    return true;
+}
+//======================================================================================================================
+
+//===API================================================================================================================
+BenchmarkConfig benchmark_parse_args(const int32_t argc, char **argv) {
+    BenchmarkConfig config = {};
+    for (int32_t i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = nullptr;
+        if (strcmp(arg, "--benchmark") == 0) {
+            config.enabled = true;
+        } else if (benchmark_arg_value(arg, "--benchmark-frames=", value)) {
+            config.enabled = true;
+            config.frameCount = (uint32_t) strtoul(value, nullptr, 10);
+        } else if (benchmark_arg_value(arg, "--benchmark-seconds=", value)) {
+            config.enabled = true;
+            config.durationSeconds = strtod(value, nullptr);
+        } else if (benchmark_arg_value(arg, "--benchmark-output=", value)) {
+            config.enabled = true;
+            config.outputPath = value;
+        } else if (benchmark_arg_value(arg, "--benchmark-trace=", value)) {
+            config.enabled = true;
+            config.tracePath = value;
+        } else if (strcmp(arg, "--benchmark-trace") == 0 && i + 1 < argc) {
+            config.enabled = true;
+            config.tracePath = argv[++i];
+        } else if (strcmp(arg, "--benchmark-validate-culling") == 0) {
+            config.enabled = true;
+            config.validateCulling = true;
+        } else if (strcmp(arg, "--benchmark-no-cpu-culling") == 0) {
+            config.enabled = true;
+            config.cpuCulling = false;
+        } else if (strcmp(arg, "--benchmark-direct-instancing") == 0) {
+            config.enabled = true;
+            config.directInstancing = true;
+        } else if (benchmark_arg_value(arg, "--benchmark-resolution=", value)) {
+            config.enabled = true;
+            int32_t width = 0;
+            int32_t height = 0;
+            if (sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                config.resolution = {width, height};
+            } else {
+                log_warning(MSG_RUNTIME, "ignoring benchmark resolution %s, expected WxH\n", value);
+            }
+        }
+    }
+    if (config.frameCount == 0 && config.durationSeconds <= 0.0) {
+        config.frameCount = BenchmarkConfig{}.frameCount;
+    }
+    return config;
+}
+
+int32_t benchmark_run(const BenchmarkConfig &config) {
+    time_create();
+    gfx_create_headless(config.resolution);
+    entities_create();
+    gfx_indexed_indirect_set_cpu_culling(config.cpuCulling);
+    gfx_indexed_indirect_set_direct_instancing(config.directInstancing);
+    gfx_indexed_indirect_set_culling_validation(config.validateCulling);
+    log_info(MSG_RUNTIME, "benchmark running headless at %dx%d on %s\n", config.resolution.x, config.resolution.y, gfx_device_name());
+
+    uint32_t pathFrame = 0;
+    for (uint32_t i = 0; i < config.warmupFrames; ++i) {
+        time_tick();
+        benchmark_update_camera(pathFrame++);
+        gfx_update(time_delta());
+    }
+    time_stats_reset();
+
+    BenchmarkFrameTimes frameTimes = {};
+    uint64_t drawCallTotal = 0;
+    const bool timed = config.durationSeconds > 0.0;
+    const int64_t runBeginNs = profiler_now_ns();
+    const int64_t runEndNs = runBeginNs + (int64_t) (config.durationSeconds * 1000000000.0);
+    while (timed ? profiler_now_ns() < runEndNs : frameTimes.count < config.frameCount) {
+        BEET_PROFILE_SCOPE("benchmark_frame");
+        const int64_t frameBeginNs = profiler_now_ns();
+        time_tick();
+        benchmark_update_camera(pathFrame++);
+        gfx_update(time_delta());
+#if BEET_MEMORY_TLSF
+        mem_heap_grow_if_low();
+#endif //BEET_MEMORY_TLSF
+        drawCallTotal += gfx_draw_call_count();
+        benchmark_push_frame(frameTimes, (float) ((double) (profiler_now_ns() - frameBeginNs) / 1000000.0));
+    }
+    const double elapsedSeconds = (double) (profiler_now_ns() - runBeginNs) / 1000000000.0;
+
+    const uint32_t recordedFrames = frameTimes.count;
+    const BenchmarkCpuStats cpuStats = benchmark_cpu_stats(frameTimes);
+    const bool written = benchmark_write_json(config, cpuStats, recordedFrames, elapsedSeconds, drawCallTotal);
+    if (written) {
+        log_info(MSG_RUNTIME, "benchmark: %u frames, avg %.3fms, p99 %.3fms, results written to %s\n",
+                 recordedFrames, cpuStats.avgMs, cpuStats.p99Ms, config.outputPath);
+    } else {
+        log_error(MSG_RUNTIME, "benchmark: failed to write results to %s\n", config.outputPath);
+    }
+    const GfxIndirectStats indirectStats = gfx_indexed_indirect_stats();
+    // direct instancing skips the gpu pass, there is nothing to validate.
+    const bool cullingValid = !config.validateCulling || indirectStats.directInstancing ||
+                              (indirectStats.validatedFrameCount > 0 && indirectStats.validationMismatchCount == 0);
+    if (!cullingValid) {
+        log_error(MSG_RUNTIME, "benchmark: gpu culling disagreed with the cpu reference on %u commands over %u frames\n",
+                  indirectStats.validationMismatchCount, indirectStats.validatedFrameCount);
+    }
+    bool traceWritten = true;
+    if (config.tracePath) {
+#if !BEET_PROFILE
+        log_warning(MSG_RUNTIME, "benchmark: built without BEET_PROFILE, %s will not contain any zones\n", config.tracePath);
+#endif //!BEET_PROFILE
+        traceWritten = profiler_export_chrome_trace(config.tracePath);
+        if (traceWritten) {
+            log_info(MSG_RUNTIME, "benchmark: trace written to %s\n", config.tracePath);
+        } else {
+            log_error(MSG_RUNTIME, "benchmark: failed to write trace to %s\n", config.tracePath);
+        }
+    }
+    if (frameTimes.frameMs) {
+        mem_free(frameTimes.frameMs);
+    }
+
+    entities_cleanup();
+    gfx_cleanup();
+    time_cleanup();
+    db_cleanup_pools();
+    return written && traceWritten && cullingValid ? 0 : 1;
+}
+//======================================================================================================================
@@ -59,7 +59,7 @@ static void lit_entities_create() {
     uint32_t skyboxTextureID = {UINT32_MAX};
     {
         GfxTexture skyboxTexture = {.imageSamplerType = TextureSamplerType::LinearMirror};
-        gfx_texture_create_immediate_dds("assets/textures/sky/herkulessaulen_4k-octahedral.dds", skyboxTexture);
+        gfx_texture_create_streaming_dds("assets/textures/sky/herkulessaulen_4k-octahedral.dds", skyboxTexture);
         skyboxTextureID = db_add_texture(skyboxTexture);
     }
     //============================================================
@@ -67,11 +67,7 @@ static void lit_entities_create() {
     //===MATERIAL=================================================
     uint32_t cubeLitMaterialID = {UINT32_MAX};
     {
-        VkDescriptorSet descriptorSet = {VK_NULL_HANDLE};
-        gfx_lit_update_material_descriptor(descriptorSet, *db_get_texture(uvGridTextureID));
-
         const LitMaterial material = {
-                .descriptorSetIndex = db_add_descriptor_set(descriptorSet),
                 .albedoIndex = uvGridTextureID
         };
 
@@ -135,15 +131,50 @@ static void lit_entities_create() {
 //===INIT_&_SHUTDOWN====================================================================================================
 void entities_cleanup() {
     // if we are shutting down we can ignore all entities created in `primary_camera_entity_create`
-    // but as a follow-up I should add some way to reset / free up various entities in the db
-    // this would mainly be for an editor workflow as I would want a dedicated function to load/unload a package
+    // gfx resources are released and their slots handed back to the db pools so a package unload can reuse them
+
+    // dependents go first, a freed slot is reused by the next add and must not be indexed by anything still alive
+    for (uint32_t i = 0; i < db_get_lit_entity_count(); ++i) {
+        if (!db_valid_lit_entity(i)) {
+            continue;
+        }
+        db_remove_transform(db_get_lit_entity(i)->transformIndex);
+        db_remove_lit_entity(i);
+    }
+    for (uint32_t i = 0; i < db_get_sky_entity_count(); ++i) {
+        if (!db_valid_sky_entity(i)) {
+            continue;
+        }
+        db_remove_sky_entity(i);
+    }
+    for (uint32_t i = 0; i < db_get_lit_material_count(); ++i) {
+        if (!db_valid_lit_material(i)) {
+            continue;
+        }
+        db_remove_lit_material(i);
+    }
+    for (uint32_t i = 0; i < db_get_sky_material_count(); ++i) {
+        if (!db_valid_sky_material(i)) {
+            continue;
+        }
+        db_remove_descriptor_set(db_get_sky_material(i)->descriptorSetIndex);
+        db_remove_sky_material(i);
+    }
 
     // itr gfx data and invalidate content
     for (uint32_t i = 0; i < db_get_mesh_count(); ++i) {
+        if (!db_valid_mesh(i)) {
+            continue;
+        }
         gfx_mesh_cleanup(*db_get_mesh(i));
+        db_remove_mesh(i);
     }
     for (uint32_t i = 0; i < db_get_texture_count(); ++i) {
+        if (!db_valid_texture(i)) {
+            continue;
+        }
         gfx_texture_cleanup(*db_get_texture(i));
+        db_remove_texture(i);
     }
 }
 
@@ -96,6 +96,9 @@ static void widget_pool_selector_lit_entity() {
     sprintf(litEntTitleBuf, "Pool: LitEntity [%u]", litEntityCount);
     if (ImGui::CollapsingHeader(litEntTitleBuf)) {
         for (int32_t poolIndex = 0; poolIndex < litEntityCount; ++poolIndex) {
+            if (!db_valid_lit_entity(poolIndex)) {
+                continue;
+            }
 #if BEET_DEBUG
             sprintf(litEntName, "Name: \"%s\" - %u", BEET_DEBUG ? db_get_lit_entity(poolIndex)->debug_name : "", poolIndex);
 #endif
@@ -114,6 +117,9 @@ static void widget_pool_selector_camera_entity() {
     sprintf(litEntTitleBuf, "Pool: CameraEntity [%u]", camEntityCount);
     if (ImGui::CollapsingHeader(litEntTitleBuf)) {
         for (int32_t poolIndex = 0; poolIndex < camEntityCount; ++poolIndex) {
+            if (!db_valid_camera_entity(poolIndex)) {
+                continue;
+            }
 #if BEET_DEBUG
             sprintf(litEntName, "Name: \"%s\" - %u", BEET_DEBUG ? db_get_camera_entity(poolIndex)->debug_name : "", poolIndex);
 #endif
@@ -151,7 +157,7 @@ static bool widget_draw_transform(Transform &transform) {
 }
 
 static void widget_pool_inspector_lit_entity() {
-    ASSERT(s_selectedPoolItem < db_get_lit_entity_count());
+    ASSERT(db_valid_lit_entity(s_selectedPoolItem));
     const LitEntity &litEntity = *db_get_lit_entity(s_selectedPoolItem);
 
     if (ImGui::CollapsingHeader("Lit Entity Info")) {
@@ -222,7 +228,7 @@ static bool widget_draw_transform(Camera &camera) {
 }
 
 static void widget_pool_inspector_camera_entity() {
-    ASSERT(s_selectedPoolItem < db_get_camera_entity_count());
+    ASSERT(db_valid_camera_entity(s_selectedPoolItem));
     const CameraEntity &camEntity = *db_get_camera_entity(s_selectedPoolItem);
 
     widget_draw_transform(*db_get_transform(camEntity.transformIndex));
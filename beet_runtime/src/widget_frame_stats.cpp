@@ -0,0 +1,36 @@
+#include <runtime/widget_frame_stats.h>
+
+#include <beet_core/time.h>
+
+#include <imgui.h>
+
+//===API================================================================================================================
+void widget_frame_stats_update(bool &enabled) {
+    if (enabled) {
+        ImGui::SetNextWindowSize(ImVec2(420, 300), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Frame Stats", &enabled);
+        {
+            const FrameTimeStats stats = time_frame_stats();
+            ImGui::Text("frames: %u", stats.sampleCount);
+            ImGui::Text("min: %.3f ms  avg: %.3f ms  max: %.3f ms", stats.minMs, stats.avgMs, stats.maxMs);
+            ImGui::Text("p95: %.3f ms  p99: %.3f ms", stats.p95Ms, stats.p99Ms);
+
+            uint32_t historyHead = 0;
+            uint32_t sampleCount = 0;
+            const float *history = time_frame_history(historyHead, sampleCount);
+            ImGui::PlotLines("frame ms", history, (int) sampleCount, (int) historyHead, nullptr, 0.0f, stats.maxMs * 1.1f, ImVec2(0, 80));
+
+            float histogram[TIME_FRAME_HISTOGRAM_BUCKET_COUNT];
+            const uint32_t *counts = time_frame_histogram();
+            for (uint32_t i = 0; i < TIME_FRAME_HISTOGRAM_BUCKET_COUNT; ++i) {
+                histogram[i] = (float) counts[i];
+            }
+            ImGui::PlotHistogram("histogram", histogram, (int) TIME_FRAME_HISTOGRAM_BUCKET_COUNT, 0, "1ms buckets", 0.0f, FLT_MAX, ImVec2(0, 80));
+            if (ImGui::Button("Reset")) {
+                time_stats_reset();
+            }
+        }
+        ImGui::End();
+    }
+}
+//======================================================================================================================
@@ -0,0 +1,44 @@
+#include <runtime/widget_gpu_timings.h>
+
+#include <beet_gfx/gfx_timestamps.h>
+
+#include <imgui.h>
+
+//===API================================================================================================================
+void widget_gpu_timings_update(bool &enabled) {
+    if (enabled) {
+        ImGui::SetNextWindowSize(ImVec2(420, 260), ImGuiCond_FirstUseEver);
+        ImGui::Begin("GPU Timings", &enabled);
+        if (!gfx_timestamps_supported()) {
+            ImGui::TextUnformatted("timestamp queries are not supported by this device");
+            ImGui::End();
+            return;
+        }
+        if (ImGui::BeginTable("gpu_pass_table", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("pass");
+            ImGui::TableSetupColumn("last ms");
+            ImGui::TableSetupColumn("avg ms");
+            ImGui::TableSetupColumn("max ms");
+            ImGui::TableHeadersRow();
+            for (uint32_t i = 0; i < GFX_GPU_PASS_COUNT; ++i) {
+                const GFX_GPU_PASS pass = (GFX_GPU_PASS) i;
+                const GfxGpuPassTiming &timing = gfx_timestamps_get_pass_timing(pass);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(gfx_timestamps_pass_name(pass));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.lastMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.averageMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.maxMs);
+            }
+            ImGui::EndTable();
+        }
+
+        const GfxGpuPassTiming &frameTiming = gfx_timestamps_get_pass_timing(GFX_GPU_PASS_FRAME);
+        ImGui::PlotLines("frame", frameTiming.history, (int) GFX_GPU_TIMING_HISTORY_SIZE, (int) frameTiming.historyHead, nullptr, 0.0f, frameTiming.maxMs * 1.25f, ImVec2(0, 60));
+        ImGui::End();
+    }
+}
+//======================================================================================================================
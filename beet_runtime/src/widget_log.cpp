@@ -0,0 +1,46 @@
+#include <runtime/widget_log.h>
+
+#include <beet_shared/log.h>
+
+#include <imgui.h>
+
+//===API================================================================================================================
+void widget_log_update(bool &enabled) {
+    if (enabled) {
+        ImGui::SetNextWindowSize(ImVec2(220, 340), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Log Filter", &enabled);
+        {
+            int32_t level = (int32_t) log_get_min_level();
+            const char *currentLevelName = log_level_name_lookup((MSG_LEVEL) level);
+            if (ImGui::BeginCombo("Min level", currentLevelName)) {
+                for (int32_t i = 0; i < MSG_LEVEL_COUNT; ++i) {
+                    if (ImGui::Selectable(log_level_name_lookup((MSG_LEVEL) i), i == level)) {
+                        log_set_min_level((MSG_LEVEL) i);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+
+            ImGui::Separator();
+            uint32_t channelMask = log_get_channel_mask();
+            bool maskEdited = false;
+            for (const MSG_CHANNEL channel: LOG_NAMED_CHANNELS) {
+                maskEdited |= ImGui::CheckboxFlags(log_channel_name_lookup(channel), &channelMask, (uint32_t) channel);
+            }
+            if (ImGui::Button("All")) {
+                channelMask = MSG_ALL;
+                maskEdited = true;
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("None")) {
+                channelMask = MSG_NONE;
+                maskEdited = true;
+            }
+            if (maskEdited) {
+                log_set_channel_mask(channelMask);
+            }
+        }
+        ImGui::End();
+    }
+}
+//======================================================================================================================
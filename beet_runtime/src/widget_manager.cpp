@@ -1,8 +1,14 @@
 #include <runtime/widget_manager.h>
 #include <runtime/widget_db.h>
 #include <runtime/widget_hotloader.h>
+#include <runtime/widget_log.h>
+#include <runtime/widget_gpu_timings.h>
+#include <runtime/widget_frame_stats.h>
 #include <runtime/widget_manipulate.h>
 
+#include <beet_shared/log.h>
+#include <beet_shared/profiler.h>
+
 #include <imgui.h>
 
 //===INTERNAL_STRUCTS===================================================================================================
@@ -12,6 +18,9 @@ static struct WidgetState {
     bool DBActive = true;
     bool shaderHotLoader = true;
     bool manipulatorActive = true;
+    bool logFilterActive = false;
+    bool gpuTimingsActive = false;
+    bool frameStatsActive = false;
 } s_widgetState;
 //======================================================================================================================
 
@@ -25,6 +34,15 @@ static void widget_toolbar_update() {
 
         if (ImGui::BeginMenu("Debug Tools")) {
             ImGui::MenuItem("Hot-Reload: Shaders", "", &s_widgetState.shaderHotLoader);
+            ImGui::MenuItem("Log Filter", "", &s_widgetState.logFilterActive);
+            ImGui::MenuItem("GPU Timings", "", &s_widgetState.gpuTimingsActive);
+            ImGui::MenuItem("Frame Stats", "", &s_widgetState.frameStatsActive);
+#if BEET_PROFILE
+            if (ImGui::MenuItem("Export Chrome Trace")) {
+                const bool exported = profiler_export_chrome_trace("beet_trace.json");
+                log_info(MSG_RUNTIME, "chrome trace export to beet_trace.json %s\n", exported ? "succeeded" : "failed");
+            }
+#endif //BEET_PROFILE
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
@@ -46,11 +64,15 @@ static void widget_state_update() {
 
 //===API================================================================================================================
 void widget_manager_update() {
+    BEET_PROFILE_SCOPE("widget_manager_update");
     widget_toolbar_update();
     widget_state_update();
 
     widget_db_update(s_widgetState.DBActive);
     widget_manipulate_update(s_widgetState.manipulatorActive);
     widget_hot_reload_shaders(s_widgetState.shaderHotLoader);
+    widget_log_update(s_widgetState.logFilterActive);
+    widget_gpu_timings_update(s_widgetState.gpuTimingsActive);
+    widget_frame_stats_update(s_widgetState.frameStatsActive);
 }
 //======================================================================================================================
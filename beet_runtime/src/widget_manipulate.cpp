@@ -13,6 +13,7 @@
 #include <beet_shared/beet_types.h>
 #include <beet_shared/shared_utils.h>
 #include <beet_shared/assert.h>
+#include <beet_shared/memory.h>
 
 #include <beet_gfx/gfx_line.h>
 #include <beet_gfx/gfx_interface.h>
@@ -234,7 +235,8 @@ void draw_poly_rect(const BeetRect &rect, uint32_t color) {
     const vec3f right = glm::normalize(glm::cross(rect.normal, rect.up));
     const vec3f up = glm::normalize(glm::cross(right, rect.normal));
 
-    const std::vector<LinePoint3D> corners = {
+    constexpr uint32_t cornerCount = 4;
+    const LinePoint3D corners[cornerCount] = {
             {{rect.center + right * rect.halfExtents.x + up * rect.halfExtents.y}, color},
             {{rect.center - right * rect.halfExtents.x + up * rect.halfExtents.y}, color},
             {{rect.center + right * rect.halfExtents.x - up * rect.halfExtents.y}, color},
@@ -242,7 +244,7 @@ void draw_poly_rect(const BeetRect &rect, uint32_t color) {
     };
 
     for (uint32_t i = 0; i < 4; ++i) {
-        gfx_triangle_strip_add_segment_immediate(corners);
+        gfx_triangle_strip_add_segment_immediate(corners, cornerCount);
     }
 }
 
@@ -270,7 +272,8 @@ void draw_arc(const vec3f &center,
     const float startAngle = 2.0f * glm::pi<float>() * startOffsetPercentClamped;
     const float endAngle = startAngle + 2.0f * glm::pi<float>() * arcPercentClamped;
 
-    std::vector<vec3f> arcPoints(arcSegments + 1);
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    vec3f *arcPoints = (vec3f *) mem_arena_alloc(arenaScope.arena, sizeof(vec3f) * (arcSegments + 1));
     for (uint32_t i = 0; i <= arcSegments; ++i) {
         const float theta = startAngle + (endAngle - startAngle) * float(i) / float(arcSegments);
         const float x = radius * cos(theta);
@@ -302,8 +305,9 @@ void draw_arc_polyline(const vec3f &center,
                        const float lineWidth = 1.0f,
                        const bool closedLoop = false) {
 
-    std::vector<vec2f> points;
-    points.reserve(segments + 1);
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    const uint32_t pointCount = segments + 1;
+    vec2f *points = (vec2f *) mem_arena_alloc(arenaScope.arena, sizeof(vec2f) * pointCount);
 
     const float startAngle = glm::tau<float>() * startOffsetPercent;
     const float endAngle = glm::tau<float>() * arcPercent + startAngle;
@@ -312,14 +316,15 @@ void draw_arc_polyline(const vec3f &center,
         const float angle = startAngle + (endAngle - startAngle) * float(i) / float(segments);
         const float x = center.x + radius * glm::cos(angle);
         const float y = center.y + radius * glm::sin(angle);
-        points.emplace_back(x, y);
+        points[i] = vec2f(x, y);
     }
 
-    std::vector<LinePoint3D> vertices = gfx_generate_geometry_thick_polyline(points, lineWidth, color, closedLoop);
-    for (auto &p: vertices) {
-        p.position = vec3f(modelTransform * vec4f(p.position, 1));
+    uint32_t vertexCount = 0;
+    LinePoint3D *vertices = gfx_generate_geometry_thick_polyline(arenaScope.arena, points, pointCount, lineWidth, color, closedLoop, vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        vertices[i].position = vec3f(modelTransform * vec4f(vertices[i].position, 1));
     }
-    gfx_triangle_strip_add_segment_immediate(vertices);
+    gfx_triangle_strip_add_segment_immediate(vertices, vertexCount);
 }
 
 static bool ray_rect_intersection(const Ray &ray, const BeetRect &rect, Hit &outHit, bool drawDebug = false) {
@@ -572,16 +577,21 @@ static void gizmo_translate_object_1_axis(Transform &transform, const Ray &ray,
 
 
 void draw_cone(const vec3f &baseCenter, const float radius, const float height, const uint32_t color, const mat4 &modelTransform, const uint32_t segments) {
-    std::vector<LinePoint3D> vertices = gfx_generate_geometry_cone(baseCenter, radius, height, color, segments);
-    for (auto &p: vertices) {
-        p.position = vec3f(modelTransform * vec4f(p.position, 1));
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    uint32_t vertexCount = 0;
+    LinePoint3D *vertices = gfx_generate_geometry_cone(arenaScope.arena, baseCenter, radius, height, color, segments, vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        vertices[i].position = vec3f(modelTransform * vec4f(vertices[i].position, 1));
     }
-    gfx_triangle_strip_add_segment_immediate(vertices);
+    gfx_triangle_strip_add_segment_immediate(vertices, vertexCount);
 }
 
 
-std::vector<LinePoint3D> gfx_generate_geometry_cylinder(const glm::vec3 &baseCenter, float radius, float height, uint32_t color, int segments, bool cappedEnds = true) {
-    std::vector<LinePoint3D> vertices;
+LinePoint3D *gfx_generate_geometry_cylinder(MemArena &arena, const glm::vec3 &baseCenter, float radius, float height, uint32_t color, int segments, uint32_t &outPointCount,
+                                            bool cappedEnds = true) {
+    outPointCount = (segments + 1) * 2 * (cappedEnds ? 3 : 1);
+    LinePoint3D *vertices = (LinePoint3D *) mem_arena_alloc(arena, sizeof(LinePoint3D) * outPointCount);
+    uint32_t vertexIndex = 0;
 
     const glm::vec3 topCenter = baseCenter + glm::vec3(0.0f, height, 0.0f);
 
@@ -592,8 +602,8 @@ std::vector<LinePoint3D> gfx_generate_geometry_cylinder(const glm::vec3 &baseCen
             const float z = radius * glm::sin(angle);
 
             glm::vec3 bottomVertex(baseCenter.x + x, baseCenter.y, baseCenter.z + z);
-            vertices.push_back({baseCenter, color});
-            vertices.push_back({bottomVertex, color});
+            vertices[vertexIndex++] = {baseCenter, color};
+            vertices[vertexIndex++] = {bottomVertex, color};
         }
     }
 
@@ -605,8 +615,8 @@ std::vector<LinePoint3D> gfx_generate_geometry_cylinder(const glm::vec3 &baseCen
         glm::vec3 bottomVertex(baseCenter.x + x, baseCenter.y, baseCenter.z + z);
         glm::vec3 topVertex(topCenter.x + x, topCenter.y, topCenter.z + z);
 
-        vertices.push_back({bottomVertex, color});
-        vertices.push_back({topVertex, color});
+        vertices[vertexIndex++] = {bottomVertex, color};
+        vertices[vertexIndex++] = {topVertex, color};
 
     }
 
@@ -618,24 +628,29 @@ std::vector<LinePoint3D> gfx_generate_geometry_cylinder(const glm::vec3 &baseCen
 
             glm::vec3 topVertex(topCenter.x + x, topCenter.y, topCenter.z + z);
 
-            vertices.push_back({topVertex, color});
-            vertices.push_back({topCenter, color});
+            vertices[vertexIndex++] = {topVertex, color};
+            vertices[vertexIndex++] = {topCenter, color};
         }
     }
 
+    ASSERT(vertexIndex == outPointCount);
     return vertices;
 }
 
 void draw_cylinder(const glm::vec3 &baseCenter, float radius, float height, uint32_t color, const mat4 &modelTransform, int segments) {
-    std::vector<LinePoint3D> vertices = gfx_generate_geometry_cylinder(baseCenter, radius, height, color, segments);
-    for (auto &p: vertices) {
-        p.position = vec3f(modelTransform * vec4f(p.position, 1));
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    uint32_t vertexCount = 0;
+    LinePoint3D *vertices = gfx_generate_geometry_cylinder(arenaScope.arena, baseCenter, radius, height, color, segments, vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        vertices[i].position = vec3f(modelTransform * vec4f(vertices[i].position, 1));
     }
-    gfx_triangle_strip_add_segment_immediate(vertices);
+    gfx_triangle_strip_add_segment_immediate(vertices, vertexCount);
 }
 
-std::vector<LinePoint3D> generateSphere(const glm::vec3 &center, float radius, uint32_t color, int segments, int rings) {
-    std::vector<LinePoint3D> vertices;
+LinePoint3D *generateSphere(MemArena &arena, const glm::vec3 &center, float radius, uint32_t color, int segments, int rings, uint32_t &outPointCount) {
+    outPointCount = rings * (segments + 1) * 2;
+    LinePoint3D *vertices = (LinePoint3D *) mem_arena_alloc(arena, sizeof(LinePoint3D) * outPointCount);
+    uint32_t vertexIndex = 0;
 
     for (uint32_t i = 0; i < rings; ++i) {
         const float theta1 = glm::pi<float>() * float(i) / float(rings);
@@ -662,25 +677,29 @@ std::vector<LinePoint3D> generateSphere(const glm::vec3 &center, float radius, u
                     center.z + radius * sinTheta2 * sinPhi
             );
 
-            vertices.push_back({position1, color});
-            vertices.push_back({position2, color});
+            vertices[vertexIndex++] = {position1, color};
+            vertices[vertexIndex++] = {position2, color};
         }
     }
 
+    ASSERT(vertexIndex == outPointCount);
     return vertices;
 }
 
 void draw_sphere(const glm::vec3 &center, float radius, uint32_t color, const mat4 &modelTransform, int segments = 36, int rings = 18) {
-    std::vector<LinePoint3D> vertices = generateSphere(center, radius, color, segments, rings);
+    MemArenaScope arenaScope(*gfx_frame_arena());
+    uint32_t vertexCount = 0;
+    LinePoint3D *vertices = generateSphere(arenaScope.arena, center, radius, color, segments, rings, vertexCount);
 
-    for (auto &p: vertices) {
-        p.position = vec3f(modelTransform * vec4f(p.position, 1));
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        vertices[i].position = vec3f(modelTransform * vec4f(vertices[i].position, 1));
     }
-    gfx_triangle_strip_add_segment_immediate(vertices);
+    gfx_triangle_strip_add_segment_immediate(vertices, vertexCount);
 }
 
-std::vector<LinePoint3D> generate_square(const glm::vec3 &center, float size, uint32_t color) {
-    std::vector<LinePoint3D> vertices;
+constexpr uint32_t SQUARE_POINT_COUNT = 4;
+
+void generate_square(const glm::vec3 &center, float size, uint32_t color, LinePoint3D (&outVertices)[SQUARE_POINT_COUNT]) {
 
     const float halfSize = size / 2.0f;
 
@@ -689,20 +708,19 @@ std::vector<LinePoint3D> generate_square(const glm::vec3 &center, float size, ui
     const vec3f bottomLeft = vec3f(center.x - halfSize, center.y - halfSize, center.z);
     const vec3f bottomRight = vec3f(center.x + halfSize, center.y - halfSize, center.z);
 
-    vertices.push_back({bottomLeft, color});
-    vertices.push_back({topLeft, color});
-    vertices.push_back({bottomRight, color});
-    vertices.push_back({topRight, color});
-
-    return vertices;
+    outVertices[0] = {bottomLeft, color};
+    outVertices[1] = {topLeft, color};
+    outVertices[2] = {bottomRight, color};
+    outVertices[3] = {topRight, color};
 }
 
 void draw_square(const glm::vec3 &center, float size, uint32_t color, const mat4 &modelTransform) {
-    std::vector<LinePoint3D> vertices = generate_square(center, size, color);
+    LinePoint3D vertices[SQUARE_POINT_COUNT] = {};
+    generate_square(center, size, color, vertices);
     for (auto &p: vertices) {
         p.position = vec3f(modelTransform * vec4f(p.position, 1));
     }
-    gfx_triangle_strip_add_segment_immediate(vertices);
+    gfx_triangle_strip_add_segment_immediate(vertices, SQUARE_POINT_COUNT);
 }
 
 bool orientation_dot_test(const glm::vec3 &gizmoPosition, const glm::vec3 &cameraPosition, const vec3f referenceDirection) {
@@ -736,7 +754,7 @@ void set_closest_hovered(const Hit &hitResultForward,
         bool &isHovered;
     };
 
-    std::vector<HitHoverSelection> hoverHitTests = {
+    HitHoverSelection hoverHitTests[] = {
             {hitResultForward,      forwardHovered},
             {hitResultUp,           upHovered},
             {hitResultRight,        rightHovered},